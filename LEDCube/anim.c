@@ -0,0 +1,199 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "anim.h"
+
+#include <string.h>
+#include <limits.h>
+
+/* PLAYER FUNCTIONS */
+/* Number of frames of animation */
+int Anim_Frames(const uint8_t* animation) {
+	return animation[0] | animation[1] << 8;
+}
+
+/* Milliseconds each frame of animation is shown for */
+uint32_t Anim_FrameMillis(const uint8_t* animation) {
+	return animation[2] | animation[3] << 8;
+}
+
+/* Gets ready to play animation from its start into map, which is emptied as the first frame is coded against that */
+/* Every column of map is marked in dirty, as any of them may have been showing something else */
+void Anim_Start(struct Anim_Player* player, const uint8_t* animation, Cube_Column* map, uint64_t* dirty) {
+	player->animation = animation;
+	player->next = animation + ANIM_HEADER_SIZE;
+	player->frame = 0;
+
+	memset(map, 0, CUBE_MAP_SIZE);
+	for (int i = 0; i < CUBE_COLUMNS; i++) {
+		dirty[i / 64] |= 1ULL << i % 64;
+	}
+}
+
+/* Turns map, which must still be showing the frame before, into the next frame, returns false if there are no more */
+/* Every column which changed is marked in dirty, ready for Frame_Encode */
+/* Takes at most CUBE_MAP_SIZE runs and CUBE_MAP_SIZE bytes XORed, see anim.h */
+bool Anim_NextFrame(struct Anim_Player* player, Cube_Column* map, uint64_t* dirty) {
+	uint8_t* bytes = (uint8_t*)map;
+	const uint8_t* run = player->next;
+	const uint8_t* after = NULL;
+	int i = 0;
+
+	if (player->frame >= Anim_Frames(player->animation)) {
+		return false;
+	}
+
+	// Read the runs of an earlier frame which was the same, carrying on after this one
+	if (*run == ANIM_AGAIN) {
+		after = run + ANIM_AGAIN_SIZE;
+		run -= run[1] | run[2] << 8;
+	}
+
+	while (i < CUBE_MAP_SIZE) {
+		uint8_t code = *run++;
+
+		if (code < ANIM_LITERAL) {
+			i += code - ANIM_SKIP + 1;
+			continue;
+		}
+
+		// A run which goes past the end of the map (only possible in a damaged animation) stops there
+		bool repeat = code >= ANIM_REPEAT;
+		int end = i + (code & (ANIM_MAX_LITERAL - 1)) + 1;
+		if (end > CUBE_MAP_SIZE) {
+			end = CUBE_MAP_SIZE;
+		}
+
+		for (; i < end; i++) {
+			bytes[i] ^= *run;
+			run += !repeat;
+			dirty[i / CUBE_COLUMN_BYTES / 64] |= 1ULL << i / CUBE_COLUMN_BYTES % 64;
+		}
+		run += repeat;
+	}
+
+	player->next = after != NULL ? after : run;
+	player->frame++;
+
+	return true;
+}
+
+/* ENCODER FUNCTIONS */
+/* Encodes the animation of maps (frames of them, each shown for millis) into bytes, which must hold */
+/* ANIM_MAX_SIZE(frames), returns its size */
+int Anim_Encode(const Cube_Column (*maps)[CUBE_COLUMNS], int frames, uint32_t millis, uint8_t* bytes) {
+	Cube_Column empty[CUBE_COLUMNS] = {0};
+	int length = ANIM_HEADER_SIZE;
+
+	bytes[0] = frames & 0xFF;
+	bytes[1] = frames >> 8 & 0xFF;
+	bytes[2] = millis & 0xFF;
+	bytes[3] = millis >> 8 & 0xFF;
+
+	for (int frame = 0; frame < frames; frame++) {
+		uint8_t* runs = bytes + length;
+		int size = Anim_EncodeFrame(frame > 0 ? maps[frame - 1] : empty, maps[frame], runs);
+		int same = -1;
+
+		// The latest earlier frame with the same runs, if pointing back at it is any smaller
+		for (int start = ANIM_HEADER_SIZE; start < length && size > ANIM_AGAIN_SIZE; start += Anim_FrameSize(bytes + start)) {
+			if (bytes[start] != ANIM_AGAIN && length - start <= ANIM_MAX_AGAIN && memcmp(bytes + start, runs, size) == 0) {
+				same = start;
+			}
+		}
+
+		if (same >= 0) {
+			runs[0] = ANIM_AGAIN;
+			runs[1] = (length - same) & 0xFF;
+			runs[2] = (length - same) >> 8;
+			size = ANIM_AGAIN_SIZE;
+		}
+
+		length += size;
+	}
+
+	return length;
+}
+
+/* Encodes the frame turning map before into map after into bytes (which must hold ANIM_MAX_FRAME_SIZE), returns its size */
+/* This runs on the PC, so it can afford to find the fewest bytes any choice of runs takes, working back from the end */
+int Anim_EncodeFrame(const Cube_Column* before, const Cube_Column* after, uint8_t* bytes) {
+	const uint8_t* from = (const uint8_t*)before;
+	const uint8_t* to = (const uint8_t*)after;
+	uint8_t change[CUBE_MAP_SIZE];
+	int cost[CUBE_MAP_SIZE + 1]; // Fewest bytes coding the map from each byte on takes
+	uint8_t codes[CUBE_MAP_SIZE]; // First byte of the run starting that coding
+	int length = 0;
+
+	for (int i = 0; i < CUBE_MAP_SIZE; i++) {
+		change[i] = from[i] ^ to[i];
+	}
+
+	// Skips are tried first so that, for the same size, the frame has the fewest bytes to XOR in
+	cost[CUBE_MAP_SIZE] = 0;
+	for (int i = CUBE_MAP_SIZE - 1; i >= 0; i--) {
+		cost[i] = INT_MAX;
+
+		for (int n = 1; n <= ANIM_MAX_SKIP && i + n <= CUBE_MAP_SIZE && change[i + n - 1] == 0; n++) {
+			if (1 + cost[i + n] < cost[i]) {
+				cost[i] = 1 + cost[i + n];
+				codes[i] = ANIM_SKIP + n - 1;
+			}
+		}
+		for (int n = 1; n <= ANIM_MAX_REPEAT && i + n <= CUBE_MAP_SIZE && change[i + n - 1] == change[i]; n++) {
+			if (2 + cost[i + n] < cost[i]) {
+				cost[i] = 2 + cost[i + n];
+				codes[i] = ANIM_REPEAT + n - 1;
+			}
+		}
+		for (int n = 1; n <= ANIM_MAX_LITERAL && i + n <= CUBE_MAP_SIZE; n++) {
+			if (1 + n + cost[i + n] < cost[i]) {
+				cost[i] = 1 + n + cost[i + n];
+				codes[i] = ANIM_LITERAL + n - 1;
+			}
+		}
+	}
+
+	// Write out the runs of the best coding
+	for (int i = 0; i < CUBE_MAP_SIZE;) {
+		uint8_t code = codes[i];
+		bytes[length++] = code;
+
+		if (code < ANIM_LITERAL) {
+			i += code - ANIM_SKIP + 1;
+		} else if (code >= ANIM_REPEAT) {
+			bytes[length++] = change[i];
+			i += code - ANIM_REPEAT + 1;
+		} else {
+			int n = code - ANIM_LITERAL + 1;
+			memcpy(bytes + length, change + i, n);
+			length += n;
+			i += n;
+		}
+	}
+
+	return length;
+}
+
+/* Bytes the frame starting at runs takes in its animation */
+int Anim_FrameSize(const uint8_t* runs) {
+	int length = 0;
+
+	if (runs[0] == ANIM_AGAIN) {
+		return ANIM_AGAIN_SIZE;
+	}
+
+	for (int i = 0; i < CUBE_MAP_SIZE;) {
+		uint8_t code = runs[length++];
+
+		if (code < ANIM_LITERAL) {
+			i += code - ANIM_SKIP + 1;
+		} else if (code >= ANIM_REPEAT) {
+			length++;
+			i += code - ANIM_REPEAT + 1;
+		} else {
+			length += code - ANIM_LITERAL + 1;
+			i += code - ANIM_LITERAL + 1;
+		}
+	}
+
+	return length;
+}
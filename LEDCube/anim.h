@@ -0,0 +1,67 @@
+/* Canned animations kept compressed in flash, and played back a frame at a time straight into a cube map */
+/* An animation is ANIM_HEADER_SIZE bytes (its number of frames and the milliseconds each is shown, 2 byte little
+ * endian words) followed by its frames. A frame is the XOR of its map with the one before (the first with an empty
+ * cube), the bytes of the maps laid out as Cube.map is, coded as runs each starting with a byte of which the top bits
+ * give the kind and the rest the length less one:
+ *   ANIM_SKIP + n     n + 1 bytes the same as in the frame before
+ *   ANIM_LITERAL + n  n + 1 bytes to XOR in, which follow
+ *   ANIM_REPEAT + n   n + 1 bytes to XOR in, all the same one, which follows
+ * The runs of a frame cover exactly CUBE_MAP_SIZE bytes, so frames follow on from each other with nothing between.
+ * A frame which is the same as one earlier in the animation (as when something goes to and fro) is instead
+ * ANIM_AGAIN followed by how many bytes back that frame starts (2 byte little endian), the runs being read from there.
+ * As the animation is in flash this costs no RAM, unlike the window of a general LZ decoder would.
+ * Decoding a frame needs nothing but the map it goes into and a pointer into the animation, and takes at most
+ * CUBE_MAP_SIZE runs and CUBE_MAP_SIZE bytes XORed, however the animation was made
+ *
+ * Animations are made on the PC by animEncode, which writes them out as animations.c */
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cube.h" // Needed for the size of a map
+
+/* DEFINING MACROS */
+#define ANIM_HEADER_SIZE 4
+#define ANIM_SKIP 0x00
+#define ANIM_LITERAL 0x80
+#define ANIM_REPEAT 0xC0
+#define ANIM_AGAIN 0xFF
+#define ANIM_MAX_SKIP 128
+#define ANIM_MAX_LITERAL 64
+#define ANIM_MAX_REPEAT 63 // ANIM_REPEAT + 63 being ANIM_AGAIN
+#define ANIM_AGAIN_SIZE 3
+#define ANIM_MAX_AGAIN 0xFFFF // Furthest back a frame can be found
+/* Size of a frame in which every byte changed, no frame is ever bigger */
+#define ANIM_MAX_FRAME_SIZE (CUBE_MAP_SIZE + (CUBE_MAP_SIZE + ANIM_MAX_LITERAL - 1) / ANIM_MAX_LITERAL)
+/* Bytes an animation of the given number of frames can take */
+#define ANIM_MAX_SIZE(frames) (ANIM_HEADER_SIZE + (frames) * ANIM_MAX_FRAME_SIZE)
+
+/* STRUCTS AND ENUMS */
+/* The animations built into the firmware, in the order animEncode writes them */
+enum Anim_Name {
+	ANIM_IDLE, // Rain falling through the cube
+	ANIM_WIN, // A shell growing out from the middle until every LED is on
+	ANIM_ATTRACT, // A plane sweeping through the cube along each axis in turn, tilting as it goes
+	ANIMATIONS,
+};
+
+/* Where playback of an animation has got to */
+struct Anim_Player {
+	const uint8_t* animation;
+	const uint8_t* next; // First run of the next frame
+	int frame; // Number of frames decoded so far
+};
+
+/* FUNCTION DECLARATIONS */
+int Anim_Frames(const uint8_t* animation);
+uint32_t Anim_FrameMillis(const uint8_t* animation);
+void Anim_Start(struct Anim_Player* player, const uint8_t* animation, Cube_Column* map, uint64_t* dirty);
+bool Anim_NextFrame(struct Anim_Player* player, Cube_Column* map, uint64_t* dirty);
+int Anim_Encode(const Cube_Column (*maps)[CUBE_COLUMNS], int frames, uint32_t millis, uint8_t* bytes);
+int Anim_EncodeFrame(const Cube_Column* before, const Cube_Column* after, uint8_t* bytes);
+int Anim_FrameSize(const uint8_t* runs);
+const uint8_t* Anim_Get(enum Anim_Name name); // In animations.c
+
+#endif
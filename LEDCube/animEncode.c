@@ -0,0 +1,345 @@
+/* Host tool making the animations built into the firmware, see anim.h */
+/* Usage: animEncode [-m MILLIS] [-o FILE] [MAPS...]
+ *        encodes each animation of enum Anim_Name, checks it decodes back to the same maps and reports how well it
+ *        compressed and how long it takes to decode. With -o the animations are written to FILE as C, which is how
+ *        animations.c is made. The animations are made up here unless files of maps are given (CUBE_MAP_SIZE bytes
+ *        each, laid out as Cube.map is), which take the place of the built in ones in order, each frame being shown
+ *        for MILLIS */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "anim.h"
+#include "random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* DEFINING MACROS */
+#define ENCODE_MAX_FRAMES 1024
+#define ENCODE_DECODE_REPEATS 2000 // Times each animation is decoded for timing it
+#define ENCODE_BYTES_PER_LINE 16
+
+/* STRUCTS AND ENUMS */
+/* An animation being made, both as its maps and encoded */
+struct Encode_Animation {
+	const char* name;
+	uint32_t millis;
+	int frames;
+	Cube_Column maps[ENCODE_MAX_FRAMES][CUBE_COLUMNS];
+	uint8_t bytes[ANIM_MAX_SIZE(ENCODE_MAX_FRAMES)];
+	int length;
+	int again; // Frames which point back at an earlier one
+	int mostRuns; // Most runs in a frame
+	int mostChanged; // Most bytes XORed in by a frame
+};
+
+/* FUNCTION DECLARATIONS */
+void Encode_Rain(struct Encode_Animation* animation);
+void Encode_Shell(struct Encode_Animation* animation);
+void Encode_Sweep(struct Encode_Animation* animation);
+bool Encode_Read(struct Encode_Animation* animation, const char* path, uint32_t millis);
+void Encode_Animation(struct Encode_Animation* animation);
+bool Encode_Check(struct Encode_Animation* animation, double* nanosPerFrame);
+void Encode_Write(FILE* file, struct Encode_Animation* animations);
+double Encode_Nanos(void);
+
+/* GLOBAL VARIABLES */
+struct Encode_Animation Encode_animations[ANIMATIONS];
+
+/* ANIMATION FUNCTIONS */
+/* Rain falling through the cube, each drop a few LEDs long, for ANIM_IDLE */
+void Encode_Rain(struct Encode_Animation* animation) {
+	struct Random random;
+	Cube_Column map[CUBE_COLUMNS] = {0};
+
+	Random_Seed(&random, 1);
+	animation->name = "idle";
+	animation->millis = 120;
+	animation->frames = 6 * CUBE_SIZE;
+
+	for (int frame = 0; frame < animation->frames; frame++) {
+		// Every drop falls a layer, and new ones start at the top of a few columns
+		for (int i = 0; i < CUBE_COLUMNS; i++) {
+			Cube_Column top = (Cube_Column)1 << (CUBE_SIZE - 1);
+			bool falling = map[i] & top && (map[i] & top >> 1 || Random_Below(&random, 3) != 0);
+
+			map[i] >>= 1;
+			if (falling || Random_Below(&random, CUBE_COLUMNS) < CUBE_SIZE / 2) {
+				map[i] |= top;
+			}
+		}
+
+		memcpy(animation->maps[frame], map, CUBE_MAP_SIZE);
+	}
+}
+
+/* A ball growing out from the middle of the cube until every LED is on, for ANIM_WIN */
+void Encode_Shell(struct Encode_Animation* animation) {
+	int largest = 3 * (CUBE_SIZE - 1) * (CUBE_SIZE - 1); // Squared distance of a corner from the middle, doubled
+	int growing = 2 * CUBE_SIZE;
+
+	animation->name = "win";
+	animation->millis = 80;
+	animation->frames = growing + CUBE_SIZE / 2;
+
+	for (int frame = 0; frame < animation->frames; frame++) {
+		int radius = frame < growing ? largest * (frame + 1) / growing : largest;
+
+		for (int y = 0; y < CUBE_SIZE; y++) {
+			for (int x = 0; x < CUBE_SIZE; x++) {
+				Cube_Column column = 0;
+
+				for (int z = 0; z < CUBE_SIZE; z++) {
+					int dx = 2 * x - (CUBE_SIZE - 1);
+					int dy = 2 * y - (CUBE_SIZE - 1);
+					int dz = 2 * z - (CUBE_SIZE - 1);
+
+					if (dx * dx + dy * dy + dz * dz <= radius) {
+						column |= (Cube_Column)1 << z;
+					}
+				}
+
+				animation->maps[frame][CUBE_COLUMN_INDEX(x, y)] = column;
+			}
+		}
+	}
+}
+
+/* A plane sweeping to and fro through the cube along x, then y, then z, then tilted across it, for ANIM_ATTRACT */
+void Encode_Sweep(struct Encode_Animation* animation) {
+	int straight = 2 * (CUBE_SIZE - 1); // Frames of a sweep to and fro along an axis
+	int tilted = 2 * 3 * (CUBE_SIZE - 1); // Frames of a sweep to and fro of the plane x + y + z = position
+
+	animation->name = "attract";
+	animation->millis = 60;
+	animation->frames = 3 * straight + tilted;
+
+	for (int frame = 0; frame < animation->frames; frame++) {
+		int axis = frame < 3 * straight ? frame / straight : 3;
+		int position = axis < 3 ? frame % straight : frame - 3 * straight;
+		int length = axis < 3 ? straight : tilted;
+
+		if (position > length / 2) {
+			position = length - position;
+		}
+
+		for (int y = 0; y < CUBE_SIZE; y++) {
+			for (int x = 0; x < CUBE_SIZE; x++) {
+				Cube_Column column = 0;
+
+				for (int z = 0; z < CUBE_SIZE; z++) {
+					int along[4] = { x, y, z, x + y + z };
+
+					if (along[axis] == position) {
+						column |= (Cube_Column)1 << z;
+					}
+				}
+
+				animation->maps[frame][CUBE_COLUMN_INDEX(x, y)] = column;
+			}
+		}
+	}
+}
+
+/* Takes the maps of an animation from the file at path instead, returns false if it has none */
+bool Encode_Read(struct Encode_Animation* animation, const char* path, uint32_t millis) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		perror(path);
+		return false;
+	}
+
+	animation->frames = fread(animation->maps, CUBE_MAP_SIZE, ENCODE_MAX_FRAMES, file);
+	animation->millis = millis;
+	fclose(file);
+
+	if (animation->frames == 0) {
+		fprintf(stderr, "%s: no maps\n", path);
+		return false;
+	}
+
+	return true;
+}
+
+/* ENCODE FUNCTIONS */
+/* Encodes the maps of animation */
+void Encode_Animation(struct Encode_Animation* animation) {
+	animation->length = Anim_Encode((const Cube_Column (*)[CUBE_COLUMNS])animation->maps, animation->frames, animation->millis, animation->bytes);
+}
+
+/* Plays animation back through the decoder of the firmware, checking every frame and marking of dirty columns */
+/* Also counts the runs and bytes XORed of the biggest frame, and times decoding a frame */
+bool Encode_Check(struct Encode_Animation* animation, double* nanosPerFrame) {
+	struct Anim_Player player;
+	Cube_Column map[CUBE_COLUMNS];
+	Cube_Column before[CUBE_COLUMNS];
+	uint64_t dirty[CUBE_DIRTY_WORDS];
+
+	memset(dirty, 0, sizeof(dirty));
+	Anim_Start(&player, animation->bytes, map, dirty);
+	animation->again = 0;
+	animation->mostRuns = 0;
+	animation->mostChanged = 0;
+
+	for (int frame = 0; frame < animation->frames; frame++) {
+		const uint8_t* run = player.next[0] == ANIM_AGAIN ? player.next - (player.next[1] | player.next[2] << 8) : player.next;
+		int runs = 0;
+		int changed = 0;
+
+		animation->again += player.next[0] == ANIM_AGAIN;
+		memcpy(before, map, CUBE_MAP_SIZE);
+		memset(dirty, 0, sizeof(dirty));
+
+		if (!Anim_NextFrame(&player, map, dirty) || memcmp(map, animation->maps[frame], CUBE_MAP_SIZE) != 0) {
+			fprintf(stderr, "%s: frame %d does not decode to its map\n", animation->name, frame);
+			return false;
+		}
+
+		for (int i = 0; i < CUBE_COLUMNS; i++) {
+			if (map[i] != before[i] && !(dirty[i / 64] >> i % 64 & 1)) {
+				fprintf(stderr, "%s: frame %d changes column %d without marking it dirty\n", animation->name, frame, i);
+				return false;
+			}
+		}
+
+		// Walk the runs of the frame again to count them
+		for (int i = 0; i < CUBE_MAP_SIZE; runs++) {
+			uint8_t code = *run++;
+			int n = (code < ANIM_LITERAL ? code : code & (ANIM_MAX_LITERAL - 1)) + 1;
+
+			changed += code >= ANIM_LITERAL ? n : 0;
+			run += code >= ANIM_REPEAT ? 1 : code >= ANIM_LITERAL ? n : 0;
+			i += n;
+		}
+		animation->mostRuns = runs > animation->mostRuns ? runs : animation->mostRuns;
+		animation->mostChanged = changed > animation->mostChanged ? changed : animation->mostChanged;
+	}
+
+	if (Anim_NextFrame(&player, map, dirty) || player.next != animation->bytes + animation->length) {
+		fprintf(stderr, "%s: does not end after its last frame\n", animation->name);
+		return false;
+	}
+
+	double start = Encode_Nanos();
+	for (int repeat = 0; repeat < ENCODE_DECODE_REPEATS; repeat++) {
+		Anim_Start(&player, animation->bytes, map, dirty);
+		while (Anim_NextFrame(&player, map, dirty)) {
+		}
+	}
+	*nanosPerFrame = (Encode_Nanos() - start) / ENCODE_DECODE_REPEATS / animation->frames;
+
+	return true;
+}
+
+/* Writes every animation out as C, the way animations.c is kept */
+void Encode_Write(FILE* file, struct Encode_Animation* animations) {
+	fprintf(file, "/* Animations built into the firmware, see anim.h. Made by animEncode, so make them again rather than edit them */\n");
+	for (int i = 0; i < ANIMATIONS; i++) {
+		fprintf(file, "/* %s: %d frames of %lu ms, %d bytes (%d raw) */\n", animations[i].name, animations[i].frames,
+			(unsigned long)animations[i].millis, animations[i].length, animations[i].frames * CUBE_MAP_SIZE);
+	}
+
+	fprintf(file, "\n/* INCLUDING NECESSARY LIBRARIES */\n#include \"anim.h\"\n\n#include <stddef.h>\n\n");
+	fprintf(file, "/* Only a cube of the size they were made for can play them */\n#if CUBE_SIZE == %d\n", CUBE_SIZE);
+	fprintf(file, "/* GLOBAL VARIABLES */\n");
+
+	for (int i = 0; i < ANIMATIONS; i++) {
+		fprintf(file, "const uint8_t Anim_%s[%d] = {", animations[i].name, animations[i].length);
+		for (int j = 0; j < animations[i].length; j++) {
+			fprintf(file, j % ENCODE_BYTES_PER_LINE == 0 ? "\n\t0x%02X," : " 0x%02X,", animations[i].bytes[j]);
+		}
+		fprintf(file, "\n};\n\n");
+	}
+
+	fprintf(file, "const uint8_t* const Anim_library[ANIMATIONS] = {");
+	for (int i = 0; i < ANIMATIONS; i++) {
+		fprintf(file, " Anim_%s,", animations[i].name);
+	}
+	fprintf(file, " };\n#endif\n\n");
+
+	fprintf(file, "/* LIBRARY FUNCTIONS */\n");
+	fprintf(file, "/* Gets an animation built into the firmware, or NULL if they were made for a cube of another size */\n");
+	fprintf(file, "const uint8_t* Anim_Get(enum Anim_Name name) {\n");
+	fprintf(file, "#if CUBE_SIZE == %d\n\treturn Anim_library[name];\n#else\n\t(void)name;\n\treturn NULL;\n#endif\n}\n", CUBE_SIZE);
+}
+
+/* Nanoseconds on the monotonic clock */
+double Encode_Nanos() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+	const char* outputPath = NULL;
+	uint32_t millis = 100;
+	int option;
+
+	while ((option = getopt(argc, argv, "m:o:")) != -1) {
+		switch (option) {
+			case 'm':
+				millis = strtoul(optarg, NULL, 0);
+				break;
+			case 'o':
+				outputPath = optarg;
+				break;
+			default:
+				optind = argc + 1;
+				break;
+		}
+	}
+
+	if (optind > argc || argc - optind > ANIMATIONS) {
+		fprintf(stderr, "usage: %s [-m MILLIS] [-o FILE] [MAPS...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	Encode_Rain(&Encode_animations[ANIM_IDLE]);
+	Encode_Shell(&Encode_animations[ANIM_WIN]);
+	Encode_Sweep(&Encode_animations[ANIM_ATTRACT]);
+	for (int i = 0; optind + i < argc; i++) {
+		if (!Encode_Read(&Encode_animations[i], argv[optind + i], millis)) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	long rawTotal = 0;
+	long total = 0;
+	printf("%-8s %6s %6s %7s %7s %6s %8s %8s %9s\n", "name", "frames", "again", "raw", "bytes", "ratio", "max runs", "max XOR", "ns/frame");
+
+	for (int i = 0; i < ANIMATIONS; i++) {
+		struct Encode_Animation* animation = &Encode_animations[i];
+		double nanosPerFrame;
+
+		Encode_Animation(animation);
+		if (!Encode_Check(animation, &nanosPerFrame)) {
+			return EXIT_FAILURE;
+		}
+
+		int raw = animation->frames * CUBE_MAP_SIZE;
+		printf("%-8s %6d %6d %7d %7d %5.1fx %8d %8d %9.1f\n", animation->name, animation->frames, animation->again, raw, animation->length,
+			(double)raw / animation->length, animation->mostRuns, animation->mostChanged, nanosPerFrame);
+
+		rawTotal += raw;
+		total += animation->length;
+	}
+	printf("%-8s %6s %6s %7ld %7ld %5.1fx\n", "total", "", "", rawTotal, total, (double)rawTotal / total);
+
+	if (outputPath != NULL) {
+		FILE* file = fopen(outputPath, "w");
+		if (file == NULL) {
+			perror(outputPath);
+			return EXIT_FAILURE;
+		}
+
+		Encode_Write(file, Encode_animations);
+		fclose(file);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/* Animations built into the firmware, see anim.h. Made by animEncode, so make them again rather than edit them */
+/* idle: 48 frames of 120 ms, 1404 bytes (3072 raw) */
+/* win: 20 frames of 80 ms, 481 bytes (1280 raw) */
+/* attract: 84 frames of 60 ms, 1181 bytes (5376 raw) */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "anim.h"
+
+#include <stddef.h>
+
+/* Only a cube of the size they were made for can play them */
+#if CUBE_SIZE == 8
+/* GLOBAL VARIABLES */
+const uint8_t Anim_idle[1404] = {
+	0x30, 0x00, 0x78, 0x00, 0xC0, 0x80, 0x02, 0x82, 0x80, 0x00, 0x80, 0x0E, 0xC0, 0x80, 0x0E, 0xC0,
+	0x80, 0x05, 0xC0, 0x80, 0x11, 0xC0, 0x40, 0x02, 0x82, 0x40, 0x00, 0xC0, 0x0B, 0xC0, 0x80, 0x01,
+	0xC0, 0xC0, 0xC1, 0x80, 0x0C, 0x82, 0x40, 0x00, 0x80, 0x03, 0xC0, 0x40, 0x10, 0xC0, 0x80, 0xC0,
+	0x20, 0x02, 0x82, 0x20, 0x00, 0xE0, 0x0B, 0xC0, 0x40, 0x01, 0xC0, 0x60, 0xC1, 0x40, 0x08, 0xC0,
+	0x80, 0x02, 0x82, 0x20, 0x80, 0xC0, 0x03, 0xC0, 0x20, 0x10, 0xC0, 0x40, 0xC0, 0x10, 0x02, 0x82,
+	0x10, 0x00, 0x70, 0x0B, 0xC0, 0x20, 0x01, 0xC0, 0x30, 0xC1, 0x20, 0x08, 0xC0, 0xC0, 0x02, 0x82,
+	0x10, 0xC0, 0x60, 0x03, 0xC0, 0x10, 0x0B, 0xC0, 0x80, 0x03, 0xC0, 0x20, 0xC0, 0x08, 0x02, 0x82,
+	0x08, 0x00, 0x38, 0x0B, 0xC0, 0x10, 0x01, 0xC0, 0x18, 0xC1, 0x10, 0x04, 0xC0, 0x80, 0x02, 0xC0,
+	0x60, 0x02, 0x82, 0x08, 0x60, 0x30, 0x03, 0xC0, 0x08, 0x0B, 0xC0, 0x40, 0x03, 0xC0, 0x10, 0xC0,
+	0x04, 0x02, 0x83, 0x04, 0x00, 0x1C, 0x80, 0x04, 0xC0, 0x80, 0x04, 0xC0, 0x08, 0x01, 0xC0, 0x0C,
+	0xC1, 0x08, 0x04, 0xC0, 0x40, 0x02, 0xC0, 0x30, 0x02, 0x82, 0x04, 0x30, 0x18, 0x03, 0x84, 0x04,
+	0x00, 0x80, 0x00, 0x80, 0x07, 0xC0, 0x20, 0x03, 0xC0, 0x08, 0xC0, 0x02, 0x02, 0x83, 0x02, 0x80,
+	0x0E, 0xC0, 0x04, 0xC0, 0xC0, 0x04, 0xC0, 0x04, 0x01, 0xC0, 0x06, 0xC1, 0x04, 0x04, 0x81, 0x20,
+	0x80, 0x01, 0xC0, 0x18, 0x02, 0x82, 0x02, 0x18, 0x0C, 0x03, 0x84, 0x02, 0x00, 0x40, 0x00, 0xC0,
+	0x07, 0xC0, 0x10, 0x02, 0x81, 0x80, 0x04, 0x81, 0x01, 0x80, 0x01, 0x83, 0x01, 0x40, 0x07, 0x60,
+	0x04, 0xC0, 0x60, 0x01, 0xC0, 0x80, 0x01, 0xC0, 0x02, 0x01, 0xC0, 0x03, 0xC1, 0x02, 0x04, 0x81,
+	0x10, 0x40, 0x01, 0xC0, 0x0C, 0x01, 0x83, 0x80, 0x01, 0x0C, 0x06, 0x03, 0x84, 0x01, 0x00, 0x20,
+	0x00, 0x60, 0x07, 0xC0, 0x08, 0x02, 0x81, 0xC0, 0x02, 0x00, 0xC0, 0x40, 0x02, 0x82, 0x20, 0x03,
+	0x30, 0x04, 0xC0, 0x30, 0x01, 0xC0, 0x40, 0x01, 0xC0, 0x01, 0x01, 0xC2, 0x01, 0x04, 0x81, 0x08,
+	0x20, 0x01, 0xC0, 0x06, 0x01, 0x84, 0x40, 0x00, 0x06, 0x03, 0x80, 0x04, 0x83, 0x10, 0x00, 0x30,
+	0x80, 0x01, 0xC0, 0x80, 0x03, 0xC0, 0x04, 0x02, 0x81, 0x60, 0x01, 0x00, 0x86, 0x20, 0x00, 0x80,
+	0x00, 0x10, 0x01, 0x18, 0x04, 0x83, 0x18, 0x00, 0x80, 0x20, 0x0C, 0x81, 0x04, 0x10, 0x01, 0xC0,
+	0x03, 0x01, 0x85, 0x20, 0x00, 0x03, 0x01, 0x40, 0x80, 0x03, 0x83, 0x08, 0x00, 0x18, 0x40, 0x01,
+	0xC0, 0xC0, 0x03, 0xC0, 0x02, 0x02, 0xC0, 0x30, 0x00, 0x00, 0x86, 0x10, 0x00, 0x40, 0x00, 0x08,
+	0x00, 0x0C, 0x04, 0x83, 0x0C, 0x00, 0x40, 0x10, 0x03, 0xC0, 0x80, 0x07, 0x81, 0x02, 0x08, 0x01,
+	0xC0, 0x01, 0x01, 0x85, 0x10, 0x00, 0x01, 0x00, 0x20, 0x40, 0x03, 0x83, 0x04, 0x00, 0x0C, 0x20,
+	0x01, 0xC0, 0x60, 0x01, 0x82, 0x80, 0x00, 0x01, 0x02, 0xC0, 0x18, 0x00, 0x00, 0x86, 0x08, 0x00,
+	0x20, 0x00, 0x04, 0x00, 0x06, 0x02, 0x85, 0x80, 0x00, 0x06, 0x00, 0x20, 0x08, 0x03, 0xC0, 0x40,
+	0x07, 0x81, 0x01, 0x04, 0x04, 0xC0, 0x08, 0x02, 0x81, 0x10, 0x20, 0x03, 0x83, 0x02, 0x00, 0x06,
+	0x10, 0x01, 0xC0, 0x30, 0x01, 0xC0, 0x40, 0x04, 0xC0, 0x0C, 0x00, 0x00, 0x86, 0x04, 0x00, 0x10,
+	0x00, 0x02, 0x00, 0x03, 0x02, 0x85, 0x40, 0x00, 0x03, 0x00, 0x10, 0x04, 0x03, 0xC0, 0x20, 0x08,
+	0x82, 0x02, 0x00, 0x80, 0x02, 0x85, 0x04, 0x00, 0x80, 0x00, 0x08, 0x10, 0x03, 0x83, 0x01, 0x00,
+	0x03, 0x08, 0x01, 0xC0, 0x18, 0x01, 0xC0, 0x20, 0x04, 0xC0, 0x06, 0x00, 0x00, 0x86, 0x02, 0x00,
+	0x08, 0x00, 0x01, 0x00, 0x01, 0x02, 0x85, 0x20, 0x80, 0x01, 0x00, 0x08, 0x02, 0x03, 0xC0, 0x10,
+	0x03, 0xC0, 0x80, 0x03, 0x82, 0x01, 0x00, 0x40, 0x01, 0x86, 0x80, 0x02, 0x00, 0x40, 0x00, 0x04,
+	0x08, 0x05, 0x81, 0x01, 0x04, 0x01, 0xC0, 0x0C, 0x01, 0xC0, 0x10, 0x04, 0xC0, 0x03, 0x00, 0x00,
+	0x82, 0x01, 0x00, 0x04, 0x05, 0x82, 0x80, 0x10, 0x40, 0x01, 0x83, 0x04, 0x01, 0x00, 0x80, 0x01,
+	0xC0, 0x08, 0x03, 0xC0, 0x40, 0x05, 0xC0, 0x20, 0x01, 0x86, 0x40, 0x01, 0x00, 0x20, 0x00, 0x02,
+	0x04, 0x06, 0x83, 0x02, 0x00, 0x80, 0x06, 0x01, 0xC0, 0x08, 0x01, 0xC0, 0x80, 0x01, 0xC0, 0x01,
+	0x00, 0x02, 0xC0, 0x02, 0x04, 0x83, 0x80, 0x40, 0x08, 0x20, 0x01, 0xC0, 0x02, 0x01, 0x83, 0x40,
+	0x00, 0x80, 0x04, 0x03, 0xC0, 0x20, 0x05, 0xC0, 0x10, 0x01, 0xC0, 0x20, 0x01, 0x83, 0x10, 0x00,
+	0x01, 0x02, 0x06, 0x83, 0x01, 0x00, 0x40, 0x03, 0x01, 0xC0, 0x04, 0x01, 0xC0, 0x40, 0x03, 0x02,
+	0xC0, 0x01, 0x04, 0x83, 0x40, 0x20, 0x04, 0x10, 0x01, 0xC0, 0x01, 0x01, 0x83, 0x20, 0x00, 0x40,
+	0x02, 0x03, 0xC0, 0x10, 0x05, 0xC0, 0x08, 0x01, 0xC0, 0x10, 0x01, 0x83, 0x08, 0x80, 0x00, 0x01,
+	0x08, 0x81, 0x20, 0x01, 0x01, 0xC0, 0x02, 0x01, 0xC0, 0x20, 0x03, 0x08, 0x83, 0x20, 0x10, 0x02,
+	0x08, 0x04, 0x83, 0x10, 0x00, 0x20, 0x01, 0x03, 0xC0, 0x08, 0x05, 0xC0, 0x04, 0x01, 0xC0, 0x08,
+	0x01, 0x81, 0x04, 0xC0, 0x0A, 0xC0, 0x10, 0x02, 0xC0, 0x01, 0x01, 0x82, 0x10, 0x00, 0x80, 0x01,
+	0x08, 0x83, 0x10, 0x08, 0x01, 0x04, 0x04, 0x82, 0x08, 0x00, 0x10, 0x04, 0xC0, 0x04, 0x05, 0xC0,
+	0x02, 0x01, 0xC0, 0x04, 0x01, 0x81, 0x02, 0x60, 0x0A, 0xC0, 0x08, 0x05, 0x82, 0x08, 0x00, 0xC0,
+	0x01, 0x08, 0x83, 0x08, 0x04, 0x00, 0x02, 0x04, 0x82, 0x04, 0x00, 0x08, 0x04, 0xC0, 0x02, 0x05,
+	0xC0, 0x01, 0x01, 0xC0, 0x02, 0x01, 0x81, 0x01, 0xB0, 0x0A, 0xC0, 0x04, 0x05, 0x83, 0x04, 0x00,
+	0x60, 0x80, 0x00, 0x08, 0x85, 0x04, 0x02, 0x00, 0x01, 0x00, 0x80, 0x02, 0x82, 0x02, 0x00, 0x04,
+	0x04, 0xC0, 0x01, 0x04, 0xC0, 0x80, 0x02, 0xC0, 0x01, 0x02, 0xC0, 0x58, 0x0A, 0xC0, 0x02, 0x03,
+	0x85, 0x80, 0x00, 0x02, 0x00, 0x30, 0xC0, 0x00, 0x08, 0x81, 0x02, 0x01, 0x02, 0xC0, 0x40, 0x02,
+	0x82, 0x01, 0x00, 0x02, 0x0A, 0xC0, 0xC0, 0x06, 0xC0, 0x2C, 0x0A, 0x82, 0x01, 0x00, 0x80, 0x01,
+	0x85, 0x40, 0x00, 0x01, 0x00, 0x18, 0x60, 0x00, 0x08, 0xC0, 0x01, 0x02, 0x81, 0x80, 0x20, 0x01,
+	0xC0, 0x80, 0x01, 0xC0, 0x01, 0x05, 0xC0, 0x80, 0x03, 0xC0, 0x60, 0x06, 0xC0, 0x16, 0x0C, 0x83,
+	0xC0, 0x80, 0x00, 0x20, 0x02, 0x81, 0x0C, 0x30, 0x00, 0x0C, 0x81, 0x40, 0x10, 0x01, 0xC0, 0x40,
+	0x08, 0xC0, 0xC0, 0x03, 0x82, 0x30, 0x00, 0x80, 0x04, 0xC0, 0x0B, 0x0C, 0x83, 0x60, 0x40, 0x00,
+	0x10, 0x02, 0x81, 0x06, 0x18, 0x00, 0x0C, 0x81, 0x20, 0x08, 0x01, 0xC0, 0x20, 0x08, 0xC0, 0x60,
+	0x03, 0x82, 0x18, 0x00, 0x40, 0x04, 0xC0, 0x05, 0x06, 0xC0, 0x80, 0x04, 0x83, 0x30, 0x20, 0x00,
+	0x08, 0x02, 0x81, 0x03, 0x0C, 0x00, 0x0C, 0x81, 0x10, 0x04, 0x01, 0xC0, 0x10, 0x06, 0x82, 0x80,
+	0x00, 0x30, 0x03, 0x82, 0x0C, 0x00, 0x20, 0x04, 0xC0, 0x02, 0x06, 0xC0, 0x40, 0x04, 0x83, 0x18,
+	0x10, 0x00, 0x04, 0x02, 0x81, 0x01, 0x06, 0x00, 0x0C, 0x81, 0x08, 0x02, 0x01, 0xC0, 0x08, 0x06,
+	0x82, 0x40, 0x00, 0x18, 0x03, 0x82, 0x06, 0x00, 0x10, 0x04, 0xC0, 0x01, 0x06, 0xC0, 0x20, 0x04,
+	0x83, 0x0C, 0x08, 0x00, 0x02, 0x03, 0xC0, 0x03, 0x00, 0x0C, 0x81, 0x04, 0x01, 0x01, 0xC0, 0x04,
+	0x03, 0xC0, 0x80, 0x01, 0x82, 0x20, 0x00, 0x0C, 0x03, 0x82, 0x03, 0x00, 0x08, 0x0C, 0xC0, 0x10,
+	0x01, 0xC0, 0x80, 0x01, 0x83, 0x06, 0x04, 0x00, 0x01, 0x03, 0xC0, 0x01, 0x00, 0x0C, 0xC0, 0x02,
+	0x02, 0xC0, 0x02, 0x03, 0xC0, 0x40, 0x01, 0x82, 0x10, 0x00, 0x06, 0x03, 0x82, 0x01, 0x00, 0x04,
+	0x0C, 0xC0, 0x08, 0x01, 0xC0, 0x40, 0x01, 0x81, 0x03, 0x02, 0x07, 0x0C, 0xC0, 0x01, 0x02, 0xC0,
+	0x01, 0x03, 0xC0, 0x20, 0x01, 0x82, 0x08, 0x00, 0x03, 0x05, 0x81, 0x02, 0x80, 0x0B, 0x83, 0x04,
+	0x80, 0x00, 0x20, 0x01, 0xC1, 0x01, 0x07, 0x15, 0xC0, 0x10, 0x01, 0x82, 0x04, 0x00, 0x01, 0x05,
+	0x81, 0x01, 0x40, 0x0B, 0x83, 0x02, 0x40, 0x00, 0x10, 0x0B, 0x15, 0xC0, 0x08, 0x01, 0x84, 0x02,
+	0x00, 0x80, 0x00, 0x80, 0x04, 0xC0, 0x20, 0x0B, 0x83, 0x01, 0x20, 0x00, 0x08, 0x0B, 0x15, 0xC0,
+	0x04, 0x01, 0x84, 0x01, 0x00, 0xC0, 0x00, 0xC0, 0x04, 0xC0, 0x10, 0x0C, 0x82, 0x10, 0x00, 0x04,
+	0x0B, 0x15, 0xC0, 0x02, 0x03, 0x82, 0x60, 0x80, 0xE0, 0x04, 0xC0, 0x08, 0x0C, 0x82, 0x08, 0x00,
+	0x02, 0x0B, 0x15, 0xC0, 0x01, 0x03, 0x82, 0x30, 0xC0, 0x70, 0x04, 0xC0, 0x04, 0x0C, 0x82, 0x04,
+	0x00, 0x01, 0x09, 0xC0, 0x80, 0x00, 0x1A, 0x82, 0x18, 0x60, 0x38, 0x04, 0xC0, 0x02, 0x0C, 0xC0,
+	0x02, 0x0B, 0xC0, 0x40, 0x00, 0x1A, 0x82, 0x0C, 0x30, 0x1C, 0x04, 0xC0, 0x01, 0x0C, 0xC0, 0x01,
+	0x0B, 0xC0, 0x20, 0x00, 0x1A, 0x82, 0x06, 0x18, 0x0E, 0x17, 0xC0, 0x80, 0x06, 0xC0, 0x10, 0x00,
+	0x1A, 0x82, 0x03, 0x0C, 0x07, 0x0F, 0xC0, 0x80, 0x06, 0xC0, 0x40, 0x06, 0xC0, 0x08, 0x00, 0x1A,
+	0x82, 0x01, 0x06, 0x03, 0x0F, 0xC0, 0xC0, 0x06, 0xC0, 0x20, 0x06, 0xC0, 0x04, 0x00, 0x1B, 0x81,
+	0x03, 0x01, 0x0F, 0xC0, 0x60, 0x06, 0xC0, 0x10, 0x06, 0xC0, 0x02, 0x00, 0x07, 0xC0, 0x80, 0x12,
+	0xC0, 0x01, 0x10, 0xC0, 0x30, 0x05, 0x81, 0x80, 0x08, 0x06, 0xC0, 0x01, 0x00, 0x07, 0xC0, 0xC0,
+	0x24, 0xC0, 0x18, 0x05, 0x81, 0x40, 0x04, 0x08, 0x07, 0xC0, 0x60, 0x24, 0xC0, 0x0C, 0x05, 0x81,
+	0x20, 0x02, 0x08, 0x07, 0xC0, 0x30, 0x24, 0xC0, 0x86, 0x05, 0x81, 0x10, 0x01, 0x08, 0x07, 0xC0,
+	0x18, 0x24, 0xC0, 0x43, 0x05, 0xC0, 0x08, 0x09, 0x07, 0xC0, 0x0C, 0x24, 0xC0, 0x21, 0x05, 0xC0,
+	0x04, 0x09, 0x07, 0xC0, 0x06, 0x24, 0xC0, 0x10, 0x05, 0xC0, 0x02, 0x09,
+};
+
+const uint8_t Anim_win[481] = {
+	0x14, 0x00, 0x50, 0x00, 0x1A, 0xC1, 0x18, 0x05, 0xC1, 0x18, 0x1A, 0x12, 0xC1, 0x18, 0x04, 0x83,
+	0x18, 0x24, 0x24, 0x18, 0x03, 0x83, 0x18, 0x24, 0x24, 0x18, 0x04, 0xC1, 0x18, 0x12, 0x0A, 0xC1,
+	0x18, 0x04, 0x83, 0x3C, 0x24, 0x24, 0x3C, 0x02, 0x85, 0x18, 0x24, 0x42, 0x42, 0x24, 0x18, 0x01,
+	0x85, 0x18, 0x24, 0x42, 0x42, 0x24, 0x18, 0x02, 0x83, 0x3C, 0x24, 0x24, 0x3C, 0x04, 0xC1, 0x18,
+	0x0A, 0x09, 0x83, 0x18, 0x24, 0x24, 0x18, 0x02, 0x85, 0x18, 0x00, 0x42, 0x42, 0x00, 0x18, 0x01,
+	0x81, 0x24, 0x42, 0x01, 0x81, 0x42, 0x24, 0x01, 0x81, 0x24, 0x42, 0x01, 0x81, 0x42, 0x24, 0x01,
+	0x85, 0x18, 0x00, 0x42, 0x42, 0x00, 0x18, 0x02, 0x83, 0x18, 0x24, 0x24, 0x18, 0x09, 0x09, 0xC0,
+	0x24, 0x01, 0xC0, 0x24, 0x02, 0x81, 0x24, 0x42, 0x01, 0x81, 0x42, 0x24, 0x11, 0x81, 0x24, 0x42,
+	0x01, 0x81, 0x42, 0x24, 0x02, 0xC0, 0x24, 0x01, 0xC0, 0x24, 0x09, 0x02, 0xC1, 0x18, 0x03, 0x85,
+	0x18, 0x00, 0x42, 0x42, 0x00, 0x18, 0x08, 0x8F, 0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18,
+	0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18, 0x08, 0x85, 0x18, 0x00, 0x42, 0x42, 0x00, 0x18,
+	0x03, 0xC1, 0x18, 0x02, 0x01, 0x83, 0x18, 0x24, 0x24, 0x18, 0x02, 0x81, 0x24, 0x42, 0x01, 0x8D,
+	0x42, 0x24, 0x00, 0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18, 0x24, 0x00, 0x81, 0x01, 0x85,
+	0x81, 0x00, 0x24, 0x24, 0x00, 0x81, 0x01, 0x8D, 0x81, 0x00, 0x24, 0x18, 0x42, 0x00, 0x81, 0x81,
+	0x00, 0x42, 0x18, 0x00, 0x24, 0x42, 0x01, 0x81, 0x42, 0x24, 0x02, 0x83, 0x18, 0x24, 0x24, 0x18,
+	0x01, 0x01, 0xC0, 0x24, 0x01, 0xC0, 0x24, 0x09, 0x82, 0x24, 0x00, 0x81, 0x01, 0x82, 0x81, 0x00,
+	0x24, 0x0F, 0x82, 0x24, 0x00, 0x81, 0x01, 0x82, 0x81, 0x00, 0x24, 0x09, 0xC0, 0x24, 0x01, 0xC0,
+	0x24, 0x01, 0x00, 0x8E, 0x18, 0x00, 0x42, 0x42, 0x00, 0x18, 0x00, 0x18, 0x42, 0x00, 0x81, 0x81,
+	0x00, 0x42, 0x18, 0x07, 0x81, 0x42, 0x81, 0x03, 0x83, 0x81, 0x42, 0x42, 0x81, 0x03, 0x81, 0x81,
+	0x42, 0x07, 0x8E, 0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18, 0x00, 0x18, 0x00, 0x42, 0x42,
+	0x00, 0x18, 0x00, 0x00, 0x81, 0x24, 0x42, 0x01, 0x85, 0x42, 0x24, 0x00, 0x24, 0x00, 0x81, 0x01,
+	0x84, 0x81, 0x00, 0x24, 0x42, 0x81, 0x03, 0x81, 0x81, 0x42, 0x0F, 0x81, 0x42, 0x81, 0x03, 0x84,
+	0x81, 0x42, 0x24, 0x00, 0x81, 0x01, 0x85, 0x81, 0x00, 0x24, 0x00, 0x24, 0x42, 0x01, 0x81, 0x42,
+	0x24, 0x00, 0x89, 0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18, 0x42, 0x81, 0x03, 0x81, 0x81,
+	0x42, 0x07, 0xC0, 0x81, 0x05, 0xC1, 0x81, 0x05, 0xC0, 0x81, 0x07, 0x81, 0x42, 0x81, 0x03, 0x89,
+	0x81, 0x42, 0x18, 0x42, 0x00, 0x81, 0x81, 0x00, 0x42, 0x18, 0x82, 0x24, 0x00, 0x81, 0x01, 0x82,
+	0x81, 0x00, 0x24, 0x07, 0xC0, 0x81, 0x05, 0xC0, 0x81, 0x0F, 0xC0, 0x81, 0x05, 0xC0, 0x81, 0x07,
+	0x82, 0x24, 0x00, 0x81, 0x01, 0x82, 0x81, 0x00, 0x24, 0x3F, 0x81, 0x42, 0x81, 0x03, 0x82, 0x81,
+	0x42, 0x81, 0x05, 0xC0, 0x81, 0x1F, 0xC0, 0x81, 0x05, 0x82, 0x81, 0x42, 0x81, 0x03, 0x81, 0x81,
+	0x42, 0x3F, 0xC0, 0x81, 0x05, 0xC0, 0x81, 0x2F, 0xC0, 0x81, 0x05, 0xC0, 0x81, 0x3F, 0x3F, 0x3F,
+	0x3F,
+};
+
+const uint8_t Anim_attract[1181] = {
+	0x54, 0x00, 0x3C, 0x00, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06,
+	0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC1, 0xFF, 0x05, 0xC1,
+	0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF,
+	0x05, 0xC1, 0xFF, 0x05, 0x00, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF,
+	0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x04, 0x01, 0xC1, 0xFF,
+	0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05,
+	0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x03, 0x02, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05,
+	0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x02, 0x03,
+	0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1,
+	0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x01, 0x04, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1,
+	0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF,
+	0x00, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF,
+	0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0x05, 0xC1, 0xFF, 0xFF, 0x18, 0x00, 0xFF, 0x34, 0x00, 0xFF,
+	0x50, 0x00, 0xFF, 0x6C, 0x00, 0xFF, 0x88, 0x00, 0xFF, 0xA4, 0x00, 0xC0, 0xFF, 0x00, 0xC5, 0xFF,
+	0x00, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x06,
+	0xC0, 0xFF, 0x06, 0xC0, 0xFF, 0x05, 0xCF, 0xFF, 0x2F, 0x07, 0xCF, 0xFF, 0x27, 0x0F, 0xCF, 0xFF,
+	0x1F, 0x17, 0xCF, 0xFF, 0x17, 0x1F, 0xCF, 0xFF, 0x0F, 0x27, 0xCF, 0xFF, 0x07, 0x2F, 0xCF, 0xFF,
+	0x2F, 0xCF, 0xFF, 0xFF, 0x0A, 0x00, 0xFF, 0x11, 0x00, 0xFF, 0x18, 0x00, 0xFF, 0x1F, 0x00, 0xFF,
+	0x26, 0x00, 0xC7, 0x01, 0xC7, 0xFE, 0xEF, 0x01, 0xC0, 0x03, 0xFE, 0x03, 0xC0, 0x06, 0xFE, 0x06,
+	0xC0, 0x0C, 0xFE, 0x0C, 0xC0, 0x18, 0xFE, 0x18, 0xC0, 0x30, 0xFE, 0x30, 0xC0, 0x60, 0xFE, 0x60,
+	0xC0, 0xC0, 0xFE, 0xC0, 0xFF, 0x04, 0x00, 0xFF, 0x0B, 0x00, 0xFF, 0x12, 0x00, 0xFF, 0x19, 0x00,
+	0xFF, 0x20, 0x00, 0xFF, 0x27, 0x00, 0xC0, 0x03, 0xFE, 0x02, 0x81, 0x03, 0x01, 0x05, 0xC0, 0x01,
+	0x36, 0x82, 0x06, 0x03, 0x01, 0x04, 0x81, 0x03, 0x01, 0x05, 0xC0, 0x01, 0x2E, 0x83, 0x0C, 0x06,
+	0x03, 0x01, 0x03, 0x82, 0x06, 0x03, 0x01, 0x04, 0x81, 0x03, 0x01, 0x05, 0xC0, 0x01, 0x26, 0x84,
+	0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x82, 0x06, 0x03, 0x01,
+	0x04, 0x81, 0x03, 0x01, 0x05, 0xC0, 0x01, 0x1E, 0x85, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x01,
+	0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x82, 0x06, 0x03,
+	0x01, 0x04, 0x81, 0x03, 0x01, 0x05, 0xC0, 0x01, 0x16, 0x8D, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03,
+	0x01, 0x00, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02,
+	0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x82, 0x06, 0x03, 0x01, 0x04, 0x81, 0x03, 0x01, 0x05, 0xC0,
+	0x01, 0x0E, 0x95, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06,
+	0x03, 0x01, 0x00, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01,
+	0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x82, 0x06, 0x03, 0x01, 0x04, 0x81, 0x03, 0x01, 0x05,
+	0xC0, 0x01, 0x06, 0x9D, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0xC0, 0x60, 0x30, 0x18,
+	0x0C, 0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00, 0x30, 0x18, 0x0C, 0x06,
+	0x03, 0x01, 0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03,
+	0x82, 0x06, 0x03, 0x01, 0x04, 0x81, 0x03, 0x01, 0x05, 0x00, 0xA4, 0x80, 0xC0, 0x60, 0x30, 0x18,
+	0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06,
+	0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01,
+	0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x82, 0x06,
+	0x03, 0x01, 0x04, 0x01, 0xAB, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x00, 0x80, 0xC0, 0x60, 0x30,
+	0x18, 0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0xC0, 0x60, 0x30, 0x18, 0x0C,
+	0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00, 0x30, 0x18, 0x0C, 0x06, 0x03,
+	0x01, 0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x83, 0x0C, 0x06, 0x03, 0x01, 0x03, 0x02,
+	0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x01, 0xAB, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x00, 0x80,
+	0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0xC0, 0x60,
+	0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00, 0x30, 0x18,
+	0x0C, 0x06, 0x03, 0x01, 0x01, 0x84, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x02, 0x03, 0x83, 0x80, 0xC0,
+	0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x01, 0xAB, 0x80, 0xC0, 0x60, 0x30, 0x18,
+	0x0C, 0x00, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06,
+	0x03, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01,
+	0x00, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x01, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x03, 0x83, 0x80,
+	0xC0, 0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x01, 0xA4, 0x80, 0xC0, 0x60, 0x30,
+	0x18, 0x0C, 0x00, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C,
+	0x06, 0x03, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03,
+	0x01, 0x00, 0x05, 0x81, 0x80, 0xC0, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x03, 0x83, 0x80, 0xC0, 0x60,
+	0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x01, 0x9D, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C,
+	0x00, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03,
+	0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x06, 0xC0, 0x80, 0x05, 0x81, 0x80, 0xC0, 0x04,
+	0x82, 0x80, 0xC0, 0x60, 0x03, 0x83, 0x80, 0xC0, 0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30,
+	0x18, 0x01, 0x95, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x00, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C,
+	0x06, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x0E, 0xC0, 0x80, 0x05, 0x81, 0x80, 0xC0,
+	0x04, 0x82, 0x80, 0xC0, 0x60, 0x03, 0x83, 0x80, 0xC0, 0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60,
+	0x30, 0x18, 0x01, 0x8D, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x0C, 0x00, 0x80, 0xC0, 0x60, 0x30, 0x18,
+	0x0C, 0x06, 0x16, 0xC0, 0x80, 0x05, 0x81, 0x80, 0xC0, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x03, 0x83,
+	0x80, 0xC0, 0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x01, 0x85, 0x80, 0xC0, 0x60,
+	0x30, 0x18, 0x0C, 0x1E, 0xC0, 0x80, 0x05, 0x81, 0x80, 0xC0, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x03,
+	0x83, 0x80, 0xC0, 0x60, 0x30, 0x02, 0x84, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x26, 0xC0, 0x80, 0x05,
+	0x81, 0x80, 0xC0, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x03, 0x83, 0x80, 0xC0, 0x60, 0x30, 0x2E, 0xC0,
+	0x80, 0x05, 0x81, 0x80, 0xC0, 0x04, 0x82, 0x80, 0xC0, 0x60, 0x36, 0xC0, 0x80, 0x05, 0x81, 0x80,
+	0xC0, 0xFF, 0x07, 0x00, 0xFF, 0x16, 0x00, 0xFF, 0x2B, 0x00, 0xFF, 0x47, 0x00, 0xFF, 0x6B, 0x00,
+	0xFF, 0x97, 0x00, 0xFF, 0xCB, 0x00, 0xFF, 0x04, 0x01, 0xFF, 0x41, 0x01, 0xFF, 0x80, 0x01, 0xFF,
+	0xC0, 0x01, 0xFF, 0xFF, 0x01, 0xFF, 0x3C, 0x02, 0xFF, 0x75, 0x02, 0xFF, 0xA9, 0x02, 0xFF, 0xD5,
+	0x02, 0xFF, 0xF9, 0x02, 0xFF, 0x15, 0x03, 0xFF, 0x2A, 0x03, 0xFF, 0x39, 0x03,
+};
+
+const uint8_t* const Anim_library[ANIMATIONS] = { Anim_idle, Anim_win, Anim_attract, };
+#endif
+
+/* LIBRARY FUNCTIONS */
+/* Gets an animation built into the firmware, or NULL if they were made for a cube of another size */
+const uint8_t* Anim_Get(enum Anim_Name name) {
+#if CUBE_SIZE == 8
+	return Anim_library[name];
+#else
+	(void)name;
+	return NULL;
+#endif
+}
@@ -0,0 +1,228 @@
+/* Builds the game core of ../ARCHIVED/compileTest.c for the host, for comparing with game.c (see diffTest.c) */
+/* The archived file is included as it is. Its functions are renamed so they do not clash with the ones of the */
+/* LEDCube program, libopencm3 is replaced by the do nothing stubs in stubs/ (archivedCore_CPPFLAGS in the Makefile) */
+/* and rand() is replaced by Archived_Rand, so that apples can be put where game.c puts them */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "archivedCore.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DEFINING MACROS */
+/* Names of compileTest.c which are also used by the LEDCube program */
+#define main Archived_Main
+#define Controller_GetDirection Archived_ControllerGetDirection
+#define Game_Over Archived_GameOver
+#define Game_Start Archived_GameStart
+#define Snake_Init Archived_SnakeInit
+#define Snake_Step Archived_SnakeStep
+#define Snake_Free Archived_SnakeFree
+#define Snake_AddHead Archived_SnakeAddHead
+#define Snake_PopTail Archived_SnakePopTail
+#define Snake_NormalStep Archived_SnakeNormalStep
+#define Snake_AppleStep Archived_SnakeAppleStep
+#define Hardware_Setup Archived_HardwareSetup
+#define Hardware_ReadChannel Archived_HardwareReadChannel
+#define Hardware_RenderCube Archived_HardwareRenderCube
+
+/* compileTest.c never defined these, they are only used by its Game_Start which is never called, and main has no prototype */
+#define WIN_LENGTH 100
+void Hardware_RenderCube(void);
+int main(void);
+
+/* stdlib.h has already been included, so this only changes the calls made by compileTest.c */
+#define rand Archived_Rand
+
+#include "../ARCHIVED/compileTest.c"
+
+/* GLOBAL VARIABLES */
+/* Coordinates the next calls of rand() give, so the next apple goes where game.c put its apple */
+int Archived_nextApple[3];
+int Archived_nextAppleCount = 0;
+
+/* Random numbers given once the coordinates have run out, only if the two cores no longer agree */
+uint32_t Archived_random = 0x9E3779B9;
+
+/* ARCHIVED CORE FUNCTIONS */
+/* Starts a new game, apple being the cell index (as CELL_INDEX of game.h) of the first apple */
+void Archived_Init(int apple) {
+	// None of the globals of compileTest.c were ever meant to be set up more than once
+	Snake_Free();
+	Snake_head = NULL;
+	Snake_tail = NULL;
+	Snake_size = 0;
+
+	Snake_currentDirection[0] = 1;
+	Snake_currentDirection[1] = 0;
+	Snake_currentDirection[2] = 0;
+
+	for (int i = 0; i < 64; i++) {
+		Map_map[i] = 0;
+	}
+
+	Archived_SetNextApple(apple);
+	Snake_Init(0, 5, 5);
+}
+
+/* Runs one step of the game, apple being where any apple generated by this step goes (or ARCHIVED_NO_APPLE) */
+/* Returns false if the snake ran into something */
+bool Archived_Step(int directionChange, int apple) {
+	Archived_SetNextApple(apple);
+	return Snake_Step(directionChange);
+}
+
+/* Frees the snake at the end of a game */
+void Archived_Free() {
+	Snake_Free();
+}
+
+/* Gets the map of the cube, laid out like the map of game.h */
+const char* Archived_Map() {
+	return Map_map;
+}
+
+/* Gets the length of the snake */
+int Archived_Size() {
+	return Snake_size;
+}
+
+/* Makes the next three calls of rand() give the coordinates of cell */
+void Archived_SetNextApple(int apple) {
+	if (apple == ARCHIVED_NO_APPLE) {
+		Archived_nextAppleCount = 0;
+		return;
+	}
+
+	// Map_GenerateApple takes x, then y, then z, each modulo 8, and they are taken from the end
+	Archived_nextApple[2] = apple & 7;
+	Archived_nextApple[1] = apple >> 3 & 7;
+	Archived_nextApple[0] = apple >> 6 & 7;
+	Archived_nextAppleCount = 3;
+}
+
+/* Stands in for rand() in compileTest.c */
+int Archived_Rand() {
+	if (Archived_nextAppleCount > 0) {
+		Archived_nextAppleCount--;
+		return Archived_nextApple[Archived_nextAppleCount];
+	}
+
+	// xorshift32, as in random.c
+	Archived_random ^= Archived_random << 13;
+	Archived_random ^= Archived_random >> 17;
+	Archived_random ^= Archived_random << 5;
+	return Archived_random >> 1;
+}
+
+/* STUBS */
+/* Nothing is ever shown, so these do nothing. The joystick always reads as at rest */
+void Hardware_RenderCube() {
+}
+
+void rcc_periph_clock_enable(enum rcc_periph_clken clken) {
+	(void)clken;
+}
+
+void gpio_mode_setup(uint32_t gpioport, uint8_t mode, uint8_t pull_up_down, uint16_t gpios) {
+	(void)gpioport, (void)mode, (void)pull_up_down, (void)gpios;
+}
+
+void gpio_set_output_options(uint32_t gpioport, uint8_t otype, uint8_t speed, uint16_t gpios) {
+	(void)gpioport, (void)otype, (void)speed, (void)gpios;
+}
+
+void gpio_set_af(uint32_t gpioport, uint8_t alt_func_num, uint16_t gpios) {
+	(void)gpioport, (void)alt_func_num, (void)gpios;
+}
+
+void gpio_set(uint32_t gpioport, uint16_t gpios) {
+	(void)gpioport, (void)gpios;
+}
+
+void usart_set_baudrate(uint32_t usart, uint32_t baud) {
+	(void)usart, (void)baud;
+}
+
+void usart_set_databits(uint32_t usart, uint32_t bits) {
+	(void)usart, (void)bits;
+}
+
+void usart_set_stopbits(uint32_t usart, uint32_t stopbits) {
+	(void)usart, (void)stopbits;
+}
+
+void usart_set_mode(uint32_t usart, uint32_t mode) {
+	(void)usart, (void)mode;
+}
+
+void usart_set_parity(uint32_t usart, uint32_t parity) {
+	(void)usart, (void)parity;
+}
+
+void usart_set_flow_control(uint32_t usart, uint32_t flowcontrol) {
+	(void)usart, (void)flowcontrol;
+}
+
+void usart_enable_rx_interrupt(uint32_t usart) {
+	(void)usart;
+}
+
+void usart_enable_tx_interrupt(uint32_t usart) {
+	(void)usart;
+}
+
+void usart_enable(uint32_t usart) {
+	(void)usart;
+}
+
+void usart_send_blocking(uint32_t usart, uint16_t data) {
+	(void)usart, (void)data;
+}
+
+void adc_power_off(uint32_t adc) {
+	(void)adc;
+}
+
+void adc_power_on(uint32_t adc) {
+	(void)adc;
+}
+
+void adc_set_clk_prescale(uint32_t adc, uint32_t prescaler) {
+	(void)adc, (void)prescaler;
+}
+
+void adc_disable_external_trigger_regular(uint32_t adc) {
+	(void)adc;
+}
+
+void adc_set_right_aligned(uint32_t adc) {
+	(void)adc;
+}
+
+void adc_set_sample_time_on_all_channels(uint32_t adc, uint8_t time) {
+	(void)adc, (void)time;
+}
+
+void adc_set_resolution(uint32_t adc, uint16_t resolution) {
+	(void)adc, (void)resolution;
+}
+
+void adc_set_regular_sequence(uint32_t adc, uint8_t length, uint8_t channel[]) {
+	(void)adc, (void)length, (void)channel;
+}
+
+void adc_start_conversion_regular(uint32_t adc) {
+	(void)adc;
+}
+
+bool adc_eoc(uint32_t adc) {
+	(void)adc;
+	return true;
+}
+
+uint32_t adc_read_regular(uint32_t adc) {
+	(void)adc;
+	return 2048;
+}
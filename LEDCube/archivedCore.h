@@ -0,0 +1,21 @@
+/* The game core of ../ARCHIVED/compileTest.c, built for the host so it can be run side by side with game.c */
+/* Its functions are renamed Archived_ so both can be linked into one program, see archivedCore.c */
+/* All of its state is global, so only one archived game can be played at a time */
+#ifndef ARCHIVED_CORE_H
+#define ARCHIVED_CORE_H
+
+#include <stdbool.h>
+
+/* DEFINING MACROS */
+#define ARCHIVED_NO_APPLE -1 // No apple is generated, same as NO_APPLE of game.h
+
+/* FUNCTION DECLARATIONS */
+void Archived_Init(int apple);
+bool Archived_Step(int directionChange, int apple);
+void Archived_Free(void);
+const char* Archived_Map(void);
+int Archived_Size(void);
+void Archived_SetNextApple(int apple);
+int Archived_Rand(void);
+
+#endif
@@ -0,0 +1,279 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "autopilot.h"
+
+#include <string.h>
+
+/* AUTOPILOT FUNCTIONS */
+/* Gets an autopilot ready for a new game, with no way to follow */
+void Autopilot_Init(struct Autopilot* autopilot) {
+	autopilot->length = 0;
+	autopilot->next = 0;
+	autopilot->apple = NO_APPLE;
+	autopilot->work = 0;
+
+	autopilot->searches = 0;
+	autopilot->followed = 0;
+	autopilot->overBudget = 0;
+	autopilot->mostWork = 0;
+}
+
+/* Picks the next direction change for one of the snakes of game, taking no more than AUTOPILOT_BUDGET cells of work */
+enum DirectionChange Autopilot_Choose(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake) {
+	autopilot->work = 0;
+
+	enum DirectionChange directionChange = Autopilot_Plan(autopilot, game, snake);
+
+	if (autopilot->work >= AUTOPILOT_BUDGET) {
+		autopilot->overBudget++;
+	}
+	if (autopilot->work > autopilot->mostWork) {
+		autopilot->mostWork = autopilot->work;
+	}
+
+	return directionChange;
+}
+
+/* Works out the next direction change, see autopilot.h */
+enum DirectionChange Autopilot_Plan(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake) {
+	uint16_t head = snake->body[snake->head];
+	uint16_t cells[CENTRE + 1];
+	enum Direction directions[CENTRE + 1];
+	enum DirectionChange directionChanges[CENTRE + 1];
+	uint16_t safe[CENTRE + 1];
+	int count = 0;
+	int safeCount = 0;
+	int best = 0;
+	int bestRoom = -1;
+
+	// A cell for every segment is enough to be sure of getting out again, as the tail moves on as fast as the head does
+	int enough = snake->size;
+
+	// The free cells the head can step into, going straight on first
+	// Some direction changes go the same way (UP when already going up), so each cell is only taken once
+	for (int i = CENTRE; i >= RIGHT; i--) {
+		enum Direction direction = Snake_TurnDirection(snake->direction, i);
+		const int8_t* step = Snake_StepOf(direction);
+		int x = CELL_X(head) + step[0];
+		int y = CELL_Y(head) + step[1];
+		int z = CELL_Z(head) + step[2];
+		bool taken = false;
+
+		if (!Autopilot_IsFree(game->cube.occupied, x, y, z)) {
+			continue;
+		}
+
+		for (int j = 0; j < count; j++) {
+			taken |= cells[j] == CELL_INDEX(x, y, z);
+		}
+		if (taken) {
+			continue;
+		}
+
+		cells[count] = CELL_INDEX(x, y, z);
+		directions[count] = direction;
+		directionChanges[count] = i;
+		count++;
+	}
+
+	// Nowhere to go, so the game is lost whatever happens
+	if (count == 0) {
+		autopilot->apple = NO_APPLE;
+		return CENTRE;
+	}
+
+	// Keep to the way found before for as long as its next step leaves enough room
+	if (Autopilot_Follow(autopilot, game, head)) {
+		for (int i = 0; i < count; i++) {
+			if (cells[i] == autopilot->path[autopilot->next] && Autopilot_Room(autopilot, game, snake, cells[i], directions[i], enough) >= enough) {
+				autopilot->next++;
+				autopilot->followed++;
+				return directionChanges[i];
+			}
+		}
+	}
+	autopilot->apple = NO_APPLE;
+
+	// Room left by each step, those leaving enough being safe to start a way to the apple with
+	for (int i = 0; i < count; i++) {
+		int room = Autopilot_Room(autopilot, game, snake, cells[i], directions[i], enough);
+
+		if (room >= enough) {
+			safe[safeCount++] = AUTOPILOT_STATE(cells[i], directions[i]);
+		}
+		if (room > bestRoom) {
+			best = i;
+			bestRoom = room;
+		}
+	}
+
+	// Shortest way to the apple which starts with a safe step
+	if (safeCount > 0 && game->cube.apple != NO_APPLE) {
+		autopilot->searches++;
+
+		Autopilot_Search(autopilot, game, snake, safe, safeCount, game->cube.apple, NUM_LEDS);
+		if (autopilot->apple != NO_APPLE) {
+			for (int i = 0; i < count; i++) {
+				if (cells[i] == autopilot->path[0]) {
+					autopilot->next = 1;
+					return directionChanges[i];
+				}
+			}
+		}
+
+		autopilot->apple = NO_APPLE;
+	}
+
+	// No safe way to the apple, or no time left to find one, so make as much room as there is
+	return directionChanges[best];
+}
+
+/* Checks whether the way found before can still be followed from head */
+/* It can if the apple has not moved, the snake took the last step along it and nothing has got in the way since */
+/* Only the head and tail of each snake move in a step, so this is a bit test a cell rather than a new search */
+bool Autopilot_Follow(const struct Autopilot* autopilot, const struct GameState* game, uint16_t head) {
+	if (autopilot->apple == NO_APPLE || autopilot->apple != game->cube.apple) {
+		return false;
+	}
+
+	if (autopilot->next <= 0 || autopilot->next >= autopilot->length || autopilot->path[autopilot->next - 1] != head) {
+		return false;
+	}
+
+	for (int i = autopilot->next; i < autopilot->length; i++) {
+		uint16_t cell = autopilot->path[i];
+
+		if (!Autopilot_IsFree(game->cube.occupied, CELL_X(cell), CELL_Y(cell), CELL_Z(cell))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Counts the cells snake could reach after stepping into cell going in direction, stopping once there are enough */
+int Autopilot_Room(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake, uint16_t cell, enum Direction direction, int enough) {
+	uint16_t start = AUTOPILOT_STATE(cell, direction);
+
+	return Autopilot_Search(autopilot, game, snake, &start, 1, NO_APPLE, enough);
+}
+
+/* Breadth first search from the states in starts, a flood fill of the cells snake could get to by turning as it can */
+/* Stops once it reaches goal, keeping the shortest way there as the way to follow, or once it has reached enough cells */
+/* Returns the number of cells reached, which is short of enough if there are no more or the budget ran out */
+/* The tail of the snake counts as free, as it moves on when the head does */
+int Autopilot_Search(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake, const uint16_t* starts, int startCount, int goal, int enough) {
+	int first = 0;
+	int last = 0;
+	int reached = 0;
+
+	Autopilot_Block(autopilot, game, snake);
+
+	for (int i = 0; i < startCount; i++) {
+		uint16_t state = starts[i];
+		uint16_t cell = AUTOPILOT_CELL(state);
+		int column = CUBE_COLUMN_INDEX(CELL_X(cell), CELL_Y(cell));
+
+		reached += !(autopilot->reached[column] >> CELL_Z(cell) & 1);
+		autopilot->seen[AUTOPILOT_DIRECTION(state)][column] |= (Cube_Column)(1 << CELL_Z(cell));
+		autopilot->reached[column] |= (Cube_Column)(1 << CELL_Z(cell));
+		autopilot->parent[state] = DIRECTIONS;
+		autopilot->queue[last++] = state;
+
+		if (cell == goal) {
+			Autopilot_Trace(autopilot, state);
+			return reached;
+		}
+	}
+
+	while (first < last && reached < enough && autopilot->work < AUTOPILOT_BUDGET) {
+		uint16_t state = autopilot->queue[first++];
+		uint16_t cell = AUTOPILOT_CELL(state);
+		enum Direction entered = AUTOPILOT_DIRECTION(state);
+		int x = CELL_X(cell);
+		int y = CELL_Y(cell);
+		int z = CELL_Z(cell);
+
+		autopilot->work++;
+
+		// Only the directions the snake could turn to, so never back the way it came (see Snake_TurnDirection)
+		// UP and DOWN go the same way going up or down, which the seen cells of that direction take care of
+		for (int i = RIGHT; i <= CENTRE; i++) {
+			enum Direction direction = Snake_TurnDirection(entered, i);
+			const int8_t* step = Snake_StepOf(direction);
+			int nextX = x + step[0];
+			int nextY = y + step[1];
+			int nextZ = z + step[2];
+
+			if (!Autopilot_IsFree(autopilot->seen[direction], nextX, nextY, nextZ)) {
+				continue;
+			}
+
+			uint16_t next = CELL_INDEX(nextX, nextY, nextZ);
+			uint16_t nextState = AUTOPILOT_STATE(next, direction);
+			int column = CUBE_COLUMN_INDEX(nextX, nextY);
+
+			// A cell counts once, however many ways it is stepped into
+			reached += !(autopilot->reached[column] >> nextZ & 1);
+			autopilot->seen[direction][column] |= (Cube_Column)(1 << nextZ);
+			autopilot->reached[column] |= (Cube_Column)(1 << nextZ);
+			autopilot->parent[nextState] = entered;
+
+			if (next == goal) {
+				Autopilot_Trace(autopilot, nextState);
+				return reached;
+			}
+
+			autopilot->queue[last++] = nextState;
+		}
+	}
+
+	return reached;
+}
+
+/* Keeps the way the search took to state (the apple) as the way to follow, from its first step */
+/* The cell before each state is a step back along the direction of the state, the direction it was stepped into
+ * going being the parent of the state. A search takes each state once, so a way has at most AUTOPILOT_STATES cells */
+void Autopilot_Trace(struct Autopilot* autopilot, uint16_t state) {
+	uint16_t cell = AUTOPILOT_CELL(state);
+	enum Direction direction = AUTOPILOT_DIRECTION(state);
+	int length = 0;
+
+	// Walk back to the start, then turn the way round
+	while (length < AUTOPILOT_STATES) {
+		uint8_t before = autopilot->parent[AUTOPILOT_STATE(cell, direction)];
+		const int8_t* step = Snake_StepOf(direction);
+
+		autopilot->path[length++] = cell;
+		if (before == DIRECTIONS) {
+			break;
+		}
+
+		cell = CELL_INDEX(CELL_X(cell) - step[0], CELL_Y(cell) - step[1], CELL_Z(cell) - step[2]);
+		direction = before;
+	}
+
+	for (int i = 0; i < length / 2; i++) {
+		uint16_t swap = autopilot->path[i];
+		autopilot->path[i] = autopilot->path[length - 1 - i];
+		autopilot->path[length - 1 - i] = swap;
+	}
+
+	autopilot->length = length;
+	autopilot->apple = autopilot->path[length - 1];
+}
+
+/* Starts the seen cells of a search off as every cell taken by a snake, but for the tail of snake */
+void Autopilot_Block(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake) {
+	uint16_t tail = snake->body[snake->tail];
+
+	memcpy(autopilot->reached, game->cube.occupied, sizeof(autopilot->reached));
+	autopilot->reached[CUBE_COLUMN_INDEX(CELL_X(tail), CELL_Y(tail))] &= (Cube_Column)~(1 << CELL_Z(tail));
+	for (int i = 0; i < DIRECTIONS; i++) {
+		memcpy(autopilot->seen[i], autopilot->reached, sizeof(autopilot->reached));
+	}
+}
+
+/* Checks whether (x, y, z) is inside the cube and not set in cells, a map of the cube */
+bool Autopilot_IsFree(const Cube_Column* cells, int x, int y, int z) {
+	return CUBE_INSIDE(x, y, z) && !(cells[CUBE_COLUMN_INDEX(x, y)] >> z & 1);
+}
@@ -0,0 +1,72 @@
+/* Controller which plays the game by itself, for running the cube unattended as a demo */
+/* Each tick it heads for the apple along the shortest way there (a breadth first search over the free cells), taking
+ * only first steps which leave the snake room to move, as counted by a flood fill from the cell it would step into.
+ * The way found is kept and followed on the next ticks for as long as it stays clear and the apple stays where it
+ * is, as a step only moves the head and the tail, so most ticks only check the way and the room left rather than
+ * searching again. When no way to the apple is safe it takes the step leaving it the most room
+ *
+ * All of the work of a tick is counted in cells expanded (taken from the queue of a search or flood fill, once for
+ * each direction the cell was stepped into going) and stops at AUTOPILOT_BUDGET, so a tick takes a bounded time
+ * however the cube is filled: a cell costs around 100 cycles on the Cortex-M4, a budget of 4 * NUM_LEDS being around
+ * 200000 cycles (25 ms at 8 MHz, under 3 ms at 72 MHz). A tick which runs out of budget takes the best step found so
+ * far. Counting cells rather than cycles keeps the choices the same on every build, so games recorded on the board
+ * replay anywhere
+ * Everything it needs lives in the struct Autopilot, nothing is allocated (about 16 KB on an 8x8x8 cube) */
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "game.h" // Needed for the game being played
+
+/* DEFINING MACROS */
+/* Cells a tick may expand, enough for a whole search of the cube and a flood fill from each possible step */
+#ifndef AUTOPILOT_BUDGET
+#define AUTOPILOT_BUDGET (4 * NUM_LEDS)
+#endif
+
+/* A cell as the search sees it, along with the direction it was stepped into going */
+/* A snake can not turn back, and going up or down can only turn to y (see Snake_TurnDirection), so the direction
+ * decides where it can go next */
+#define AUTOPILOT_STATE(cell, direction) ((uint16_t)((direction) * NUM_LEDS + (cell)))
+#define AUTOPILOT_CELL(state) ((uint16_t)((state) % NUM_LEDS))
+#define AUTOPILOT_DIRECTION(state) ((enum Direction)((state) / NUM_LEDS))
+#define AUTOPILOT_STATES (DIRECTIONS * NUM_LEDS)
+
+/* STRUCTS AND ENUMS */
+/* State of one autopilot, kept from one tick to the next */
+struct Autopilot {
+	/* Way to the apple being followed, path[next] being the next cell to step into */
+	/* A way goes through a state at most once, but may go through a cell in more than one direction */
+	uint16_t path[AUTOPILOT_STATES];
+	int length;
+	int next;
+	int apple; // Cell of the apple the way leads to, NO_APPLE if there is no way being followed
+
+	/* Scratch space of the searches and flood fills */
+	uint16_t queue[AUTOPILOT_STATES];
+	uint8_t parent[AUTOPILOT_STATES]; // Direction the cell before each state was stepped into going, DIRECTIONS for starts
+	Cube_Column seen[DIRECTIONS][CUBE_COLUMNS]; // Cells already queued, by the direction they were stepped into going
+	Cube_Column reached[CUBE_COLUMNS]; // Cells already queued, in any direction
+	int work; // Cells expanded so far this tick
+
+	/* Stats, for working out the budget */
+	unsigned long searches; // Ticks which searched for a new way to the apple
+	unsigned long followed; // Ticks which kept to the way found before
+	unsigned long overBudget; // Ticks which ran out of budget
+	int mostWork; // Most cells expanded in a tick
+};
+
+/* FUNCTION DECLARATIONS */
+void Autopilot_Init(struct Autopilot* autopilot);
+enum DirectionChange Autopilot_Choose(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake);
+enum DirectionChange Autopilot_Plan(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake);
+bool Autopilot_Follow(const struct Autopilot* autopilot, const struct GameState* game, uint16_t head);
+int Autopilot_Room(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake, uint16_t cell, enum Direction direction, int enough);
+int Autopilot_Search(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake, const uint16_t* starts, int startCount, int goal, int enough);
+void Autopilot_Trace(struct Autopilot* autopilot, uint16_t state);
+void Autopilot_Block(struct Autopilot* autopilot, const struct GameState* game, const struct Snake* snake);
+bool Autopilot_IsFree(const Cube_Column* cells, int x, int y, int z);
+
+#endif
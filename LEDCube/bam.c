@@ -0,0 +1,94 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "bam.h"
+
+#include <string.h>
+
+/* FRAMEBUFFER FUNCTIONS */
+/* Turns every LED off */
+void Bam_Clear(struct Bam_Framebuffer* framebuffer) {
+	memset(framebuffer->planes, 0, sizeof(framebuffer->planes));
+}
+
+/* Sets the brightness of the LED at (x, y, z), from 0 (off) to BAM_MAX_LEVEL */
+void Bam_SetLevel(struct Bam_Framebuffer* framebuffer, int x, int y, int z, int level) {
+	int column = CUBE_COLUMN_INDEX(x, y);
+	Cube_Column bit = (Cube_Column)(1 << z);
+
+	for (int plane = 0; plane < BAM_BITS; plane++) {
+		if (level & 1 << plane) {
+			framebuffer->planes[plane][column] |= bit;
+		} else {
+			framebuffer->planes[plane][column] &= (Cube_Column)~bit;
+		}
+	}
+}
+
+/* Gets the brightness of the LED at (x, y, z) */
+int Bam_GetLevel(const struct Bam_Framebuffer* framebuffer, int x, int y, int z) {
+	int column = CUBE_COLUMN_INDEX(x, y);
+	int level = 0;
+
+	for (int plane = 0; plane < BAM_BITS; plane++) {
+		level |= (framebuffer->planes[plane][column] >> z & 1) << plane;
+	}
+
+	return level;
+}
+
+/* Sets every LED lit in map to the given brightness, a column at a time, leaving the others as they are */
+void Bam_FillMap(struct Bam_Framebuffer* framebuffer, const Cube_Column* map, int level) {
+	for (int plane = 0; plane < BAM_BITS; plane++) {
+		Cube_Column* columns = framebuffer->planes[plane];
+
+		for (int i = 0; i < CUBE_COLUMNS; i++) {
+			columns[i] = level & 1 << plane ? columns[i] | map[i] : columns[i] & (Cube_Column)~map[i];
+		}
+	}
+}
+
+/* Gets the map to send for a plane, which for lowestPlane also lights every LED lit in a plane below it */
+/* So the plane BAM_BITS - 1 with lowestPlane BAM_BITS - 1 is every LED which is lit at all */
+void Bam_GetPlane(const struct Bam_Framebuffer* framebuffer, int plane, int lowestPlane, Cube_Column* map) {
+	memcpy(map, framebuffer->planes[plane], sizeof(framebuffer->planes[plane]));
+
+	if (plane != lowestPlane) {
+		return;
+	}
+
+	for (int below = 0; below < plane; below++) {
+		for (int i = 0; i < CUBE_COLUMNS; i++) {
+			map[i] |= framebuffer->planes[below][i];
+		}
+	}
+}
+
+/* SCHEDULER FUNCTIONS */
+/* Start cycling through the planes, each unit being frameMillis (the time the link takes to send a frame) */
+/* As many planes are sent as fit a whole cycle in period, the most significant one at least */
+/* e.g. at 9600 baud with a period of 1000 ms that is 3 planes, cycling every 7 units of 68 ms */
+void Bam_InitScheduler(struct Bam_Scheduler* scheduler, uint32_t frameMillis, uint32_t period, uint32_t now) {
+	int planes = 1;
+
+	scheduler->unit = frameMillis > 0 ? frameMillis : 1;
+	while (planes < BAM_BITS && ((1u << (planes + 1)) - 1) * scheduler->unit <= period) {
+		planes++;
+	}
+
+	scheduler->lowestPlane = BAM_BITS - planes;
+	scheduler->plane = scheduler->lowestPlane; // So the first plane shown is the most significant one
+	scheduler->nextPlane = now;
+}
+
+/* Moves on to the next plane once it is due, returns it. It is shown until scheduler->nextPlane */
+/* A cycle which fell behind (a tick which took longer than a unit) starts again from now rather than catching up */
+int Bam_Advance(struct Bam_Scheduler* scheduler, uint32_t now) {
+	if ((int32_t)(now - scheduler->nextPlane) > 0) {
+		scheduler->nextPlane = now;
+	}
+
+	// Most significant plane first, down to the lowest one sent and round again
+	scheduler->plane = scheduler->plane == scheduler->lowestPlane ? BAM_BITS - 1 : scheduler->plane - 1;
+	scheduler->nextPlane += scheduler->unit << (scheduler->plane - scheduler->lowestPlane);
+
+	return scheduler->plane;
+}
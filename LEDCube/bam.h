@@ -0,0 +1,44 @@
+/* Brightness of every LED of the cube, shown on cube firmware which only knows on and off by bit angle modulation */
+/* Each LED has BAM_BITS bits of brightness, kept as BAM_BITS planes laid out as cube maps, plane b holding bit b of
+ * every LED. The planes are sent one after another as ordinary frames, plane b staying on the cube for 2^b units of
+ * time, so each LED is lit for a share of the time in proportion to its brightness
+ * A unit can be no shorter than the link takes to send a frame (68 ms for a full frame at 9600 baud), so the least
+ * significant planes are dropped until a whole cycle fits in the time it is given (see Bam_InitScheduler). The lowest
+ * plane sent takes in those dropped below it, so nothing lit ever goes dark */
+#ifndef BAM_H
+#define BAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cube.h" // Needed for the layout of a plane
+
+/* DEFINING MACROS */
+#define BAM_BITS 4
+#define BAM_MAX_LEVEL ((1 << BAM_BITS) - 1)
+
+/* STRUCTS AND ENUMS */
+/* Brightness of every LED, as BAM_BITS planes */
+struct Bam_Framebuffer {
+	Cube_Column planes[BAM_BITS][CUBE_COLUMNS];
+};
+
+/* Which plane to show and until when */
+struct Bam_Scheduler {
+	uint32_t unit; // Milliseconds the lowest plane sent is shown for
+	int lowestPlane; // Least significant plane sent, the ones below it are taken into it
+	int plane; // Plane being shown
+	uint32_t nextPlane; // Time (in milliseconds of Hardware_GetMillis) the next plane is due
+};
+
+/* FUNCTION DECLARATIONS */
+void Bam_Clear(struct Bam_Framebuffer* framebuffer);
+void Bam_SetLevel(struct Bam_Framebuffer* framebuffer, int x, int y, int z, int level);
+int Bam_GetLevel(const struct Bam_Framebuffer* framebuffer, int x, int y, int z);
+void Bam_FillMap(struct Bam_Framebuffer* framebuffer, const Cube_Column* map, int level);
+void Bam_GetPlane(const struct Bam_Framebuffer* framebuffer, int plane, int lowestPlane, Cube_Column* map);
+
+void Bam_InitScheduler(struct Bam_Scheduler* scheduler, uint32_t frameMillis, uint32_t period, uint32_t now);
+int Bam_Advance(struct Bam_Scheduler* scheduler, uint32_t now);
+
+#endif
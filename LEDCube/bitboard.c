@@ -0,0 +1,255 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "bitboard.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* WHOLE BOARD FUNCTIONS */
+#if BITBOARD_WHOLE_BOARD
+/* Reads a cube map into board */
+void Bitboard_Load(struct Bitboard* board, const Cube_Column* map) {
+#if CUBE_SIZE == 8
+	memcpy(board->rows, map, sizeof(board->rows));
+#else
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		board->rows[y] = Bitboard_Row(map, y);
+	}
+#endif
+}
+
+/* Writes board out as a cube map */
+void Bitboard_Store(const struct Bitboard* board, Cube_Column* map) {
+#if CUBE_SIZE == 8
+	memcpy(map, board->rows, sizeof(board->rows));
+#else
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		memcpy(map + CUBE_SIZE * y, &board->rows[y], CUBE_SIZE);
+	}
+#endif
+}
+
+/* Empties board */
+void Bitboard_Clear(struct Bitboard* board) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		board->rows[y] = 0;
+	}
+}
+
+/* Puts every cell of the cube in board */
+void Bitboard_Fill(struct Bitboard* board) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		board->rows[y] = BITBOARD_ROW_MASK;
+	}
+}
+
+/* Cells in a or b */
+void Bitboard_Union(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		result->rows[y] = a->rows[y] | b->rows[y];
+	}
+}
+
+/* Cells in both a and b */
+void Bitboard_Intersect(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		result->rows[y] = a->rows[y] & b->rows[y];
+	}
+}
+
+/* Cells in a but not in b */
+void Bitboard_Subtract(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		result->rows[y] = a->rows[y] & ~b->rows[y];
+	}
+}
+
+/* Moves every cell of board one step in direction, dropping the ones which would leave the cube */
+/* result may be board */
+void Bitboard_Shift(struct Bitboard* result, const struct Bitboard* board, enum Bitboard_Direction direction) {
+	switch (direction) {
+		case BITBOARD_PLUS_X:
+			for (int y = 0; y < BITBOARD_ROWS; y++) {
+				result->rows[y] = board->rows[y] << 8 & BITBOARD_ROW_MASK;
+			}
+			break;
+		case BITBOARD_MINUS_X:
+			for (int y = 0; y < BITBOARD_ROWS; y++) {
+				result->rows[y] = board->rows[y] >> 8;
+			}
+			break;
+		case BITBOARD_PLUS_Y:
+			for (int y = BITBOARD_ROWS - 1; y > 0; y--) {
+				result->rows[y] = board->rows[y - 1];
+			}
+			result->rows[0] = 0;
+			break;
+		case BITBOARD_MINUS_Y:
+			for (int y = 0; y < BITBOARD_ROWS - 1; y++) {
+				result->rows[y] = board->rows[y + 1];
+			}
+			result->rows[BITBOARD_ROWS - 1] = 0;
+			break;
+		case BITBOARD_PLUS_Z:
+			for (int y = 0; y < BITBOARD_ROWS; y++) {
+				result->rows[y] = board->rows[y] << 1 & BITBOARD_NOT_BOTTOM;
+			}
+			break;
+		case BITBOARD_MINUS_Z:
+			for (int y = 0; y < BITBOARD_ROWS; y++) {
+				result->rows[y] = board->rows[y] >> 1 & BITBOARD_NOT_TOP;
+			}
+			break;
+		default:
+			*result = *board;
+			break;
+	}
+}
+
+/* Adds every neighbour of a cell of board to it, keeping only the cells which are also in within */
+/* within must only hold cells of the cube, which keeps the cells grown out past the edges off it */
+/* One step of a flood fill, repeating it until nothing changes finds everything reachable through within */
+void Bitboard_Grow(struct Bitboard* result, const struct Bitboard* board, const struct Bitboard* within) {
+	uint64_t previous = 0;
+
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		uint64_t row = board->rows[y];
+		uint64_t next = y < BITBOARD_ROWS - 1 ? board->rows[y + 1] : 0;
+		uint64_t grown = row | row << 8 | row >> 8 | (row << 1 & BITBOARD_NOT_BOTTOM) | (row >> 1 & BITBOARD_NOT_TOP) | previous | next;
+
+		// Kept before result->rows[y] is written, in case result is board
+		previous = row;
+		result->rows[y] = grown & within->rows[y];
+	}
+}
+
+/* Gets the number of cells in board */
+int Bitboard_Count(const struct Bitboard* board) {
+	int count = 0;
+
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		count += __builtin_popcountll(board->rows[y]);
+	}
+
+	return count;
+}
+
+/* Gets the cell index (see CELL_INDEX) of the first cell of board in row order, or -1 if it is empty */
+int Bitboard_First(const struct Bitboard* board) {
+	for (int y = 0; y < BITBOARD_ROWS; y++) {
+		if (board->rows[y] != 0) {
+			int bit = __builtin_ctzll(board->rows[y]);
+			return CELL_INDEX(bit >> 3, y, bit & 7);
+		}
+	}
+
+	return -1;
+}
+#endif
+
+/* SIMD FUNCTIONS */
+/* Same as the functions above, two rows at a time */
+#if BITBOARD_SIMD && defined(__SSE2__)
+
+void Bitboard_UnionSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		__m128i rows = _mm_or_si128(_mm_load_si128((const __m128i*)&a->rows[y]), _mm_load_si128((const __m128i*)&b->rows[y]));
+		_mm_store_si128((__m128i*)&result->rows[y], rows);
+	}
+}
+
+void Bitboard_IntersectSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		__m128i rows = _mm_and_si128(_mm_load_si128((const __m128i*)&a->rows[y]), _mm_load_si128((const __m128i*)&b->rows[y]));
+		_mm_store_si128((__m128i*)&result->rows[y], rows);
+	}
+}
+
+void Bitboard_SubtractSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		__m128i rows = _mm_andnot_si128(_mm_load_si128((const __m128i*)&b->rows[y]), _mm_load_si128((const __m128i*)&a->rows[y]));
+		_mm_store_si128((__m128i*)&result->rows[y], rows);
+	}
+}
+
+void Bitboard_GrowSimd(struct Bitboard* result, const struct Bitboard* board, const struct Bitboard* within) {
+	const __m128i notTop = _mm_set1_epi64x((long long)BITBOARD_NOT_TOP);
+	const __m128i notBottom = _mm_set1_epi64x((long long)BITBOARD_NOT_BOTTOM);
+	__m128i rows[BITBOARD_ROWS / 2 + 2];
+
+	// Padded with an empty pair of rows either side, so the rows of the neighbouring pairs are always there
+	rows[0] = _mm_setzero_si128();
+	rows[BITBOARD_ROWS / 2 + 1] = _mm_setzero_si128();
+	for (int i = 0; i < BITBOARD_ROWS / 2; i++) {
+		rows[i + 1] = _mm_load_si128((const __m128i*)&board->rows[2 * i]);
+	}
+
+	for (int i = 1; i <= BITBOARD_ROWS / 2; i++) {
+		__m128i row = rows[i];
+		// Rows y - 1 and y + 1 of each row of the pair, taken across the pairs either side
+		__m128i previous = _mm_or_si128(_mm_slli_si128(row, 8), _mm_srli_si128(rows[i - 1], 8));
+		__m128i next = _mm_or_si128(_mm_srli_si128(row, 8), _mm_slli_si128(rows[i + 1], 8));
+
+		__m128i grown = _mm_or_si128(row, _mm_or_si128(_mm_slli_epi64(row, 8), _mm_srli_epi64(row, 8)));
+		grown = _mm_or_si128(grown, _mm_and_si128(_mm_slli_epi64(row, 1), notBottom));
+		grown = _mm_or_si128(grown, _mm_and_si128(_mm_srli_epi64(row, 1), notTop));
+		grown = _mm_or_si128(grown, _mm_or_si128(previous, next));
+
+		grown = _mm_and_si128(grown, _mm_load_si128((const __m128i*)&within->rows[2 * (i - 1)]));
+		_mm_store_si128((__m128i*)&result->rows[2 * (i - 1)], grown);
+	}
+}
+
+#elif BITBOARD_SIMD && defined(__ARM_NEON)
+
+void Bitboard_UnionSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		vst1q_u64(&result->rows[y], vorrq_u64(vld1q_u64(&a->rows[y]), vld1q_u64(&b->rows[y])));
+	}
+}
+
+void Bitboard_IntersectSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		vst1q_u64(&result->rows[y], vandq_u64(vld1q_u64(&a->rows[y]), vld1q_u64(&b->rows[y])));
+	}
+}
+
+void Bitboard_SubtractSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b) {
+	for (int y = 0; y < BITBOARD_ROWS; y += 2) {
+		vst1q_u64(&result->rows[y], vbicq_u64(vld1q_u64(&a->rows[y]), vld1q_u64(&b->rows[y])));
+	}
+}
+
+void Bitboard_GrowSimd(struct Bitboard* result, const struct Bitboard* board, const struct Bitboard* within) {
+	const uint64x2_t notTop = vdupq_n_u64(BITBOARD_NOT_TOP);
+	const uint64x2_t notBottom = vdupq_n_u64(BITBOARD_NOT_BOTTOM);
+	uint64x2_t rows[BITBOARD_ROWS / 2 + 2];
+
+	// Padded with an empty pair of rows either side, so the rows of the neighbouring pairs are always there
+	rows[0] = vdupq_n_u64(0);
+	rows[BITBOARD_ROWS / 2 + 1] = vdupq_n_u64(0);
+	for (int i = 0; i < BITBOARD_ROWS / 2; i++) {
+		rows[i + 1] = vld1q_u64(&board->rows[2 * i]);
+	}
+
+	for (int i = 1; i <= BITBOARD_ROWS / 2; i++) {
+		uint64x2_t row = rows[i];
+		// Rows y - 1 and y + 1 of each row of the pair, taken across the pairs either side
+		uint64x2_t previous = vextq_u64(rows[i - 1], row, 1);
+		uint64x2_t next = vextq_u64(row, rows[i + 1], 1);
+
+		uint64x2_t grown = vorrq_u64(row, vorrq_u64(vshlq_n_u64(row, 8), vshrq_n_u64(row, 8)));
+		grown = vorrq_u64(grown, vandq_u64(vshlq_n_u64(row, 1), notBottom));
+		grown = vorrq_u64(grown, vandq_u64(vshrq_n_u64(row, 1), notTop));
+		grown = vorrq_u64(grown, vorrq_u64(previous, next));
+
+		vst1q_u64(&result->rows[2 * (i - 1)], vandq_u64(grown, vld1q_u64(&within->rows[2 * (i - 1)])));
+	}
+}
+
+#endif
@@ -0,0 +1,134 @@
+/* Word wide operations on sets of cells of the cube */
+/* A cube map (byte CUBE_COLUMN_INDEX(x, y) holding the z column of (x, y) as bit z) already is a bitboard, */
+/* here it is handled as CUBE_SIZE little endian 64 bit rows, row y holding column (x, y) in byte x, so bit 8 * x + z */
+/* That needs a row to fit in a word, so the whole board operations only exist for cubes of up to 8x8x8 */
+/* (BITBOARD_WHOLE_BOARD), bigger cubes only get the single cell functions, done a column at a time */
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cube.h" // Needed for the size of the cube
+
+/* DEFINING MACROS */
+#if CUBE_SIZE <= 8
+#define BITBOARD_WHOLE_BOARD 1
+
+#define BITBOARD_ROWS CUBE_SIZE
+
+/* Row with column set to the same bits for every x, eg 0x0101010101010101 for 1 on an 8x8x8 cube */
+#define BITBOARD_REPEAT(column) ((uint64_t)(column) * (~(uint64_t)0 / 0xFF >> (64 - 8 * CUBE_SIZE)))
+
+/* Bits of a row which are cells of the cube, all of them on an 8x8x8 cube */
+#define BITBOARD_ROW_MASK BITBOARD_REPEAT((1u << CUBE_SIZE) - 1)
+
+/* Bits of a row which have a neighbour in the +z and -z directions, ie all but the top and bottom of each column */
+#define BITBOARD_NOT_TOP BITBOARD_REPEAT((1u << (CUBE_SIZE - 1)) - 1)
+#define BITBOARD_NOT_BOTTOM BITBOARD_REPEAT((1u << CUBE_SIZE) - 2)
+#else
+#define BITBOARD_WHOLE_BOARD 0
+#endif
+
+/* Whether the SIMD versions of the whole board operations are built, for SSE2 or NEON, which take rows in pairs */
+#if (defined(__SSE2__) || defined(__ARM_NEON)) && BITBOARD_WHOLE_BOARD && CUBE_SIZE % 2 == 0
+#define BITBOARD_SIMD 1
+#else
+#define BITBOARD_SIMD 0
+#endif
+
+/* STRUCTS AND ENUMS */
+/* The 6 directions a cell has neighbours in, as used by the neighbour masks */
+enum Bitboard_Direction {
+	BITBOARD_PLUS_X,
+	BITBOARD_MINUS_X,
+	BITBOARD_PLUS_Y,
+	BITBOARD_MINUS_Y,
+	BITBOARD_PLUS_Z,
+	BITBOARD_MINUS_Z,
+	BITBOARD_DIRECTIONS,
+};
+
+#if BITBOARD_WHOLE_BOARD
+/* Set of cells of the cube */
+/* Aligned so the SIMD versions can load it whole */
+struct Bitboard {
+	uint64_t rows[BITBOARD_ROWS];
+} __attribute__((aligned(16)));
+
+/* FUNCTION DECLARATIONS */
+void Bitboard_Load(struct Bitboard* board, const Cube_Column* map);
+void Bitboard_Store(const struct Bitboard* board, Cube_Column* map);
+void Bitboard_Clear(struct Bitboard* board);
+void Bitboard_Fill(struct Bitboard* board);
+void Bitboard_Union(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_Intersect(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_Subtract(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_Shift(struct Bitboard* result, const struct Bitboard* board, enum Bitboard_Direction direction);
+void Bitboard_Grow(struct Bitboard* result, const struct Bitboard* board, const struct Bitboard* within);
+int Bitboard_Count(const struct Bitboard* board);
+int Bitboard_First(const struct Bitboard* board);
+#endif
+
+#if BITBOARD_SIMD
+void Bitboard_UnionSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_IntersectSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_SubtractSimd(struct Bitboard* result, const struct Bitboard* a, const struct Bitboard* b);
+void Bitboard_GrowSimd(struct Bitboard* result, const struct Bitboard* board, const struct Bitboard* within);
+#endif
+
+/* SINGLE CELL FUNCTIONS */
+/* Small enough to be worth inlining into the game loop, unlike the whole board operations in bitboard.c */
+
+/* Checks whether (x, y, z) is inside the cube, with one comparison on cubes with a power of two size */
+static inline int Bitboard_Inside(int x, int y, int z) {
+	return CUBE_INSIDE(x, y, z);
+}
+
+/* Gets the bit of a cube map at (x, y, z), which has to be inside the cube */
+static inline int Bitboard_Test(const Cube_Column* map, int x, int y, int z) {
+	return map[CUBE_COLUMN_INDEX(x, y)] >> z & 1;
+}
+
+#if BITBOARD_WHOLE_BOARD
+/* Gets row y of a cube map */
+static inline uint64_t Bitboard_Row(const Cube_Column* map, int y) {
+	uint64_t row = 0;
+	memcpy(&row, map + CUBE_SIZE * y, CUBE_SIZE); // Compiles to a single load
+	return row;
+}
+
+/* Gets the neighbours of cell (x, y, z) which are inside the cube and clear in map */
+/* As a mask with bit d set for a free neighbour in direction d of enum Bitboard_Direction */
+static inline unsigned Bitboard_FreeNeighbours(const Cube_Column* map, int x, int y, int z) {
+	unsigned p = 8 * x + z;
+	uint64_t row = ~Bitboard_Row(map, y) & BITBOARD_ROW_MASK;
+	// Rows past the edges of the cube are all blocked, the masks stop reading outside of map
+	uint64_t above = y < CUBE_SIZE - 1 ? ~Bitboard_Row(map, y + 1) & BITBOARD_ROW_MASK : 0;
+	uint64_t below = y > 0 ? ~Bitboard_Row(map, y - 1) & BITBOARD_ROW_MASK : 0;
+
+	// Shifting a row moves the neighbours of every cell onto it, cells at the edges get 0 shifted in or masked off
+	return ((unsigned)(row >> 8 >> p) & 1) << BITBOARD_PLUS_X
+		| ((unsigned)(row << 8 >> p) & 1) << BITBOARD_MINUS_X
+		| ((unsigned)(above >> p) & 1) << BITBOARD_PLUS_Y
+		| ((unsigned)(below >> p) & 1) << BITBOARD_MINUS_Y
+		| ((unsigned)((row >> 1 & BITBOARD_NOT_TOP) >> p) & 1) << BITBOARD_PLUS_Z
+		| ((unsigned)((row << 1 & BITBOARD_NOT_BOTTOM) >> p) & 1) << BITBOARD_MINUS_Z;
+}
+#else
+/* Gets the neighbours of cell (x, y, z) which are inside the cube and clear in map, looking at each in turn */
+/* As a mask with bit d set for a free neighbour in direction d of enum Bitboard_Direction */
+static inline unsigned Bitboard_FreeNeighbours(const Cube_Column* map, int x, int y, int z) {
+	const Cube_Column* column = map + CUBE_COLUMN_INDEX(x, y);
+	unsigned free = ~(unsigned)*column;
+
+	return (unsigned)(x < CUBE_SIZE - 1 && !(column[1] >> z & 1)) << BITBOARD_PLUS_X
+		| (unsigned)(x > 0 && !(column[-1] >> z & 1)) << BITBOARD_MINUS_X
+		| (unsigned)(y < CUBE_SIZE - 1 && !(column[CUBE_SIZE] >> z & 1)) << BITBOARD_PLUS_Y
+		| (unsigned)(y > 0 && !(column[-CUBE_SIZE] >> z & 1)) << BITBOARD_MINUS_Y
+		| (unsigned)(z < CUBE_SIZE - 1 && (free >> (z + 1) & 1)) << BITBOARD_PLUS_Z
+		| (unsigned)(z > 0 && (free >> (z - 1) & 1)) << BITBOARD_MINUS_Z;
+}
+#endif
+
+#endif
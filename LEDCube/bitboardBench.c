@@ -0,0 +1,289 @@
+/* Host benchmark of the word wide bitboard operations of bitboard.c against going through the cube one cell at a time */
+/* Usage: bitboardBench [-n ROUNDS]
+ *        checks every way of answering a query gives the same answer on positions from real games, then times
+ *        ROUNDS (200) rounds of each over those positions and reports ns per query */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "bitboard.h"
+#include "policy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if BITBOARD_WHOLE_BOARD
+/* DEFINING MACROS */
+#define BENCH_POSITIONS 256
+
+/* STRUCTS AND ENUMS */
+/* Position of a game to run the queries on, with the snake as a bitboard and the cells it can move through */
+struct Bench_Position {
+	struct GameState game;
+	struct Bitboard snake;
+	struct Bitboard open;
+	struct Bitboard head;
+};
+
+/* FUNCTION DECLARATIONS */
+void Bench_MakePositions(struct Bench_Position* positions, int count);
+unsigned Bench_CellNeighbours(const struct GameState* game);
+unsigned Bench_BitboardNeighbours(const struct GameState* game);
+int Bench_CellFloodFill(const struct GameState* game);
+int Bench_BitboardFloodFill(const struct Bench_Position* position, void (*grow)(struct Bitboard*, const struct Bitboard*, const struct Bitboard*));
+double Bench_Seconds(void);
+void Bench_Report(const char* name, double seconds, long queries);
+
+/* GLOBAL VARIABLES */
+/* Step to the neighbour in each direction, in the order of enum Bitboard_Direction */
+const int Bench_steps[BITBOARD_DIRECTIONS][3] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+
+/* Results of the timed queries end up here, so that the compiler cannot leave them out */
+volatile long Bench_sink;
+
+/* BENCHMARK FUNCTIONS */
+/* Plays greedy games and keeps positions from all stages of them, from short snakes to long ones */
+void Bench_MakePositions(struct Bench_Position* positions, int count) {
+	struct Policy policy;
+	uint32_t seed = 1;
+	int made = 0;
+
+	while (made < count) {
+		struct GameState game;
+		Game_Init(&game, seed);
+		Policy_Init(&policy, POLICY_GREEDY, ~seed);
+		seed++;
+
+		for (long tick = 0; made < count; tick++) {
+			if (Game_Step(&game, Policy_Choose(&policy, &game, &game.snakes[0])) != GAME_PLAYING) {
+				break;
+			}
+
+			// Every 37th tick, so the positions are spread out over the game
+			if (tick % 37 == 0) {
+				struct Bench_Position* position = &positions[made++];
+				struct Bitboard everything;
+				uint16_t head = game.snakes[0].body[game.snakes[0].head];
+
+				position->game = game;
+				Bitboard_Load(&position->snake, game.cube.occupied);
+				Bitboard_Fill(&everything);
+				Bitboard_Subtract(&position->open, &everything, &position->snake);
+				Bitboard_Clear(&position->head);
+				position->head.rows[CELL_Y(head)] = (uint64_t)1 << (8 * CELL_X(head) + CELL_Z(head));
+			}
+		}
+	}
+}
+
+/* Gets the free neighbours of the head by asking about each of them in turn, like the game did before bitboard.h */
+unsigned Bench_CellNeighbours(const struct GameState* game) {
+	uint16_t head = game->snakes[0].body[game->snakes[0].head];
+	unsigned free = 0;
+
+	for (int d = 0; d < BITBOARD_DIRECTIONS; d++) {
+		enum CellState cellState = Cube_GetCellStateAt(game, CELL_X(head) + Bench_steps[d][0], CELL_Y(head) + Bench_steps[d][1], CELL_Z(head) + Bench_steps[d][2]);
+
+		if (cellState == EMPTY || cellState == APPLE) {
+			free |= 1u << d;
+		}
+	}
+
+	return free;
+}
+
+/* Gets the free neighbours of the head with a single bitboard query */
+unsigned Bench_BitboardNeighbours(const struct GameState* game) {
+	uint16_t head = game->snakes[0].body[game->snakes[0].head];
+	return Bitboard_FreeNeighbours(game->cube.occupied, CELL_X(head), CELL_Y(head), CELL_Z(head));
+}
+
+/* Counts the cells the head can reach, with a breadth first search one cell at a time */
+int Bench_CellFloodFill(const struct GameState* game) {
+	uint16_t queue[NUM_LEDS];
+	char seen[NUM_LEDS];
+	int first = 0;
+	int last = 0;
+
+	memset(seen, 0, sizeof(seen));
+	queue[last++] = game->snakes[0].body[game->snakes[0].head];
+	seen[queue[0]] = 1;
+
+	while (first < last) {
+		uint16_t cell = queue[first++];
+
+		for (int d = 0; d < BITBOARD_DIRECTIONS; d++) {
+			int x = CELL_X(cell) + Bench_steps[d][0];
+			int y = CELL_Y(cell) + Bench_steps[d][1];
+			int z = CELL_Z(cell) + Bench_steps[d][2];
+			enum CellState cellState = Cube_GetCellStateAt(game, x, y, z);
+
+			if ((cellState == EMPTY || cellState == APPLE) && !seen[CELL_INDEX(x, y, z)]) {
+				seen[CELL_INDEX(x, y, z)] = 1;
+				queue[last++] = CELL_INDEX(x, y, z);
+			}
+		}
+	}
+
+	// The head itself is part of the snake, so it does not count
+	return last - 1;
+}
+
+/* Counts the cells the head can reach, growing the set of reached cells a step at a time until it stops changing */
+int Bench_BitboardFloodFill(const struct Bench_Position* position, void (*grow)(struct Bitboard*, const struct Bitboard*, const struct Bitboard*)) {
+	struct Bitboard reached;
+	struct Bitboard within;
+	int count = 1;
+	int previous = 0;
+
+	// The head may grow into the open cells
+	Bitboard_Union(&within, &position->open, &position->head);
+	reached = position->head;
+
+	while (count != previous) {
+		previous = count;
+		grow(&reached, &reached, &within);
+		count = Bitboard_Count(&reached);
+	}
+
+	return count - 1;
+}
+
+/* Gets a monotonic time in seconds */
+double Bench_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Prints how long each query took */
+void Bench_Report(const char* name, double seconds, long queries) {
+	printf("%-30s %10.1f ns/query\n", name, seconds * 1e9 / queries);
+}
+
+int main(int argc, char** argv) {
+	struct Bench_Position* positions;
+	int rounds = 200;
+	int option;
+
+	while ((option = getopt(argc, argv, "n:")) != -1) {
+		switch (option) {
+			case 'n':
+				rounds = strtol(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n ROUNDS]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	positions = malloc(BENCH_POSITIONS * sizeof(*positions));
+	if (positions == NULL) {
+		perror("malloc");
+		return EXIT_FAILURE;
+	}
+
+	Bench_MakePositions(positions, BENCH_POSITIONS);
+
+	// Every way of answering has to agree before any of them is timed
+	for (int i = 0; i < BENCH_POSITIONS; i++) {
+		const struct Bench_Position* position = &positions[i];
+		int cells = Bench_CellFloodFill(&position->game);
+
+		if (Bench_CellNeighbours(&position->game) != Bench_BitboardNeighbours(&position->game)
+			|| cells != Bench_BitboardFloodFill(position, Bitboard_Grow)
+#if BITBOARD_SIMD
+			|| cells != Bench_BitboardFloodFill(position, Bitboard_GrowSimd)
+#endif
+			) {
+			fprintf(stderr, "position %d: bitboard and cell by cell answers differ\n", i);
+			free(positions);
+			return EXIT_FAILURE;
+		}
+	}
+
+	long queries = (long)rounds * BENCH_POSITIONS;
+	long sink = 0;
+	double start;
+
+	printf("%d positions from greedy games, %d rounds, SIMD %s\n", BENCH_POSITIONS, rounds, BITBOARD_SIMD ? "on" : "off");
+
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			sink += Bench_CellNeighbours(&positions[i].game);
+		}
+	}
+	Bench_Report("neighbours, cell by cell", Bench_Seconds() - start, queries);
+
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			sink += Bench_BitboardNeighbours(&positions[i].game);
+		}
+	}
+	Bench_Report("neighbours, bitboard", Bench_Seconds() - start, queries);
+
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			sink += Bench_CellFloodFill(&positions[i].game);
+		}
+	}
+	Bench_Report("flood fill, cell by cell", Bench_Seconds() - start, queries);
+
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			sink += Bench_BitboardFloodFill(&positions[i], Bitboard_Grow);
+		}
+	}
+	Bench_Report("flood fill, bitboard", Bench_Seconds() - start, queries);
+
+#if BITBOARD_SIMD
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			sink += Bench_BitboardFloodFill(&positions[i], Bitboard_GrowSimd);
+		}
+	}
+	Bench_Report("flood fill, bitboard SIMD", Bench_Seconds() - start, queries);
+
+	struct Bitboard result;
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			Bitboard_Union(&result, &positions[i].snake, &positions[i].open);
+			Bitboard_Intersect(&result, &result, &positions[i].head);
+			Bitboard_Subtract(&result, &result, &positions[i].snake);
+			sink += result.rows[i % BITBOARD_ROWS];
+		}
+	}
+	Bench_Report("union+intersect+subtract", Bench_Seconds() - start, queries);
+
+	start = Bench_Seconds();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < BENCH_POSITIONS; i++) {
+			Bitboard_UnionSimd(&result, &positions[i].snake, &positions[i].open);
+			Bitboard_IntersectSimd(&result, &result, &positions[i].head);
+			Bitboard_SubtractSimd(&result, &result, &positions[i].snake);
+			sink += result.rows[i % BITBOARD_ROWS];
+		}
+	}
+	Bench_Report("union+intersect+subtract SIMD", Bench_Seconds() - start, queries);
+#endif
+
+	Bench_sink = sink;
+	free(positions);
+
+	return EXIT_SUCCESS;
+}
+#else
+int main(void) {
+	fprintf(stderr, "the whole board operations only exist for cubes of up to 8x8x8, see bitboard.h\n");
+	return EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,55 @@
+/* Geometry of the LED cube, fixed at compile time so every loop and bit operation is sized for it */
+/* An 8x8x8 cube unless built with CPPFLAGS=-DCUBE_SIZE=N, for an NxNxN cube of up to 16x16x16 */
+/* A map of the cube is an array of CUBE_COLUMNS columns, column CUBE_COLUMN_INDEX(x, y) holding cell (x, y, z) as */
+/* bit z, so for 8x8x8 it is the 64 bytes the cube firmware expects */
+#ifndef CUBE_H
+#define CUBE_H
+
+#include <stdint.h>
+
+/* DEFINING MACROS */
+#ifndef CUBE_SIZE
+#define CUBE_SIZE 8
+#endif
+
+#if CUBE_SIZE < 2 || CUBE_SIZE > 16
+#error "CUBE_SIZE has to be between 2 and 16"
+#endif
+
+#define CUBE_COLUMNS (CUBE_SIZE * CUBE_SIZE)
+#define NUM_LEDS (CUBE_SIZE * CUBE_SIZE * CUBE_SIZE)
+
+/* Smallest type with a bit for every z of a column */
+#if CUBE_SIZE <= 8
+#define CUBE_COLUMN_BYTES 1
+typedef uint8_t Cube_Column;
+#else
+#define CUBE_COLUMN_BYTES 2
+typedef uint16_t Cube_Column;
+#endif
+
+#define CUBE_MAP_SIZE (CUBE_COLUMNS * CUBE_COLUMN_BYTES) // Number of bytes in a map
+
+#define CUBE_DIRTY_WORDS ((CUBE_COLUMNS + 63) / 64) // Number of 64 bit words with a bit for every column, see Cube.dirty
+
+#define CUBE_POWER_OF_TWO ((CUBE_SIZE & (CUBE_SIZE - 1)) == 0)
+
+#define CUBE_COLUMN_INDEX(x, y) (CUBE_SIZE * (y) + (x))
+
+/* Whether (x, y, z) is inside the cube. For a power of two any coordinate out of range (negative ones included) */
+/* has a bit set above the low ones, so it is a single comparison of all three at once */
+#if CUBE_POWER_OF_TWO
+#define CUBE_INSIDE(x, y, z) ((unsigned)((x) | (y) | (z)) < CUBE_SIZE)
+#else
+#define CUBE_INSIDE(x, y, z) ((unsigned)(x) < CUBE_SIZE && (unsigned)(y) < CUBE_SIZE && (unsigned)(z) < CUBE_SIZE)
+#endif
+
+/* Packing of an (x, y, z) position into a cell index, used by the snake body and the free cell list */
+/* x and y form the low part so a cell index modulo CUBE_COLUMNS is the index of its column in a map */
+/* Done in unsigned arithmetic so that for a power of two these are the shifts and masks they would be written as */
+#define CELL_INDEX(x, y, z) ((uint16_t)(((z) * CUBE_SIZE + (y)) * CUBE_SIZE + (x)))
+#define CELL_X(c) ((int)((unsigned)(c) % CUBE_SIZE))
+#define CELL_Y(c) ((int)((unsigned)(c) / CUBE_SIZE % CUBE_SIZE))
+#define CELL_Z(c) ((int)((unsigned)(c) / CUBE_COLUMNS))
+
+#endif
@@ -0,0 +1,250 @@
+/* Host harness running the game core of ../ARCHIVED/compileTest.c and game.c side by side on the same inputs */
+/* Usage: ledCubeDiff [-n GAMES] [-s SEED] [-p POLICY] [-l LENGTH] [-t TICKS]
+ *        plays GAMES games (10000) with seeds SEED, SEED + 1, ... (1) in both cores, steered by POLICY (random,
+ *        see policy.h, or blind for any direction change at all) and won at LENGTH (WIN_LENGTH), cut off after
+ *        TICKS steps (10000). The map of the cube (and how the game stands) has to be the same in both after every
+ *        step, otherwise it stops at the first frame where they differ and prints both maps and the inputs so far */
+/* The archived core places apples with rand(), which is made to give the cell game.c picked (see archivedCore.c), */
+/* so what is compared is everything but where the apples go */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "policy.h"
+#include "archivedCore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if CUBE_SIZE == 8
+/* DEFINING MACROS */
+#define DIFF_SHOWN_INPUTS 64 // Most inputs leading up to a difference which are printed
+
+/* STRUCTS AND ENUMS */
+/* What to play */
+struct Diff_Config {
+	long games;
+	uint32_t firstSeed;
+	bool blind; // Any direction change at all, rather than ones chosen by a policy
+	enum Policy_Kind kind;
+	int winLength;
+	long maxTicks;
+};
+
+/* Totals over all games played */
+struct Diff_Totals {
+	long games;
+	long steps;
+	long results[GAME_HIT_SNAKE + 1]; // GAME_PLAYING being the games which were cut off
+};
+
+/* FUNCTION DECLARATIONS */
+bool Diff_Game(const struct Diff_Config* config, uint32_t seed, enum DirectionChange* inputs, struct Diff_Totals* totals);
+enum GameResult Diff_ArchivedResult(bool stepped, int winLength);
+void Diff_Report(uint32_t seed, long tick, const enum DirectionChange* inputs, const struct GameState* game, enum GameResult result, enum GameResult archivedResult);
+double Diff_Seconds(void);
+
+/* GLOBAL VARIABLES */
+/* Names of the results of a game, in the order of enum GameResult */
+const char* const Diff_resultNames[] = { "still playing", "won", "hit wall", "hit itself" };
+
+/* Letters for the direction changes, in the order of enum DirectionChange */
+const char Diff_inputLetters[] = "RLUDC";
+
+/* DIFF FUNCTIONS */
+/* Plays one game in both cores, returns false at the first frame where they differ */
+/* inputs has room for the direction change of every tick */
+bool Diff_Game(const struct Diff_Config* config, uint32_t seed, enum DirectionChange* inputs, struct Diff_Totals* totals) {
+	struct GameState game;
+	struct Policy policy;
+	struct Random random;
+	enum GameResult result = GAME_PLAYING;
+	long tick = 0;
+
+	Game_Init(&game, seed);
+	game.winLength = config->winLength;
+	Policy_Init(&policy, config->kind, ~seed);
+	Random_Seed(&random, ~seed);
+
+	Archived_Init(game.cube.apple);
+
+	if (memcmp(game.cube.map, Archived_Map(), sizeof(game.cube.map)) != 0) {
+		Diff_Report(seed, 0, inputs, &game, result, GAME_PLAYING);
+		return false;
+	}
+
+	while (result == GAME_PLAYING && tick < config->maxTicks) {
+		enum DirectionChange directionChange;
+		int size = game.snakes[0].size;
+
+		if (config->blind) {
+			directionChange = Random_Below(&random, CENTRE + 1);
+		} else {
+			directionChange = Policy_Choose(&policy, &game, &game.snakes[0]);
+		}
+		inputs[tick++] = directionChange;
+
+		result = Game_Step(&game, directionChange);
+
+		// Any apple eaten by game.c is replaced by the one it generated, which the archived core has to generate too
+		bool stepped = Archived_Step(directionChange, game.snakes[0].size != size ? game.cube.apple : ARCHIVED_NO_APPLE);
+		enum GameResult archivedResult = Diff_ArchivedResult(stepped, config->winLength);
+
+		// Which thing was hit is not known to the archived core, only that one was
+		bool sameResult = result == archivedResult || (archivedResult == GAME_HIT_WALL && result == GAME_HIT_SNAKE);
+
+		if (!sameResult || memcmp(game.cube.map, Archived_Map(), sizeof(game.cube.map)) != 0) {
+			Diff_Report(seed, tick, inputs, &game, result, archivedResult);
+			return false;
+		}
+	}
+
+	Archived_Free();
+
+	totals->games++;
+	totals->steps += tick;
+	totals->results[result]++;
+	return true;
+}
+
+/* Works out how the game stands in the archived core after a step, as its Game_Start did */
+enum GameResult Diff_ArchivedResult(bool stepped, int winLength) {
+	if (!stepped) {
+		return GAME_HIT_WALL;
+	}
+
+	if (Archived_Size() == winLength) {
+		return GAME_WON;
+	}
+
+	return GAME_PLAYING;
+}
+
+/* Prints where the two cores first differ, the inputs leading up to it and both maps */
+void Diff_Report(uint32_t seed, long tick, const enum DirectionChange* inputs, const struct GameState* game, enum GameResult result, enum GameResult archivedResult) {
+	const char* archivedMap = Archived_Map();
+	long first = tick > DIFF_SHOWN_INPUTS ? tick - DIFF_SHOWN_INPUTS : 0;
+
+	printf("DIVERGED: seed %lu, frame after tick %ld (ledCube: %s, archived: %s)\n", (unsigned long)seed, tick,
+		Diff_resultNames[result], archivedResult == GAME_HIT_WALL ? "hit something" : Diff_resultNames[archivedResult]);
+
+	printf("inputs of ticks %ld to %ld: ", first + 1, tick);
+	for (long i = first; i < tick; i++) {
+		putchar(Diff_inputLetters[inputs[i]]);
+	}
+	printf("\n");
+
+	// One layer of the cube after another, x across and y down, # being a lit cell
+	printf("z   ledCube  archived\n");
+	for (int z = 0; z < 8; z++) {
+		for (int y = 0; y < 8; y++) {
+			printf(y == 0 ? "%d   " : "    ", z);
+
+			for (int x = 0; x < 8; x++) {
+				putchar(game->cube.map[8 * y + x] & 1 << z ? '#' : '.');
+			}
+			printf(" ");
+			for (int x = 0; x < 8; x++) {
+				putchar(archivedMap[8 * y + x] & 1 << z ? '#' : '.');
+			}
+			printf("\n");
+		}
+	}
+
+	for (int i = 0; i < 64; i++) {
+		for (int z = 0; z < 8; z++) {
+			if ((game->cube.map[i] ^ archivedMap[i]) & 1 << z) {
+				printf("(%d, %d, %d) is %s in ledCube, %s in archived\n", i % 8, i / 8, z,
+					game->cube.map[i] & 1 << z ? "on" : "off", archivedMap[i] & 1 << z ? "on" : "off");
+			}
+		}
+	}
+
+	printf("run this game alone with -s %lu -n 1 and the same -p, -l and -t\n", (unsigned long)seed);
+}
+
+/* Gets a monotonic time in seconds */
+double Diff_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	struct Diff_Config config = { 10000, 1, false, POLICY_RANDOM, WIN_LENGTH, 10000 };
+	struct Diff_Totals totals;
+	int option;
+
+	while ((option = getopt(argc, argv, "n:s:p:l:t:")) != -1) {
+		switch (option) {
+			case 'n':
+				config.games = strtol(optarg, NULL, 0);
+				break;
+			case 's':
+				config.firstSeed = strtoul(optarg, NULL, 0);
+				break;
+			case 'p':
+				config.blind = strcmp(optarg, "blind") == 0;
+				if (!config.blind && !Policy_FromName(optarg, &config.kind)) {
+					fprintf(stderr, "unknown policy %s\n", optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'l':
+				config.winLength = strtol(optarg, NULL, 0);
+				break;
+			case 't':
+				config.maxTicks = strtol(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n GAMES] [-s SEED] [-p POLICY] [-l LENGTH] [-t TICKS]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	// The archived core looks for a free cell for the next apple forever, so the cube can never be full
+	if (config.games < 0 || config.maxTicks < 1 || config.winLength < 3 || config.winLength >= NUM_LEDS) {
+		fprintf(stderr, "need GAMES >= 0, TICKS >= 1 and 3 <= LENGTH < %d\n", NUM_LEDS);
+		return EXIT_FAILURE;
+	}
+
+	enum DirectionChange* inputs = malloc(config.maxTicks * sizeof(*inputs));
+	if (inputs == NULL) {
+		perror("malloc");
+		return EXIT_FAILURE;
+	}
+
+	memset(&totals, 0, sizeof(totals));
+	double start = Diff_Seconds();
+
+	for (long i = 0; i < config.games; i++) {
+		if (!Diff_Game(&config, config.firstSeed + i, inputs, &totals)) {
+			free(inputs);
+			return EXIT_FAILURE;
+		}
+	}
+
+	double seconds = Diff_Seconds() - start;
+
+	printf("%ld games, %ld steps in %.3f s", totals.games, totals.steps, seconds);
+	if (seconds > 0) {
+		printf(" (%.0f steps/s)", totals.steps / seconds);
+	}
+	printf("\n");
+	printf("won %ld, hit wall %ld, hit itself %ld, cut off %ld\n", totals.results[GAME_WON], totals.results[GAME_HIT_WALL],
+		totals.results[GAME_HIT_SNAKE], totals.results[GAME_PLAYING]);
+	printf("OK: every frame of every game the same in both cores\n");
+
+	free(inputs);
+	return EXIT_SUCCESS;
+}
+#else
+int main(void) {
+	fprintf(stderr, "the archived core only knows an 8x8x8 cube\n");
+	return EXIT_FAILURE;
+}
+#endif
@@ -0,0 +1,129 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "frame.h"
+
+#include <string.h>
+
+/* ENCODER FUNCTIONS */
+/* Get ready to send to a cube which starts off showing nothing in particular */
+void Frame_InitEncoder(struct Frame_Encoder* encoder, bool delta) {
+	memset(encoder->shown, 0, FRAME_MAP_SIZE);
+	encoder->delta = delta;
+	encoder->keyframeNeeded = true;
+	encoder->sinceKeyframe = 0;
+}
+
+/* Encode the frame which makes the cube show map into frame (which must hold FRAME_MAX_SIZE bytes) */
+/* dirty has bit i % 64 of word i / 64 set if column i may have changed since the last call (CUBE_DIRTY_WORDS words), */
+/* other columns are not looked at */
+/* Returns the number of bytes of the frame, which is 0 if there is nothing to send */
+int Frame_Encode(struct Frame_Encoder* encoder, const Cube_Column* map, const uint64_t* dirty, uint8_t* frame) {
+	if (!encoder->delta || encoder->keyframeNeeded || encoder->sinceKeyframe >= FRAME_KEYFRAME_INTERVAL) {
+		return Frame_EncodeFull(encoder, map, frame);
+	}
+
+	// Add a change for every dirty column which really differs from what the cube shows
+	int changes = 0;
+	for (int word = 0; word < CUBE_DIRTY_WORDS; word++) {
+		uint64_t columns = dirty[word];
+
+		while (columns != 0) {
+			int i = 64 * word + __builtin_ctzll(columns); // Index of lowest dirty column
+			columns &= columns - 1;
+
+			if (map[i] == encoder->shown[i]) {
+				continue;
+			}
+
+			// Too much has changed for a delta frame to be worth it
+			if (changes == FRAME_MAX_CHANGES) {
+				return Frame_EncodeFull(encoder, map, frame);
+			}
+
+			frame[1 + FRAME_CHANGE_SIZE * changes] = i;
+			memcpy(frame + 2 + FRAME_CHANGE_SIZE * changes, &map[i], CUBE_COLUMN_BYTES);
+			encoder->shown[i] = map[i];
+			changes++;
+		}
+	}
+
+	if (changes == 0) {
+		return 0;
+	}
+
+	frame[0] = FRAME_DELTA_START + changes;
+	encoder->sinceKeyframe++;
+
+	return 1 + FRAME_CHANGE_SIZE * changes;
+}
+
+/* Encode a full frame of map into frame, whatever the cube is showing */
+int Frame_EncodeFull(struct Frame_Encoder* encoder, const Cube_Column* map, uint8_t* frame) {
+	frame[0] = FRAME_START;
+	memcpy(frame + 1, map, FRAME_MAP_SIZE);
+
+	memcpy(encoder->shown, map, FRAME_MAP_SIZE);
+	encoder->keyframeNeeded = false;
+	encoder->sinceKeyframe = 0;
+
+	return FRAME_MAX_SIZE;
+}
+
+/* DECODER FUNCTIONS */
+/* Get ready to receive frames, showing nothing until the first one arrives */
+void Frame_InitDecoder(struct Frame_Decoder* decoder) {
+	memset(decoder->map, 0, FRAME_MAP_SIZE);
+	decoder->state = FRAME_WAITING;
+	decoder->length = 0;
+	decoder->received = 0;
+}
+
+/* Feed the next byte received over the link to the decoder */
+/* Returns true when it completes a frame, which has then been applied to decoder->map */
+bool Frame_Decode(struct Frame_Decoder* decoder, uint8_t byte) {
+	switch (decoder->state) {
+		case FRAME_WAITING:
+			// Anything other than the start of a frame is a leftover of a broken one
+			if (byte == FRAME_START) {
+				decoder->state = FRAME_FULL;
+				decoder->length = FRAME_MAP_SIZE;
+				decoder->received = 0;
+			} else if (byte > FRAME_DELTA_START && byte <= FRAME_DELTA_START + FRAME_MAX_CHANGES) {
+				decoder->state = FRAME_CHANGES;
+				decoder->length = FRAME_CHANGE_SIZE * (byte - FRAME_DELTA_START);
+				decoder->received = 0;
+			}
+
+			return false;
+		case FRAME_FULL:
+		case FRAME_CHANGES:
+			decoder->body[decoder->received++] = byte;
+			if (decoder->received < decoder->length) {
+				return false;
+			}
+
+			break;
+	}
+
+	// Frame is complete so apply it to the map
+	if (decoder->state == FRAME_FULL) {
+		memcpy(decoder->map, decoder->body, FRAME_MAP_SIZE);
+	} else {
+		// Check every column index first so that a broken frame changes nothing
+		// (on a 16x16x16 cube every byte is the index of a column)
+#if CUBE_COLUMNS < 256
+		for (int i = 0; i < decoder->length; i += FRAME_CHANGE_SIZE) {
+			if (decoder->body[i] >= CUBE_COLUMNS) {
+				decoder->state = FRAME_WAITING;
+				return false;
+			}
+		}
+#endif
+
+		for (int i = 0; i < decoder->length; i += FRAME_CHANGE_SIZE) {
+			memcpy(&decoder->map[decoder->body[i]], &decoder->body[i + 1], CUBE_COLUMN_BYTES);
+		}
+	}
+
+	decoder->state = FRAME_WAITING;
+	return true;
+}
@@ -0,0 +1,56 @@
+/* Encoding of the maps sent to the LED cube into frames, and decoding them again on the other side of the link */
+/* A full frame is FRAME_START followed by the 64 bytes of the map, which is all the stock cube firmware understands */
+/* A delta frame is FRAME_DELTA_START + n, followed by n pairs of (column index, column value) which changed */
+/* On cubes other than 8x8x8 (see cube.h) the map is CUBE_MAP_SIZE bytes and a column value is CUBE_COLUMN_BYTES */
+/* bytes, little endian */
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cube.h" // Needed for the size of a map
+
+/* DEFINING MACROS */
+#define FRAME_START 0xF2 // Byte sent before a full frame to asynchronously start data transmission
+#define FRAME_DELTA_START 0xC0 // Byte sent before a delta frame, with the number of changes in its low 5 bits
+#define FRAME_MAP_SIZE CUBE_MAP_SIZE // Number of bytes in a map (one per (x, y) column on an 8x8x8 cube)
+#define FRAME_MAX_SIZE (1 + FRAME_MAP_SIZE) // Size of a full frame, no frame is ever bigger
+#define FRAME_CHANGE_SIZE (1 + CUBE_COLUMN_BYTES) // Size of a change of a delta frame
+/* Most columns a delta frame can carry, which keeps it smaller than a full frame, 31 on an 8x8x8 cube */
+#define FRAME_MAX_CHANGES ((FRAME_MAP_SIZE - 1) / FRAME_CHANGE_SIZE < 31 ? (FRAME_MAP_SIZE - 1) / FRAME_CHANGE_SIZE : 31)
+#define FRAME_KEYFRAME_INTERVAL 64 // A full frame is sent at least this often so the cube recovers from lost bytes
+
+/* STRUCTS AND ENUMS */
+/* Sending side of the link */
+struct Frame_Encoder {
+	Cube_Column shown[CUBE_COLUMNS]; // What the cube shows once every frame sent so far has arrived
+	bool delta; // Whether the cube understands delta frames
+	bool keyframeNeeded; // Whether the next frame must be a full frame
+	int sinceKeyframe; // Number of frames sent since the last full frame
+};
+
+/* Where the decoder is within a frame */
+enum Frame_DecoderState {
+	FRAME_WAITING, // Waiting for the start of a frame
+	FRAME_FULL, // Reading the map of a full frame
+	FRAME_CHANGES, // Reading the changes of a delta frame
+};
+
+/* Receiving side of the link, a reference for what the cube firmware has to do */
+struct Frame_Decoder {
+	Cube_Column map[CUBE_COLUMNS]; // What the cube shows
+	uint8_t body[FRAME_MAP_SIZE]; // Frame being received, applied to map once it is complete
+	enum Frame_DecoderState state;
+	int length; // Number of bytes of body expected
+	int received; // Number of bytes of body received so far
+};
+
+/* FUNCTION DECLARATIONS */
+void Frame_InitEncoder(struct Frame_Encoder* encoder, bool delta);
+int Frame_Encode(struct Frame_Encoder* encoder, const Cube_Column* map, const uint64_t* dirty, uint8_t* frame);
+int Frame_EncodeFull(struct Frame_Encoder* encoder, const Cube_Column* map, uint8_t* frame);
+void Frame_InitDecoder(struct Frame_Decoder* decoder);
+bool Frame_Decode(struct Frame_Decoder* decoder, uint8_t byte);
+
+#endif
@@ -0,0 +1,168 @@
+/* Host tool decoding the byte stream sent to the cube, as recorded by the host build in LEDCUBE_FRAMES */
+/* Usage: frameDecode [-p] STREAM   decode STREAM like the cube would, -p prints every map it shows
+ *        frameDecode -r STREAM     round trip every map of STREAM through the delta encoder and decoder, checking
+ *                                  the cube ends up showing the same maps, and report how many bytes that saves */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+/* FUNCTION DECLARATIONS */
+void Decode_PrintMap(const Cube_Column* map);
+int Decode_Stream(FILE* stream, bool print);
+int Decode_RoundTrip(FILE* stream);
+void Decode_ChangedColumns(const Cube_Column* before, const Cube_Column* after, uint64_t* changed);
+
+/* DECODE FUNCTIONS */
+/* Prints map as its z layers side by side, with y going down the page and x across */
+void Decode_PrintMap(const Cube_Column* map) {
+	for (int y = CUBE_SIZE - 1; y >= 0; y--) {
+		for (int z = 0; z < CUBE_SIZE; z++) {
+			for (int x = 0; x < CUBE_SIZE; x++) {
+				putchar(map[CUBE_COLUMN_INDEX(x, y)] & 1 << z ? '#' : '.');
+			}
+			putchar(z < CUBE_SIZE - 1 ? ' ' : '\n');
+		}
+	}
+	putchar('\n');
+}
+
+/* Decodes every frame of stream, printing the maps shown if asked to */
+int Decode_Stream(FILE* stream, bool print) {
+	struct Frame_Decoder decoder;
+	long bytes = 0;
+	long frames = 0;
+	int byte;
+
+	Frame_InitDecoder(&decoder);
+
+	while ((byte = fgetc(stream)) != EOF) {
+		bytes++;
+
+		if (Frame_Decode(&decoder, byte)) {
+			frames++;
+
+			if (print) {
+				Decode_PrintMap(decoder.map);
+			}
+		}
+	}
+
+	printf("%ld frames in %ld bytes", frames, bytes);
+	if (decoder.state != FRAME_WAITING) {
+		printf(", stream ends part way through a frame");
+	}
+	printf("\n");
+
+	return EXIT_SUCCESS;
+}
+
+/* Decodes every frame of stream and sends the maps shown through the delta encoder and a second decoder */
+/* Returns EXIT_FAILURE if the second decoder ever shows something different */
+int Decode_RoundTrip(FILE* stream) {
+	struct Frame_Decoder original;
+	struct Frame_Decoder roundTrip;
+	struct Frame_Encoder encoder;
+	Cube_Column previous[CUBE_COLUMNS];
+	uint64_t changed[CUBE_DIRTY_WORDS];
+	uint8_t frame[FRAME_MAX_SIZE];
+	long frames = 0;
+	long originalBytes = 0;
+	long deltaBytes = 0;
+	long deltaFrames = 0;
+	int byte;
+
+	Frame_InitDecoder(&original);
+	Frame_InitDecoder(&roundTrip);
+	Frame_InitEncoder(&encoder, true);
+	memset(previous, 0, FRAME_MAP_SIZE);
+
+	while ((byte = fgetc(stream)) != EOF) {
+		originalBytes++;
+
+		if (!Frame_Decode(&original, byte)) {
+			continue;
+		}
+
+		// Only the columns which really changed are marked dirty, like the dirty columns of the cube in the game
+		Decode_ChangedColumns(previous, original.map, changed);
+		int length = Frame_Encode(&encoder, original.map, changed, frame);
+		memcpy(previous, original.map, FRAME_MAP_SIZE);
+		frames++;
+		deltaBytes += length;
+		deltaFrames += length > 0 && frame[0] != FRAME_START;
+
+		for (int i = 0; i < length; i++) {
+			Frame_Decode(&roundTrip, frame[i]);
+		}
+
+		if (memcmp(original.map, roundTrip.map, FRAME_MAP_SIZE) != 0) {
+			printf("frame %ld differs after round trip\nexpected:\n", frames);
+			Decode_PrintMap(original.map);
+			printf("got:\n");
+			Decode_PrintMap(roundTrip.map);
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("%ld frames round tripped, %ld of them as delta frames\n", frames, deltaFrames);
+	printf("%ld bytes as recorded, %ld bytes with delta frames", originalBytes, deltaBytes);
+	if (deltaBytes > 0) {
+		printf(" (%.1fx smaller)", (double)originalBytes / deltaBytes);
+	}
+	printf("\n");
+
+	return EXIT_SUCCESS;
+}
+
+/* Gets the dirty mask (CUBE_DIRTY_WORDS words) of the columns which differ between two maps */
+void Decode_ChangedColumns(const Cube_Column* before, const Cube_Column* after, uint64_t* changed) {
+	memset(changed, 0, CUBE_DIRTY_WORDS * sizeof(*changed));
+
+	for (int i = 0; i < CUBE_COLUMNS; i++) {
+		if (before[i] != after[i]) {
+			changed[i / 64] |= (uint64_t)1 << i % 64;
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	bool print = false;
+	bool roundTrip = false;
+	int option;
+
+	while ((option = getopt(argc, argv, "pr")) != -1) {
+		switch (option) {
+			case 'p':
+				print = true;
+				break;
+			case 'r':
+				roundTrip = true;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-p | -r] STREAM\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1) {
+		fprintf(stderr, "usage: %s [-p | -r] STREAM\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE* stream = fopen(argv[optind], "rb");
+	if (stream == NULL) {
+		perror(argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	int result = roundTrip ? Decode_RoundTrip(stream) : Decode_Stream(stream, print);
+	fclose(stream);
+
+	return result;
+}
@@ -0,0 +1,373 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "bitboard.h" // Needed to check whether a position is inside the cube in one go
+#include "profile.h" // Needed to time apple generation when profiling
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* GLOBAL VARIABLES */
+/* Direction a snake goes in after each direction change (in the order of enum DirectionChange), by its direction before */
+/* Going along x or y, LEFT and RIGHT turn a quarter either way within the layer. Going along z they go to -y and +y */
+/* UP and DOWN go inwards and outwards, except back the way the snake came. CENTRE carries straight on */
+const uint8_t Snake_turns[DIRECTIONS][CENTRE + 1] = {
+	/*                      RIGHT              LEFT               UP                 DOWN               CENTRE */
+	[DIRECTION_PLUS_X] = {  DIRECTION_PLUS_Y,  DIRECTION_MINUS_Y, DIRECTION_PLUS_Z,  DIRECTION_MINUS_Z, DIRECTION_PLUS_X },
+	[DIRECTION_MINUS_X] = { DIRECTION_MINUS_Y, DIRECTION_PLUS_Y,  DIRECTION_PLUS_Z,  DIRECTION_MINUS_Z, DIRECTION_MINUS_X },
+	[DIRECTION_PLUS_Y] = {  DIRECTION_MINUS_X, DIRECTION_PLUS_X,  DIRECTION_PLUS_Z,  DIRECTION_MINUS_Z, DIRECTION_PLUS_Y },
+	[DIRECTION_MINUS_Y] = { DIRECTION_PLUS_X,  DIRECTION_MINUS_X, DIRECTION_PLUS_Z,  DIRECTION_MINUS_Z, DIRECTION_MINUS_Y },
+	[DIRECTION_PLUS_Z] = {  DIRECTION_PLUS_Y,  DIRECTION_MINUS_Y, DIRECTION_PLUS_Z,  DIRECTION_PLUS_Z,  DIRECTION_PLUS_Z },
+	[DIRECTION_MINUS_Z] = { DIRECTION_PLUS_Y,  DIRECTION_MINUS_Y, DIRECTION_MINUS_Z, DIRECTION_MINUS_Z, DIRECTION_MINUS_Z },
+};
+
+/* Step in (x, y, z) of each direction */
+const int8_t Snake_steps[DIRECTIONS][3] = {
+	[DIRECTION_PLUS_X] = { 1, 0, 0 },
+	[DIRECTION_MINUS_X] = { -1, 0, 0 },
+	[DIRECTION_PLUS_Y] = { 0, 1, 0 },
+	[DIRECTION_MINUS_Y] = { 0, -1, 0 },
+	[DIRECTION_PLUS_Z] = { 0, 0, 1 },
+	[DIRECTION_MINUS_Z] = { 0, 0, -1 },
+};
+
+/* GAME FUNCTIONS */
+/* Sets up a new game with one snake, with apples placed according to seed */
+void Game_Init(struct GameState* game, uint32_t seed) {
+	Game_InitPlayers(game, seed, 1);
+}
+
+/* Sets up a new game with a snake for each of the given number of players (at most GAME_MAX_SNAKES) */
+void Game_InitPlayers(struct GameState* game, uint32_t seed, int players) {
+	game->snakeCount = players;
+	game->winLength = WIN_LENGTH;
+	game->collision = EMPTY;
+
+	// Start from an empty cube
+	Cube_Clear(game);
+	Random_Seed(&game->cube.random, seed);
+
+	for (int i = 0; i < players; i++) {
+		struct Snake* snake = &game->snakes[i];
+
+		// Every snake starts off going in the x direction
+		snake->direction = DIRECTION_PLUS_X;
+		snake->result = GAME_PLAYING;
+
+		// Initialize snake such that its tail is at its start position, (0, 5, 5) for the first one on an 8x8x8 cube
+		// And its head is one step in the current direction
+		Snake_Init(game, snake, SNAKE_START_X, (SNAKE_START_Y + 2 * i) % CUBE_SIZE, SNAKE_START_Z);
+	}
+
+	// Only once every snake is on the cube, so the apple is never where a snake starts
+	Cube_GenerateApple(game);
+}
+
+/* Runs one step of a game with one snake with the given direction change, returns how the game stands afterwards */
+enum GameResult Game_Step(struct GameState* game, enum DirectionChange directionChange) {
+	return Game_StepPlayers(game, &directionChange);
+}
+
+/* Runs one step of the game, moving every snake still playing with the direction change of its player */
+/* Returns GAME_WON as soon as a snake wins, GAME_PLAYING while any snake is still playing, and otherwise what */
+/* the last snake to run into something hit. How each snake stands is in its result. Not to be called again once */
+/* it has returned anything but GAME_PLAYING */
+enum GameResult Game_StepPlayers(struct GameState* game, const enum DirectionChange* directionChanges) {
+	enum GameResult result = GAME_PLAYING;
+	bool playing = false;
+
+	for (int i = 0; i < game->snakeCount; i++) {
+		struct Snake* snake = &game->snakes[i];
+
+		if (snake->result != GAME_PLAYING) {
+			continue;
+		}
+
+		Snake_Turn(snake, directionChanges[i]); // Turn (or continue forwards) snake
+
+		// Try and move the snake in its current direction, otherwise it is out
+		if (!Snake_Step(game, snake)) {
+			snake->result = game->collision == WALL ? GAME_HIT_WALL : GAME_HIT_SNAKE;
+			result = snake->result;
+			continue;
+		}
+
+		// If win condition is met (snake length is at winLength, or it fills the whole cube)
+		if (snake->size == game->winLength || snake->size == NUM_LEDS) {
+			snake->result = GAME_WON;
+			return GAME_WON;
+		}
+
+		playing = true;
+	}
+
+	return playing ? GAME_PLAYING : result;
+}
+
+/* CUBE FUNCTIONS */
+/* Sets bit corresponding to x, y, z position */
+void Cube_SetBitAt(struct GameState* game, int x, int y, int z) {
+	struct Cube* cube = &game->cube;
+	int i = CUBE_COLUMN_INDEX(x, y);
+
+	// Cell is no longer free if it was off
+	if (!(cube->map[i] & 1 << z)) {
+		Cube_RemoveFreeCell(game, CELL_INDEX(x, y, z));
+	}
+
+	cube->dirty[i / 64] |= (uint64_t)1 << i % 64;
+
+	cube->map[i] = cube->map[i] | 1 << z;
+}
+
+/* Clears bit corresponding to x, y, z position */
+void Cube_ClearBitAt(struct GameState* game, int x, int y, int z) {
+	struct Cube* cube = &game->cube;
+	int i = CUBE_COLUMN_INDEX(x, y);
+
+	// Cell becomes free if it was on
+	if (cube->map[i] & 1 << z) {
+		Cube_AddFreeCell(game, CELL_INDEX(x, y, z));
+	}
+
+	cube->dirty[i / 64] |= (uint64_t)1 << i % 64;
+
+	cube->map[i] = cube->map[i] & ~(1 << z);
+}
+
+/* Gets bit corresponding to x, y, z position */
+bool Cube_IsBitOnAt(const struct GameState* game, int x, int y, int z) {
+	int i = CUBE_COLUMN_INDEX(x, y);
+	return game->cube.map[i] & 1 << z;
+}
+
+/* Generates an apple on a random non-snake position on the map */
+/* Returns false if there is no space left for one */
+bool Cube_GenerateApple(struct GameState* game) {
+	struct Cube* cube = &game->cube;
+
+	if (cube->freeCount == 0) {
+		cube->apple = NO_APPLE;
+		return false;
+	}
+
+	// Pick a uniformly random entry of the list of cells which are off
+	uint16_t cell = cube->freeCells[Random_Below(&cube->random, cube->freeCount)];
+
+	// Set the bit at the chosen position
+	Cube_SetBitAt(game, CELL_X(cell), CELL_Y(cell), CELL_Z(cell));
+	cube->apple = cell;
+	return true;
+}
+
+/* Checks if a position on the map is a segment of any snake */
+bool Cube_IsSnakeSegment(const struct GameState* game, int x, int y, int z) {
+	int i = CUBE_COLUMN_INDEX(x, y);
+	return game->cube.occupied[i] & 1 << z;
+}
+
+/* Gets cell state (WALL, SNAKE, APPLE, EMPTY) of position */
+enum CellState Cube_GetCellStateAt(const struct GameState* game, int x, int y, int z) {
+	// Check if given position is within valid bounds of the cube, all three dimensions at once if it can be
+	if (!Bitboard_Inside(x, y, z)) {
+		return WALL;
+	}
+
+	// Check if given position corresponds to a snake segment or an apple
+	// Any lit cell which is not part of a snake is the apple
+	if (Cube_IsSnakeSegment(game, x, y, z)) {
+		return SNAKE;
+	}
+
+	if (Cube_IsBitOnAt(game, x, y, z)) {
+		return APPLE;
+	}
+
+	// None of previous conditions were met so given position corresponds to an empty cell
+	return EMPTY;
+}
+
+void Cube_SetAll(struct GameState* game) {
+	// Set all cells to ON in the cube map
+	// Goes through Cube_SetBitAt and Cube_ClearBitAt so that the free cell list stays valid
+	for (int y = 0; y < CUBE_SIZE; y++) {
+		for (int x = 0; x < CUBE_SIZE; x++) {
+			Cube_SetBitAt(game, x, y, 0);
+
+			for (int z = 1; z < CUBE_SIZE; z++) {
+				Cube_ClearBitAt(game, x, y, z);
+			}
+		}
+	}
+}
+
+/* Turns every cell off and marks them all as free */
+void Cube_Clear(struct GameState* game) {
+	struct Cube* cube = &game->cube;
+
+	for (int i = 0; i < CUBE_COLUMNS; i++) {
+		cube->map[i] = 0;
+		cube->occupied[i] = 0;
+	}
+	for (int i = 0; i < CUBE_DIRTY_WORDS; i++) {
+		cube->dirty[i] = ~(uint64_t)0;
+	}
+	cube->apple = NO_APPLE;
+
+	cube->freeCount = 0;
+	for (int cell = 0; cell < NUM_LEDS; cell++) {
+		Cube_AddFreeCell(game, cell);
+	}
+}
+
+/* Adds cell to the end of the free cell list */
+void Cube_AddFreeCell(struct GameState* game, uint16_t cell) {
+	struct Cube* cube = &game->cube;
+
+	cube->freeCells[cube->freeCount] = cell;
+	cube->freeSlot[cell] = cube->freeCount;
+	cube->freeCount++;
+}
+
+/* Removes cell from the free cell list by moving the last entry into its place */
+void Cube_RemoveFreeCell(struct GameState* game, uint16_t cell) {
+	struct Cube* cube = &game->cube;
+	uint16_t slot = cube->freeSlot[cell];
+	uint16_t last = cube->freeCells[cube->freeCount - 1];
+
+	cube->freeCells[slot] = last;
+	cube->freeSlot[last] = slot;
+	cube->freeCount--;
+}
+
+/* SNAKE FUNCTIONS*/
+/* Initializes ring buffer representing snake with its tail at given position */
+/* And its head the position it is facing with its current direction */
+void Snake_Init(struct GameState* game, struct Snake* snake, int x, int y, int z) {
+	// Both ends of the snake start at the first entry of the ring buffer
+	snake->head = 0;
+	snake->tail = 0;
+	snake->body[snake->head] = CELL_INDEX(x, y, z);
+
+	// Set bit on map and occupancy bitmap corresponding to position
+	Cube_SetBitAt(game, x, y, z);
+	Snake_SetBitAt(game, x, y, z);
+
+	// Initialize size as 1
+	snake->size = 1;
+
+	// Move the snake once in its current direction as if it ate an apple, so that it starts at a length of 2
+	// The apple is left to Game_InitPlayers
+	const int8_t* step = Snake_steps[snake->direction];
+	int newX = x + step[0];
+	int newY = y + step[1];
+	int newZ = z + step[2];
+	Snake_AddHead(game, snake, newX, newY, newZ);
+	snake->size++;
+}
+
+/* Add head of ring buffer representing snake at the given position */
+void Snake_AddHead(struct GameState* game, struct Snake* snake, int x, int y, int z) {
+	// Change the map and occupancy bitmap accordingly
+	Cube_SetBitAt(game, x, y, z);
+	Snake_SetBitAt(game, x, y, z);
+
+	// Store the new head in the entry after the current head
+	snake->head = (snake->head + 1) % NUM_LEDS;
+	snake->body[snake->head] = CELL_INDEX(x, y, z);
+}
+
+/* Pop tail of ring buffer representing snake */
+void Snake_PopTail(struct GameState* game, struct Snake* snake) {
+	uint16_t tail = snake->body[snake->tail];
+
+	// Clear bits accordingly
+	Cube_ClearBitAt(game, CELL_X(tail), CELL_Y(tail), CELL_Z(tail));
+	Snake_ClearBitAt(game, CELL_X(tail), CELL_Y(tail), CELL_Z(tail));
+
+	// Set tail to be second last segment
+	snake->tail = (snake->tail + 1) % NUM_LEDS;
+}
+
+/* Called when snake takes a normal step with the new head assumed to be at the given position*/
+void Snake_NormalStep(struct GameState* game, struct Snake* snake, int x, int y, int z) {
+	// When a normal step is taken, we insert the new head and pop the current tail
+	Snake_AddHead(game, snake, x, y, z);
+	Snake_PopTail(game, snake);
+}
+
+/* Called when snake eats an apple with the new head assumed to be at the given position */
+void Snake_AppleStep(struct GameState* game, struct Snake* snake, int x, int y, int z) {
+	// When snake eats an apple, its size increases by one and we insert a new head
+	Snake_AddHead(game, snake, x, y, z);
+	snake->size++;
+
+	// Generate an apple
+	PROFILE_BEGIN(appleStart);
+	Cube_GenerateApple(game);
+	PROFILE_END(PROFILE_APPLE, appleStart);
+}
+
+/* Change the current direction of the snake depending on directionChange */
+void Snake_Turn(struct Snake* snake, enum DirectionChange directionChange) {
+	snake->direction = Snake_turns[snake->direction][directionChange];
+}
+
+/* Gets the direction after directionChange */
+/* Works on any direction so that controllers can look ahead at where a turn would take the snake */
+enum Direction Snake_TurnDirection(enum Direction direction, enum DirectionChange directionChange) {
+	return Snake_turns[direction][directionChange];
+}
+
+/* Gets the step in (x, y, z) of a direction */
+const int8_t* Snake_StepOf(enum Direction direction) {
+	return Snake_steps[direction];
+}
+
+/* Try and move one step in the current direction */
+/* Return whether it succeeded, if not game->collision says what was in the way */
+bool Snake_Step(struct GameState* game, struct Snake* snake) {
+	// New position head of snake will be trying to go to
+	uint16_t head = snake->body[snake->head];
+	const int8_t* step = Snake_steps[snake->direction];
+	int newX = CELL_X(head) + step[0];
+	int newY = CELL_Y(head) + step[1];
+	int newZ = CELL_Z(head) + step[2];
+
+	// Get the state of the cell and handle appropriately
+	enum CellState cellState = Cube_GetCellStateAt(game, newX, newY, newZ);
+	switch (cellState) {
+		case (WALL):
+		case (SNAKE):
+			game->collision = cellState;
+			return false;
+			break;
+		case (APPLE):
+			Snake_AppleStep(game, snake, newX, newY, newZ);
+			break;
+		case (EMPTY):
+			Snake_NormalStep(game, snake, newX, newY, newZ);
+			break;
+	}
+
+	return true;
+}
+
+/* Marks position as occupied by a snake in the occupancy bitmap of the cube */
+void Snake_SetBitAt(struct GameState* game, int x, int y, int z) {
+	int i = CUBE_COLUMN_INDEX(x, y);
+	game->cube.occupied[i] = game->cube.occupied[i] | 1 << z;
+}
+
+/* Marks position as no longer occupied by a snake in the occupancy bitmap of the cube */
+void Snake_ClearBitAt(struct GameState* game, int x, int y, int z) {
+	int i = CUBE_COLUMN_INDEX(x, y);
+	game->cube.occupied[i] = game->cube.occupied[i] & ~(1 << z);
+}
+
+// Empty the ring buffer representing the snake at the end
+void Snake_Free(struct Snake* snake) {
+	// Nothing was allocated, so forgetting the segments is all there is to do
+	snake->head = 0;
+	snake->tail = 0;
+	snake->size = 0;
+}
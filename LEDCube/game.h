@@ -0,0 +1,137 @@
+/* Logic of the snake game, independent of the hardware it is shown on */
+/* All of the state of a game lives in a struct GameState, so any number of games can be played side by side */
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cube.h" // Needed for the size of the cube
+#include "random.h" // Needed to place apples randomly
+#include "joystick.h" // Needed for the direction changes steering the snake
+
+/* DEFINING MACROS */
+/* Cubes with fewer cells than twice the usual winning length are won at half full */
+#define WIN_LENGTH (NUM_LEDS < 200 ? NUM_LEDS / 2 : 100)
+
+/* Where the tail of the first snake starts, (0, 5, 5) on an 8x8x8 cube */
+/* Every other snake starts two rows of y further on, wrapping round, so they all start on rows of their own */
+#define SNAKE_START_X 0
+#define SNAKE_START_Y (5 * CUBE_SIZE / 8)
+#define SNAKE_START_Z (5 * CUBE_SIZE / 8)
+
+/* Most snakes a game can have, each player steering one. Only CUBE_SIZE / 2 rows are two apart, so no more than */
+/* that fit. Every snake takes room for a body of NUM_LEDS cells, so builds can lower this to save RAM */
+#ifndef GAME_MAX_SNAKES
+#define GAME_MAX_SNAKES (CUBE_SIZE / 2 < 4 ? CUBE_SIZE / 2 : 4)
+#endif
+
+#define NO_APPLE -1
+
+/* STRUCTS AND ENUMS */
+enum CellState { EMPTY, APPLE, SNAKE, WALL };
+
+/* Outcome of a step of the game */
+enum GameResult {
+	GAME_PLAYING, // Game carries on
+	GAME_WON, // Snake reached the winning length (or filled the whole cube)
+	GAME_HIT_WALL, // Snake tried to leave the cube
+	GAME_HIT_SNAKE, // Snake ran into itself or another snake
+};
+
+/* One of the 6 directions a snake can go in, as an index into the turn and step tables of game.c */
+/* In the order of enum Bitboard_Direction, so a direction is also the bit of that neighbour in Bitboard_FreeNeighbours */
+enum Direction {
+	DIRECTION_PLUS_X,
+	DIRECTION_MINUS_X,
+	DIRECTION_PLUS_Y,
+	DIRECTION_MINUS_Y,
+	DIRECTION_PLUS_Z, // Inwards, where UP goes
+	DIRECTION_MINUS_Z, // Outwards, where DOWN goes
+	DIRECTIONS,
+};
+
+/* Representation of the cube */
+struct Cube {
+	/* This array is a representation of the cube and is rendered */
+	Cube_Column map[CUBE_COLUMNS];
+
+	/* Occupancy bitmap of every snake, laid out like map but without the apple */
+	/* So whether a lit cell is part of a snake is a single bit test */
+	Cube_Column occupied[CUBE_COLUMNS];
+
+	/* Columns of map (bit i % 64 of word i / 64 for map[i]) which may have changed since it was last rendered */
+	uint64_t dirty[CUBE_DIRTY_WORDS];
+
+	/* List of the cells which are off in map, in no particular order, and where each cell is in that list */
+	/* Lets a random empty cell be picked in constant time however full the cube is */
+	uint16_t freeCells[NUM_LEDS];
+	uint16_t freeSlot[NUM_LEDS];
+	int freeCount;
+
+	/* Cell index of the apple, or NO_APPLE */
+	int apple;
+
+	/* Random numbers used to place apples */
+	struct Random random;
+};
+
+/* Representation of the snake */
+struct Snake {
+	/* Ring buffer holding the packed position of every segment, running from tail up to head */
+	/* The snake can never be longer than the number of cells, so it is never full */
+	int size;
+	uint16_t body[NUM_LEDS];
+	unsigned int head;
+	unsigned int tail;
+
+	/* Current direction of snake */
+	enum Direction direction;
+
+	/* GAME_PLAYING until the snake wins or runs into something, after which it no longer moves */
+	/* A snake which ran into something stays where it is, in the way of the others */
+	enum GameResult result;
+};
+
+/* Everything about one game */
+/* Snakes move one after the other in the order of snakes, so when two go for the same cell the first one gets it */
+struct GameState {
+	struct Cube cube;
+	struct Snake snakes[GAME_MAX_SNAKES];
+	int snakeCount;
+
+	int winLength; // Length a snake wins at, WIN_LENGTH unless changed after Game_Init
+	enum CellState collision; // What the snake ran into when Snake_Step last failed
+};
+
+/* FUNCTION DECLARATIONS */
+void Game_Init(struct GameState* game, uint32_t seed);
+void Game_InitPlayers(struct GameState* game, uint32_t seed, int players);
+enum GameResult Game_Step(struct GameState* game, enum DirectionChange directionChange);
+enum GameResult Game_StepPlayers(struct GameState* game, const enum DirectionChange* directionChanges);
+
+void Cube_SetBitAt(struct GameState* game, int x, int y, int z);
+void Cube_ClearBitAt(struct GameState* game, int x, int y, int z);
+bool Cube_IsBitOnAt(const struct GameState* game, int x, int y, int z);
+bool Cube_GenerateApple(struct GameState* game);
+enum CellState Cube_GetCellStateAt(const struct GameState* game, int x, int y, int z);
+bool Cube_IsSnakeSegment(const struct GameState* game, int x, int y, int z);
+void Cube_SetAll(struct GameState* game);
+void Cube_Clear(struct GameState* game);
+void Cube_AddFreeCell(struct GameState* game, uint16_t cell);
+void Cube_RemoveFreeCell(struct GameState* game, uint16_t cell);
+
+void Snake_Init(struct GameState* game, struct Snake* snake, int x, int y, int z);
+void Snake_Turn(struct Snake* snake, enum DirectionChange directionChange);
+enum Direction Snake_TurnDirection(enum Direction direction, enum DirectionChange directionChange);
+const int8_t* Snake_StepOf(enum Direction direction);
+bool Snake_Step(struct GameState* game, struct Snake* snake);
+void Snake_Free(struct Snake* snake);
+void Snake_AddHead(struct GameState* game, struct Snake* snake, int x, int y, int z);
+void Snake_PopTail(struct GameState* game, struct Snake* snake);
+void Snake_NormalStep(struct GameState* game, struct Snake* snake, int x, int y, int z);
+void Snake_AppleStep(struct GameState* game, struct Snake* snake, int x, int y, int z);
+void Snake_SetBitAt(struct GameState* game, int x, int y, int z);
+void Snake_ClearBitAt(struct GameState* game, int x, int y, int z);
+
+#endif
@@ -0,0 +1,46 @@
+/* Interface between the game logic and the hardware it is running on */
+/* Implemented by hardwareStm32.c for the STM32F303 (libopencm3) and by hardwareHost.c for a native Linux build */
+#ifndef HARDWARE_H
+#define HARDWARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "frame.h" // Needed for the size of the frames sent to the cube
+#include "joystick.h" // Needed for the direction changes read from the joystick
+#include "stream.h" // Needed for the ring the bytes streamed from a PC go into
+
+/* DEFINING MACROS */
+/* Most cubes (each on a USART of its own) and players (each with a joystick of their own) one board can have */
+#define HARDWARE_MAX_CUBES 3
+#define HARDWARE_MAX_PLAYERS 3
+
+/* FUNCTION DECLARATIONS */
+void Hardware_Setup(int cubes, int players);
+int Hardware_ReadChannel(int channel);
+enum DirectionChange Hardware_ReadJoystick(int player);
+bool Hardware_CubeReady(int cube);
+bool Hardware_KeyframeNeeded(int cube);
+uint32_t Hardware_FrameMicros(int cube, int length);
+void Hardware_SendFrame(int cube, const uint8_t* frame, int length);
+void Hardware_FlushCubes(void);
+uint32_t Hardware_GetSeed(void);
+uint32_t Hardware_GetMillis(void);
+void Hardware_SleepUntil(uint32_t millis);
+void Hardware_SaveRecording(const uint8_t* log, int length);
+
+/* Idle state between games, which a joystick being pushed wakes the board from */
+bool Hardware_StartIdle(void);
+bool Hardware_SleepUntilWoken(uint32_t millis);
+void Hardware_StopIdle(void);
+
+/* Only used with STREAM=1, see stream.h */
+struct Stream_Ring* Hardware_OpenStream(void);
+bool Hardware_WaitForStream(uint32_t available);
+void Hardware_SendToHost(const uint8_t* bytes, int length);
+
+/* Only built with PROFILE=1, see profile.h */
+bool Hardware_StatsRequested(void);
+void Hardware_SendStats(const uint8_t* record, int length);
+
+#endif
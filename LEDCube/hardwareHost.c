@@ -0,0 +1,1113 @@
+/* Native Linux implementation of hardware.h so the game logic can be run, profiled and load tested on a dev box */
+/* Behaviour is configured through the following environment variables:
+ *   LEDCUBE_JOYSTICK - file of scripted joystick samples, one per tick of the game, either two raw ADC values
+ *                      ("<channel1> <channel2>") or one of the letters L, R, U, D, C. Lines starting with # are ignored
+ *                      With several players, a colon separated list of files for the players in turn
+ *                      When not given (or once the script runs out) samples are generated synthetically
+ *   LEDCUBE_SEED     - seed of the synthetic joystick source and of the apple positions of the first game, each game
+ *                      after it (see LEDCUBE_GAMES) going on to the next seeds
+ *   LEDCUBE_FRAMES   - file every frame sent to the cube is appended to, exactly as the bytes would be sent over USART
+ *                      With several cubes, the frames of cube N other than the first go to this name followed by .N
+ *   LEDCUBE_BAUD     - when given, frames are sent by a thread for each cube which takes as long as a USART at this
+ *                      baud rate would, like the DMA transmission on the STM32. Otherwise frames are recorded straight away
+ *   LEDCUBE_LINK     - "loopback" connects every link to a stand-in for the cube firmware over a socketpair, which
+ *                      runs the handshake of link.h and checks the packets. Frames are then sent at the negotiated baud
+ *                      rate (LEDCUBE_BAUD is ignored) and LEDCUBE_FRAMES still gets the bare frames. Tuned by:
+ *     LEDCUBE_LINK_CUBE_BAUD - fastest baud rate the stand-in can do (3000000), 0 for a stock cube which never answers
+ *     LEDCUBE_LINK_LINE_BAUD - fastest baud rate the wire carries (3000000), any byte sent faster arrives garbled
+ *     LEDCUBE_LINK_ERRORS    - chance of a bit of each byte of a packet being flipped on the way to the cube (0)
+ *     LEDCUBE_LINK_RX        - how the controller takes what the cube sends back. Its USART holds one unread byte, and
+ *                              any which come in before that is read are lost as they are on the board. "interrupt"
+ *                              (the default) takes each byte as it comes in, as the RX interrupts of the board do.
+ *                              "poll" only reads the USART once a tick, losing all but the first byte of a LINK_NAK
+ *   LEDCUBE_STREAM   - when built with STREAM=1, Unix socket the board listens on for ledCubeStream, standing in for the
+ *                      USART the PC streams frames over. A thread takes the place of its RX interrupt, dropping bytes
+ *                      which do not fit in the ring as the USART would. The board stops once ledCubeStream has gone
+ *   LEDCUBE_CLOCK    - "virtual" makes sleeping instant by moving a simulated clock on instead, so games run as fast as
+ *                      the game logic allows whilst still seeing the same times. Otherwise the monotonic clock is used
+ *   LEDCUBE_GAMES    - number of games played one after another (1). In between the board idles until a joystick is
+ *                      pushed, each sleep taking the next sample of every player (scripted or synthetic) and waking if
+ *                      any is outside JOYSTICK_LOW to JOYSTICK_HIGH, as the analog watchdog would. Once every game has
+ *                      been played nothing pushes one any more, so the board stops
+ *   LEDCUBE_RECORD   - file the recording of the game is written to when it ends, for replaying with ledCubeReplay
+ *   LEDCUBE_STATS    - when built with PROFILE=1, file the stats records are appended to. One is written at the end of
+ *                      every game, and one whenever the process gets SIGUSR1 (standing in for PROFILE_REQUEST) */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "hardware.h"
+#include "profile.h"
+#include "link.h"
+#include "random.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* DEFINING MACROS */
+#define ADC_MAX 4095 // Largest value a 12 bit conversion can return
+#define ADC_CENTRE JOYSTICK_CENTRE // Value read on a joystick channel at rest
+#define NUM_CHANNELS 3 // Joystick uses ADC channels 1 and 2
+#define BITS_PER_BYTE 10 // 8N1 sends a start and a stop bit with every byte
+
+#define NO_FRAME -1
+
+#define MAX_PATH 4096
+
+#define WIRE_CLOSED -2 // What Hardware_WireReceive returns once the other end has gone
+
+/* STRUCTS AND ENUMS */
+/* Joystick of one player, and where its samples come from */
+struct Hardware_Player {
+	FILE* script;
+	uint32_t syntheticState;
+	int sample[NUM_CHANNELS]; // Latest sample
+	struct Joystick joystick; // Filter the samples go through
+};
+
+/* Link to one cube, mirroring the double buffered DMA transmission of hardwareStm32.c when simulated */
+struct Hardware_Link {
+	FILE* sink;
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	uint8_t frames[2][LINK_MAX_PACKET_SIZE];
+	int frameLengths[2];
+	int sendingFrame;
+	int queuedFrame;
+	long byteNanoseconds;
+	unsigned long framesQueued;
+	unsigned long framesWaited;
+	unsigned long framesSent;
+	unsigned long bytesSent;
+
+	// Controller end of a loopback link
+	int socket;
+	uint32_t lineBaud; // Baud rate the controller end is at
+	int baud; // Index of the baud rate agreed with the cube, LINK_UNFRAMED for a stock cube
+	uint8_t sequence;
+	struct Link_Reader reader;
+	struct Random noise; // Garbles the bytes which arrive at the wrong baud rate
+	struct Frame_Decoder reference; // What the cube should show, fed the frames before they go in packets
+	unsigned long keyframesRequested;
+	pthread_t rx; // Stands in for the USART and its RX interrupt, see LEDCUBE_LINK_RX
+	int unread; // Byte held by the USART, -1 if there is none
+	bool keyframeNeeded; // Whether a LINK_NAK has come in since Hardware_KeyframeNeeded last looked
+	unsigned long overruns; // Bytes lost as one was still unread
+
+	// Stand-in for the cube firmware at the other end, with a thread of its own
+	int cubeSocket;
+	pthread_t cube;
+	struct Link_Receiver receiver;
+	struct Random cubeNoise; // Garbles bytes as above, and flips the bits of LEDCUBE_LINK_ERRORS
+};
+
+/* One byte on the wire of a loopback link, with the baud rate it was sent at */
+/* A byte only arrives as it was sent if the other end is listening at that rate and the wire can carry it */
+struct Hardware_WireByte {
+	uint32_t baud;
+	uint8_t byte;
+};
+
+/* FUNCTION DECLARATIONS */
+void Hardware_OpenScripts(const char* paths);
+bool Hardware_NextScriptedSample(struct Hardware_Player* player);
+void Hardware_NextSyntheticSample(struct Hardware_Player* player);
+uint32_t Hardware_NextSyntheticRandom(struct Hardware_Player* player);
+void Hardware_WriteFrame(struct Hardware_Link* link, const uint8_t* frame, int length);
+void* Hardware_LinkThread(void* argument);
+void Hardware_PrintLinkStats(void);
+void Hardware_StartLoopback(struct Hardware_Link* link, int cube);
+void* Hardware_RxThread(void* argument);
+void Hardware_TakeUnread(struct Hardware_Link* link);
+void Hardware_WireSend(int socket, uint32_t baud, const uint8_t* bytes, int length);
+int Hardware_WireReceive(int socket, uint32_t baud, int millis, struct Random* noise);
+void* Hardware_CubeThread(void* argument);
+void Hardware_PortSetBaud(void* context, uint32_t baud);
+void Hardware_PortSend(void* context, const uint8_t* bytes, int length);
+int Hardware_PortReceive(void* context, uint32_t millis);
+void Hardware_PortSleep(void* context, uint32_t millis);
+void Hardware_PrintLoopbackStats(struct Hardware_Link* link, int cube);
+uint32_t Hardware_BaudFromEnvironment(const char* name, uint32_t fallback);
+void* Hardware_StreamThread(void* argument);
+void Hardware_PrintStreamStats(void);
+bool Hardware_IsDeflected(const struct Hardware_Player* player);
+#if PROFILE
+void Hardware_RequestStats(int signal);
+void Hardware_WakeAnswered(void);
+#endif
+
+/* GLOBAL VARIABLES */
+/* Joystick of every player */
+int Hardware_playerCount = 0;
+struct Hardware_Player Hardware_players[HARDWARE_MAX_PLAYERS];
+
+/* Clock, either the monotonic clock (measured from Hardware_Setup) or a simulated one */
+bool Hardware_clockVirtual = false;
+struct timespec Hardware_clockStart;
+uint32_t Hardware_virtualMillis = 0;
+
+/* Seed handed to the game */
+uint32_t Hardware_seed = 1;
+uint32_t Hardware_games = 0; // Games started, each of which takes a seed for every cube
+
+/* Games still to be played, see LEDCUBE_GAMES */
+long Hardware_gamesLeft = 1;
+#if PROFILE
+uint32_t Hardware_wokenCycles; // When a joystick last woke the board, for timing how long the first frame takes
+bool Hardware_wakePending = false; // Whether that first frame is still to be sent
+#endif
+
+/* Where the recording of the game goes */
+const char* Hardware_recordingPath = NULL;
+
+/* Link to every cube, simulated asynchronous links each having a thread of their own */
+int Hardware_cubeCount = 0;
+struct Hardware_Link Hardware_links[HARDWARE_MAX_CUBES];
+bool Hardware_linkAsync = false;
+
+/* Loopback links (see LEDCUBE_LINK), and how the stand-in cubes and the wires between them behave */
+bool Hardware_linkLoopback = false;
+int Hardware_cubeMaxBaud = LINK_BAUDS - 1;
+uint32_t Hardware_lineMaxBaud = 3000000;
+uint32_t Hardware_linkErrorThreshold = 0; // Flip a bit when a random number is below this
+bool Hardware_linkRxPolled = false; // See LEDCUBE_LINK_RX
+
+/* Stream from ledCubeStream (see LEDCUBE_STREAM), put into the ring by a thread standing in for the RX interrupt */
+struct Stream_Ring Hardware_streamRing;
+int Hardware_streamSocket = -1;
+bool Hardware_streamClosed = false;
+unsigned long Hardware_streamBytes = 0;
+pthread_mutex_t Hardware_streamLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t Hardware_streamChanged = PTHREAD_COND_INITIALIZER;
+
+#if PROFILE
+/* Where stats records go, and whether SIGUSR1 asked for one */
+FILE* Hardware_statsSink = NULL;
+volatile sig_atomic_t Hardware_statsRequested = 0;
+#endif
+
+/* HARDWARE FUNCTIONS */
+/* Open the joystick scripts and frame sinks given in the environment, for the given number of cubes and players */
+void Hardware_Setup(int cubes, int players) {
+	const char* joystickPath = getenv("LEDCUBE_JOYSTICK");
+	const char* seed = getenv("LEDCUBE_SEED");
+	const char* framesPath = getenv("LEDCUBE_FRAMES");
+	const char* baud = getenv("LEDCUBE_BAUD");
+	const char* clock = getenv("LEDCUBE_CLOCK");
+	const char* linkMode = getenv("LEDCUBE_LINK");
+	const char* games = getenv("LEDCUBE_GAMES");
+
+	Hardware_recordingPath = getenv("LEDCUBE_RECORD");
+	if (games != NULL) {
+		Hardware_gamesLeft = strtol(games, NULL, 0);
+	}
+
+	Hardware_clockVirtual = clock != NULL && strcmp(clock, "virtual") == 0;
+	clock_gettime(CLOCK_MONOTONIC, &Hardware_clockStart);
+
+	if (seed != NULL) {
+		Hardware_seed = (uint32_t)strtoul(seed, NULL, 0);
+	}
+
+	// Every player gets a synthetic source of their own, the first one seeded as the game is
+	Hardware_playerCount = players;
+	for (int i = 0; i < players; i++) {
+		struct Hardware_Player* player = &Hardware_players[i];
+
+		player->script = NULL;
+		player->syntheticState = Hardware_seed + i;
+		for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+			player->sample[channel] = ADC_CENTRE;
+		}
+		Joystick_Init(&player->joystick);
+
+		// xorshift gets stuck on a state of 0, so never let the seed produce one
+		if (player->syntheticState == 0) {
+			player->syntheticState = 1;
+		}
+	}
+
+	if (joystickPath != NULL) {
+		Hardware_OpenScripts(joystickPath);
+	}
+
+	Hardware_cubeCount = cubes;
+	for (int i = 0; i < cubes; i++) {
+		struct Hardware_Link* link = &Hardware_links[i];
+		char path[MAX_PATH];
+
+		pthread_mutex_init(&link->lock, NULL);
+		pthread_cond_init(&link->changed, NULL);
+		link->sink = NULL;
+		link->sendingFrame = NO_FRAME;
+		link->queuedFrame = NO_FRAME;
+
+		if (framesPath != NULL) {
+			snprintf(path, sizeof(path), i == 0 ? "%s" : "%s.%d", framesPath, i);
+
+			link->sink = fopen(path, "wb");
+			if (link->sink == NULL) {
+				perror(path);
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	Hardware_linkLoopback = linkMode != NULL && strcmp(linkMode, "loopback") == 0;
+	if (Hardware_linkLoopback) {
+		const char* errors = getenv("LEDCUBE_LINK_ERRORS");
+		const char* rx = getenv("LEDCUBE_LINK_RX");
+		uint32_t cubeBaud = Hardware_BaudFromEnvironment("LEDCUBE_LINK_CUBE_BAUD", Link_Baud(LINK_BAUDS - 1));
+
+		// The fastest rate of link.h the stand-in can do, none of them for a stock cube
+		Hardware_cubeMaxBaud = LINK_UNFRAMED;
+		for (int i = 0; i < LINK_BAUDS && Link_Baud(i) <= cubeBaud; i++) {
+			Hardware_cubeMaxBaud = i;
+		}
+
+		Hardware_lineMaxBaud = Hardware_BaudFromEnvironment("LEDCUBE_LINK_LINE_BAUD", Hardware_lineMaxBaud);
+		if (errors != NULL) {
+			Hardware_linkErrorThreshold = (uint32_t)(strtod(errors, NULL) * 4294967295.0);
+		}
+		Hardware_linkRxPolled = rx != NULL && strcmp(rx, "poll") == 0;
+	}
+
+	for (int i = 0; i < cubes; i++) {
+		Hardware_links[i].baud = LINK_UNFRAMED;
+
+		if (Hardware_linkLoopback) {
+			Hardware_StartLoopback(&Hardware_links[i], i);
+		} else if (baud != NULL && atol(baud) > 0) {
+			Hardware_links[i].byteNanoseconds = (long)(BITS_PER_BYTE * 1000000000LL / atol(baud));
+		}
+	}
+
+	if (Hardware_linkLoopback || (baud != NULL && atol(baud) > 0)) {
+		Hardware_linkAsync = true;
+
+		for (int i = 0; i < cubes; i++) {
+			pthread_t thread;
+
+			if (pthread_create(&thread, NULL, Hardware_LinkThread, &Hardware_links[i]) != 0) {
+				fprintf(stderr, "LEDCUBE_BAUD: could not start link thread\n");
+				exit(EXIT_FAILURE);
+			}
+			pthread_detach(thread);
+		}
+
+		atexit(Hardware_PrintLinkStats);
+	}
+
+#if PROFILE
+	const char* statsPath = getenv("LEDCUBE_STATS");
+	struct sigaction request;
+
+	if (statsPath != NULL) {
+		Hardware_statsSink = fopen(statsPath, "wb");
+		if (Hardware_statsSink == NULL) {
+			perror(statsPath);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	memset(&request, 0, sizeof(request));
+	request.sa_handler = Hardware_RequestStats;
+	sigemptyset(&request.sa_mask);
+	request.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &request, NULL);
+#endif
+}
+
+/* Read given channel of the latest joystick sample of the first player */
+int Hardware_ReadChannel(int channel) {
+	if (channel < 0 || channel >= NUM_CHANNELS) {
+		return ADC_CENTRE;
+	}
+
+	return Hardware_players[0].sample[channel];
+}
+
+/* Takes the next joystick sample of the given player and gets the direction it points in */
+/* The joystick is taken to be held there for the whole tick, so the sample goes through the filter enough times */
+/* to get past its debounce, as the continuous sampling on the STM32 would */
+enum DirectionChange Hardware_ReadJoystick(int index) {
+	struct Hardware_Player* player = &Hardware_players[index];
+
+	if (!Hardware_NextScriptedSample(player)) {
+		Hardware_NextSyntheticSample(player);
+	}
+
+	for (int i = 0; i < JOYSTICK_DEBOUNCE; i++) {
+		Joystick_Feed(&player->joystick, player->sample[1], player->sample[2]);
+	}
+
+	return Joystick_Take(&player->joystick);
+}
+
+/* Whether Hardware_SendFrame would return straight away for the given cube */
+bool Hardware_CubeReady(int cube) {
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	pthread_mutex_lock(&link->lock);
+	bool ready = link->queuedFrame == NO_FRAME;
+	pthread_mutex_unlock(&link->lock);
+
+	return ready;
+}
+
+/* Checks whether the given cube has sent LINK_NAK since this was last called, so the next frame has to be a full one */
+/* The LINK_NAK is found by the thread standing in for the RX interrupt, unless LEDCUBE_LINK_RX=poll */
+bool Hardware_KeyframeNeeded(int cube) {
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	if (link->baud == LINK_UNFRAMED) {
+		return false;
+	}
+
+	pthread_mutex_lock(&link->lock);
+	if (Hardware_linkRxPolled) {
+		Hardware_TakeUnread(link);
+	}
+	bool needed = link->keyframeNeeded;
+	link->keyframeNeeded = false;
+	pthread_mutex_unlock(&link->lock);
+
+	link->keyframesRequested += needed;
+	return needed;
+}
+
+/* Microseconds the link to the given cube takes to send a frame of length bytes, in its packet if it has one */
+/* Links which are not simulated take no time at all */
+uint32_t Hardware_FrameMicros(int cube, int length) {
+	const struct Hardware_Link* link = &Hardware_links[cube];
+	int bytes = link->baud == LINK_UNFRAMED ? length : length + LINK_OVERHEAD;
+
+	return (uint32_t)(link->byteNanoseconds * bytes / 1000);
+}
+
+/* Records given frame exactly as it would be sent over the USART of the given cube */
+/* With a simulated link the frame is queued for the link thread of the cube, waiting only if a frame is already */
+/* queued, so the links of all the cubes send at the same time */
+void Hardware_SendFrame(int cube, const uint8_t* frame, int length) {
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	if (!Hardware_linkAsync) {
+#if PROFILE
+		Hardware_WakeAnswered();
+#endif
+		Hardware_WriteFrame(link, frame, length);
+		return;
+	}
+
+	pthread_mutex_lock(&link->lock);
+
+	// Frames are never dropped, so wait for the queued frame to start sending
+	if (link->queuedFrame != NO_FRAME) {
+		link->framesWaited++;
+	}
+	while (link->queuedFrame != NO_FRAME) {
+		pthread_cond_wait(&link->changed, &link->lock);
+	}
+
+#if PROFILE
+	Hardware_WakeAnswered();
+#endif
+
+	// Fill whichever frame is not being sent
+	int buffer = link->sendingFrame == 0 ? 1 : 0;
+
+	if (link->baud == LINK_UNFRAMED) {
+		memcpy(link->frames[buffer], frame, length);
+		link->frameLengths[buffer] = length;
+	} else {
+		link->frameLengths[buffer] = Link_EncodePacket(link->sequence++, frame, length, link->frames[buffer]);
+	}
+	link->framesQueued++;
+
+	if (link->sendingFrame == NO_FRAME) {
+		link->sendingFrame = buffer;
+		pthread_cond_broadcast(&link->changed);
+	} else {
+		link->queuedFrame = buffer;
+	}
+
+	pthread_mutex_unlock(&link->lock);
+}
+
+/* Waits until every queued frame has been sent to every cube */
+void Hardware_FlushCubes() {
+	for (int cube = 0; cube < Hardware_cubeCount; cube++) {
+		struct Hardware_Link* link = &Hardware_links[cube];
+
+		if (Hardware_linkAsync) {
+			pthread_mutex_lock(&link->lock);
+
+			while (link->sendingFrame != NO_FRAME) {
+				pthread_cond_wait(&link->changed, &link->lock);
+			}
+
+			pthread_mutex_unlock(&link->lock);
+		}
+
+		if (link->sink != NULL) {
+			fflush(link->sink);
+		}
+	}
+}
+
+/* Seed for the random numbers of a game, LEDCUBE_SEED for the first and the seeds after those of the last for the others */
+uint32_t Hardware_GetSeed() {
+	return Hardware_seed + Hardware_games++ * Hardware_cubeCount;
+}
+
+/* Milliseconds since Hardware_Setup */
+uint32_t Hardware_GetMillis() {
+	if (Hardware_clockVirtual) {
+		return Hardware_virtualMillis;
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint32_t)((now.tv_sec - Hardware_clockStart.tv_sec) * 1000 + (now.tv_nsec - Hardware_clockStart.tv_nsec) / 1000000);
+}
+
+/* Sleep until Hardware_GetMillis reaches millis */
+void Hardware_SleepUntil(uint32_t millis) {
+	if (Hardware_clockVirtual) {
+		if ((int32_t)(millis - Hardware_virtualMillis) > 0) {
+			Hardware_virtualMillis = millis;
+		}
+
+		return;
+	}
+
+	struct timespec deadline = {
+		.tv_sec = Hardware_clockStart.tv_sec + millis / 1000,
+		.tv_nsec = Hardware_clockStart.tv_nsec + (long)(millis % 1000) * 1000000,
+	};
+	if (deadline.tv_nsec >= 1000000000L) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+}
+
+/* IDLE */
+/* Starts the idle state between games, unless every game of LEDCUBE_GAMES has been played */
+bool Hardware_StartIdle() {
+	if (--Hardware_gamesLeft <= 0) {
+		return false;
+	}
+
+	return true;
+}
+
+/* Sleeps until Hardware_GetMillis reaches millis, unless the next sample of a joystick says it was pushed first */
+/* Returns whether one was */
+bool Hardware_SleepUntilWoken(uint32_t millis) {
+	for (int i = 0; i < Hardware_playerCount; i++) {
+		struct Hardware_Player* player = &Hardware_players[i];
+
+		if (!Hardware_NextScriptedSample(player)) {
+			Hardware_NextSyntheticSample(player);
+		}
+
+		if (Hardware_IsDeflected(player)) {
+#if PROFILE
+			Hardware_wokenCycles = Profile_Cycles();
+			Hardware_wakePending = true;
+#endif
+			return true;
+		}
+	}
+
+	Hardware_SleepUntil(millis);
+	return false;
+}
+
+/* Ends the idle state, starting the joystick filters again, as they are not fed whilst idle on the board */
+void Hardware_StopIdle() {
+	for (int i = 0; i < Hardware_playerCount; i++) {
+		Joystick_Init(&Hardware_players[i].joystick);
+	}
+}
+
+/* Whether the latest sample of player is outside the window the analog watchdog watches on the board */
+bool Hardware_IsDeflected(const struct Hardware_Player* player) {
+	for (int channel = 1; channel < NUM_CHANNELS; channel++) {
+		if (player->sample[channel] < JOYSTICK_LOW || player->sample[channel] > JOYSTICK_HIGH) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#if PROFILE
+/* Times the first frame since a joystick woke the board, which is as soon as it responds to it */
+void Hardware_WakeAnswered() {
+	if (Hardware_wakePending) {
+		PROFILE_END(PROFILE_WAKE, Hardware_wokenCycles);
+		Hardware_wakePending = false;
+	}
+}
+#endif
+
+/* LINK */
+/* Append a whole frame (or the packet holding it) to the frame sink of a link, and to its wire if it is a loopback */
+void Hardware_WriteFrame(struct Hardware_Link* link, const uint8_t* frame, int length) {
+	link->framesSent++;
+	link->bytesSent += length;
+
+	if (Hardware_linkLoopback) {
+		Hardware_WireSend(link->socket, link->lineBaud, frame, length);
+	}
+
+	// Only the frame itself goes to the sink, so it reads the same with or without packets
+	if (link->baud != LINK_UNFRAMED) {
+		frame += LINK_HEADER_SIZE;
+		length -= LINK_OVERHEAD;
+	}
+
+	if (Hardware_linkLoopback) {
+		for (int i = 0; i < length; i++) {
+			Frame_Decode(&link->reference, frame[i]);
+		}
+	}
+
+	if (link->sink != NULL) {
+		fwrite(frame, 1, length, link->sink);
+	}
+}
+
+/* Plays the part of the DMA channel of a link, sending one frame at a time at the speed of the USART */
+void* Hardware_LinkThread(void* argument) {
+	struct Hardware_Link* link = argument;
+	pthread_mutex_lock(&link->lock);
+
+	while (true) {
+		while (link->sendingFrame == NO_FRAME) {
+			pthread_cond_wait(&link->changed, &link->lock);
+		}
+
+		// The frame being sent is left alone by Hardware_SendFrame, so it can be sent without holding the lock
+		int frame = link->sendingFrame;
+		pthread_mutex_unlock(&link->lock);
+
+		long nanoseconds = link->byteNanoseconds * link->frameLengths[frame];
+		struct timespec frameTime = {
+			.tv_sec = nanoseconds / 1000000000L,
+			.tv_nsec = nanoseconds % 1000000000L,
+		};
+
+		nanosleep(&frameTime, NULL);
+		Hardware_WriteFrame(link, link->frames[frame], link->frameLengths[frame]);
+
+		// Move on to the queued frame if there is one
+		pthread_mutex_lock(&link->lock);
+		link->sendingFrame = link->queuedFrame;
+		link->queuedFrame = NO_FRAME;
+		pthread_cond_broadcast(&link->changed);
+	}
+
+	return NULL;
+}
+
+/* Report how the simulated link of every cube kept up with the game */
+void Hardware_PrintLinkStats() {
+	for (int cube = 0; cube < Hardware_cubeCount; cube++) {
+		const struct Hardware_Link* link = &Hardware_links[cube];
+
+		fprintf(stderr, "link %d: %lu frames queued, %lu sent (%lu bytes), %lu had to wait for the link\n", cube,
+			link->framesQueued, link->framesSent, link->bytesSent, link->framesWaited);
+
+		if (Hardware_linkLoopback) {
+			Hardware_PrintLoopbackStats(&Hardware_links[cube], cube);
+		}
+	}
+}
+
+/* LOOPBACK */
+/* Connects a link to a stand-in for its cube and runs the handshake with it, as hardwareStm32.c does at setup */
+void Hardware_StartLoopback(struct Hardware_Link* link, int cube) {
+	struct Link_Port port = { link, Hardware_PortSetBaud, Hardware_PortSend, Hardware_PortReceive, Hardware_PortSleep };
+	int sockets[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		perror("LEDCUBE_LINK");
+		exit(EXIT_FAILURE);
+	}
+
+	link->socket = sockets[0];
+	link->cubeSocket = sockets[1];
+	link->lineBaud = Link_Baud(0);
+	link->reader.received = 0;
+	Random_Seed(&link->noise, Hardware_seed + cube);
+	Random_Seed(&link->cubeNoise, ~(Hardware_seed + cube));
+	Frame_InitDecoder(&link->reference);
+	Link_InitReceiver(&link->receiver, Hardware_cubeMaxBaud);
+
+	if (pthread_create(&link->cube, NULL, Hardware_CubeThread, link) != 0) {
+		fprintf(stderr, "LEDCUBE_LINK: could not start cube thread\n");
+		exit(EXIT_FAILURE);
+	}
+
+	// The host can do any rate, so offer the fastest and let the cube and the wire bring it down
+	link->baud = Link_Negotiate(&port, LINK_BAUDS - 1);
+	link->sequence = 0;
+	link->byteNanoseconds = (long)(BITS_PER_BYTE * 1000000000LL / Link_Baud(link->baud));
+
+	// From now on whatever the cube sends back is taken by the stand-in for its RX interrupt, as on the board
+	link->unread = -1;
+	link->keyframeNeeded = false;
+	link->overruns = 0;
+	if (link->baud != LINK_UNFRAMED) {
+		if (pthread_create(&link->rx, NULL, Hardware_RxThread, link) != 0) {
+			fprintf(stderr, "LEDCUBE_LINK: could not start RX thread\n");
+			exit(EXIT_FAILURE);
+		}
+		pthread_detach(link->rx);
+	}
+}
+
+/* Plays the part of the USART of the controller end of a loopback link, and of its RX interrupt */
+/* A byte which comes in whilst the last one is still unread is lost, as the USART only holds one */
+void* Hardware_RxThread(void* argument) {
+	struct Hardware_Link* link = argument;
+	int byte;
+
+	while ((byte = Hardware_WireReceive(link->socket, link->lineBaud, -1, &link->noise)) != WIRE_CLOSED) {
+		if (byte < 0) {
+			continue;
+		}
+
+		pthread_mutex_lock(&link->lock);
+		if (link->unread >= 0) {
+			link->overruns++;
+		} else {
+			link->unread = byte;
+		}
+
+		if (!Hardware_linkRxPolled) {
+			Hardware_TakeUnread(link);
+		}
+		pthread_mutex_unlock(&link->lock);
+	}
+
+	return NULL;
+}
+
+/* Reads the byte the USART of link holds, if there is one, looking for LINK_NAK. Called with the lock of link held */
+void Hardware_TakeUnread(struct Hardware_Link* link) {
+	uint8_t type, value;
+
+	if (link->unread >= 0 && Link_ReadMessage(&link->reader, link->unread, &type, &value) && type == LINK_NAK) {
+		link->keyframeNeeded = true;
+	}
+	link->unread = -1;
+}
+
+/* Puts bytes on the wire of a loopback link, sent at the given baud rate */
+void Hardware_WireSend(int socket, uint32_t baud, const uint8_t* bytes, int length) {
+	struct Hardware_WireByte wire[LINK_MAX_PACKET_SIZE];
+
+	for (int i = 0; i < length; i++) {
+		wire[i].baud = baud;
+		wire[i].byte = bytes[i];
+	}
+
+	const char* data = (const char*)wire;
+	size_t left = length * sizeof(*wire);
+	while (left > 0) {
+		ssize_t written = write(socket, data, left);
+		if (written < 0 && errno != EINTR) {
+			perror("LEDCUBE_LINK");
+			exit(EXIT_FAILURE);
+		}
+		if (written > 0) {
+			data += written;
+			left -= written;
+		}
+	}
+}
+
+/* Takes the next byte off the wire of a loopback link, listening at the given baud rate */
+/* Returns -1 if none comes within millis (-1 waits for ever) and WIRE_CLOSED once the other end has gone */
+int Hardware_WireReceive(int socket, uint32_t baud, int millis, struct Random* noise) {
+	struct pollfd ready = { socket, POLLIN, 0 };
+	struct Hardware_WireByte wire;
+
+	if (poll(&ready, 1, millis) <= 0) {
+		return -1;
+	}
+
+	if (recv(socket, &wire, sizeof(wire), MSG_WAITALL) != (ssize_t)sizeof(wire)) {
+		return WIRE_CLOSED;
+	}
+
+	if (wire.baud != baud || wire.baud > Hardware_lineMaxBaud) {
+		return Random_Next(noise) & 0xFF;
+	}
+
+	return wire.byte;
+}
+
+/* Plays the part of the cube firmware at the other end of a loopback link, until the link is closed */
+void* Hardware_CubeThread(void* argument) {
+	struct Hardware_Link* link = argument;
+	struct Link_Receiver* receiver = &link->receiver;
+	uint8_t reply[LINK_MESSAGE_SIZE];
+
+	while (true) {
+		uint32_t baud = Link_Baud(receiver->baud);
+		int byte = Hardware_WireReceive(link->cubeSocket, baud, receiver->switching ? LINK_SYNC_MILLIS : -1, &link->cubeNoise);
+
+		if (byte == WIRE_CLOSED) {
+			break;
+		}
+		if (byte < 0) {
+			Link_ReceiverTimeout(receiver);
+			continue;
+		}
+
+		// A stock cube takes bare frames and nothing else
+		if (receiver->maxBaud == LINK_UNFRAMED) {
+			receiver->frames += Frame_Decode(&receiver->decoder, byte);
+			continue;
+		}
+
+		if (receiver->framed && Random_Next(&link->cubeNoise) < Hardware_linkErrorThreshold) {
+			byte ^= 1 << Random_Below(&link->cubeNoise, 8);
+		}
+
+		// Any reply goes at the rate the byte came in at, a reply to LINK_HELLO before changing rate
+		int length = Link_Receive(receiver, byte, reply);
+		if (length > 0) {
+			Hardware_WireSend(link->cubeSocket, baud, reply, length);
+		}
+	}
+
+	return NULL;
+}
+
+/* Operations of the handshake on the controller end of a loopback link, see struct Link_Port */
+void Hardware_PortSetBaud(void* context, uint32_t baud) {
+	struct Hardware_Link* link = context;
+	link->lineBaud = baud;
+}
+
+void Hardware_PortSend(void* context, const uint8_t* bytes, int length) {
+	struct Hardware_Link* link = context;
+	Hardware_WireSend(link->socket, link->lineBaud, bytes, length);
+}
+
+int Hardware_PortReceive(void* context, uint32_t millis) {
+	struct Hardware_Link* link = context;
+	int byte = Hardware_WireReceive(link->socket, link->lineBaud, (int)millis, &link->noise);
+
+	return byte < 0 ? -1 : byte;
+}
+
+void Hardware_PortSleep(void* context, uint32_t millis) {
+	struct timespec pause = { millis / 1000, (long)(millis % 1000) * 1000000 };
+
+	(void)context;
+	while (nanosleep(&pause, &pause) != 0 && errno == EINTR);
+}
+
+/* Closes a loopback link once everything has been sent, then reports how its stand-in cube got on */
+/* The cube should end up showing the last frame sent, unless that frame was lost with no full frame after it */
+void Hardware_PrintLoopbackStats(struct Hardware_Link* link, int cube) {
+	const struct Link_Receiver* receiver = &link->receiver;
+
+	shutdown(link->socket, SHUT_WR);
+	pthread_join(link->cube, NULL);
+
+	bool same = memcmp(receiver->decoder.map, link->reference.map, FRAME_MAP_SIZE) == 0;
+
+	if (link->baud == LINK_UNFRAMED) {
+		fprintf(stderr, "link %d: unframed at %lu baud, cube showed %lu frames\n", cube, (unsigned long)Link_Baud(0),
+			receiver->frames);
+	} else {
+		fprintf(stderr, "link %d: packets at %lu baud, cube showed %lu frames, %lu CRC errors, %lu NAKs, %lu delta frames "
+			"dropped, %lu full frames sent in reply, %lu bytes from the cube lost\n", cube, (unsigned long)Link_Baud(link->baud),
+			receiver->frames, receiver->crcErrors, receiver->naks, receiver->dropped, link->keyframesRequested, link->overruns);
+	}
+	fprintf(stderr, "link %d: cube %s the last frame sent\n", cube, same ? "shows" : "does NOT show");
+}
+
+/* Reads a baud rate from the environment, fallback if it is not there */
+uint32_t Hardware_BaudFromEnvironment(const char* name, uint32_t fallback) {
+	const char* value = getenv(name);
+
+	if (value == NULL) {
+		return fallback;
+	}
+
+	return (uint32_t)strtoul(value, NULL, 0);
+}
+
+/* STREAM */
+/* Waits for ledCubeStream to connect to LEDCUBE_STREAM, then starts taking what it sends into the ring */
+struct Stream_Ring* Hardware_OpenStream() {
+	const char* path = getenv("LEDCUBE_STREAM");
+	struct sockaddr_un address;
+	pthread_t thread;
+
+	if (path == NULL) {
+		fprintf(stderr, "STREAM needs LEDCUBE_STREAM, the socket ledCubeStream connects to\n");
+		exit(EXIT_FAILURE);
+	}
+
+	Stream_InitRing(&Hardware_streamRing);
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	unlink(path);
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 1) != 0) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	fprintf(stderr, "waiting for ledCubeStream on %s\n", path);
+	Hardware_streamSocket = accept(listener, NULL, NULL);
+	close(listener);
+	unlink(path);
+
+	if (Hardware_streamSocket < 0) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	if (pthread_create(&thread, NULL, Hardware_StreamThread, NULL) != 0) {
+		fprintf(stderr, "LEDCUBE_STREAM: could not start stream thread\n");
+		exit(EXIT_FAILURE);
+	}
+	pthread_detach(thread);
+
+	atexit(Hardware_PrintStreamStats);
+	return &Hardware_streamRing;
+}
+
+/* Plays the part of the RX interrupt, pushing every byte from ledCubeStream into the ring one at a time */
+void* Hardware_StreamThread(void* argument) {
+	uint8_t bytes[256];
+	ssize_t length;
+
+	(void)argument;
+
+	while ((length = read(Hardware_streamSocket, bytes, sizeof(bytes))) != 0) {
+		if (length < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		for (int i = 0; i < length; i++) {
+			Stream_Push(&Hardware_streamRing, bytes[i]);
+		}
+
+		pthread_mutex_lock(&Hardware_streamLock);
+		Hardware_streamBytes += length;
+		pthread_cond_signal(&Hardware_streamChanged);
+		pthread_mutex_unlock(&Hardware_streamLock);
+	}
+
+	pthread_mutex_lock(&Hardware_streamLock);
+	Hardware_streamClosed = true;
+	pthread_cond_signal(&Hardware_streamChanged);
+	pthread_mutex_unlock(&Hardware_streamLock);
+
+	return NULL;
+}
+
+/* Waits until more than available bytes of the stream have come in, returns false if they never will */
+bool Hardware_WaitForStream(uint32_t available) {
+	pthread_mutex_lock(&Hardware_streamLock);
+
+	while (Stream_Available(&Hardware_streamRing) <= available && !Hardware_streamClosed) {
+		pthread_cond_wait(&Hardware_streamChanged, &Hardware_streamLock);
+	}
+	bool more = Stream_Available(&Hardware_streamRing) > available;
+
+	pthread_mutex_unlock(&Hardware_streamLock);
+	return more;
+}
+
+/* Sends the replies of the board to ledCubeStream, which may already have gone */
+void Hardware_SendToHost(const uint8_t* bytes, int length) {
+	while (length > 0) {
+		ssize_t sent = send(Hardware_streamSocket, bytes, length, MSG_NOSIGNAL);
+		if (sent < 0 && errno != EINTR) {
+			return;
+		}
+		if (sent > 0) {
+			bytes += sent;
+			length -= sent;
+		}
+	}
+}
+
+/* Report whether flow control kept the ring from overflowing */
+void Hardware_PrintStreamStats() {
+	fprintf(stderr, "stream: %lu bytes received, %lu dropped as the ring was full\n", Hardware_streamBytes,
+		Hardware_streamRing.overruns);
+}
+
+/* JOYSTICK SOURCES */
+/* Open the joystick script of every player given in the colon separated list of paths */
+void Hardware_OpenScripts(const char* paths) {
+	for (int i = 0; i < Hardware_playerCount && *paths != '\0'; i++) {
+		char path[MAX_PATH];
+		size_t length = strcspn(paths, ":");
+
+		if (length >= sizeof(path)) {
+			fprintf(stderr, "LEDCUBE_JOYSTICK: path too long\n");
+			exit(EXIT_FAILURE);
+		}
+		memcpy(path, paths, length);
+		path[length] = '\0';
+		paths += paths[length] == ':' ? length + 1 : length;
+
+		// An empty entry leaves the player with synthetic samples
+		if (length == 0) {
+			continue;
+		}
+
+		Hardware_players[i].script = fopen(path, "r");
+		if (Hardware_players[i].script == NULL) {
+			perror(path);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+/* Read the next sample of the joystick script of a player, return false if there is none */
+bool Hardware_NextScriptedSample(struct Hardware_Player* player) {
+	int* sample = player->sample;
+	char line[64];
+
+	if (player->script == NULL) {
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), player->script) != NULL) {
+		sample[1] = ADC_CENTRE;
+		sample[2] = ADC_CENTRE;
+
+		switch (line[0]) {
+			case '#':
+			case '\n':
+				continue;
+			case 'L':
+				sample[2] = ADC_MAX;
+				return true;
+			case 'R':
+				sample[2] = 0;
+				return true;
+			case 'U':
+				sample[1] = ADC_MAX;
+				return true;
+			case 'D':
+				sample[1] = 0;
+				return true;
+			case 'C':
+				return true;
+			default:
+				if (sscanf(line, "%d %d", &sample[1], &sample[2]) == 2) {
+					return true;
+				}
+
+				fprintf(stderr, "LEDCUBE_JOYSTICK: ignoring malformed line: %s", line);
+				break;
+		}
+	}
+
+	// Script has run out so fall back to synthetic samples
+	fclose(player->script);
+	player->script = NULL;
+	return false;
+}
+
+/* Generate a sample that is usually at rest and otherwise fully deflected in one direction */
+void Hardware_NextSyntheticSample(struct Hardware_Player* player) {
+	int* sample = player->sample;
+	uint32_t r = Hardware_NextSyntheticRandom(player);
+
+	// Noise around the centre position which stays within the 1500 to 2500 dead zone
+	sample[1] = ADC_CENTRE - 256 + (int)(r & 0x1FF);
+	sample[2] = ADC_CENTRE - 256 + (int)(r >> 9 & 0x1FF);
+
+	// Deflect the joystick one time in four
+	if ((r >> 18 & 3) == 0) {
+		int channel = 1 + (int)(r >> 20 & 1);
+		sample[channel] = (r >> 21 & 1) ? ADC_MAX : 0;
+	}
+}
+
+/* xorshift32 generator of the synthetic joystick source of a player */
+uint32_t Hardware_NextSyntheticRandom(struct Hardware_Player* player) {
+	uint32_t x = player->syntheticState;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	player->syntheticState = x;
+	return x;
+}
+
+/* Writes the recording of a game to LEDCUBE_RECORD */
+void Hardware_SaveRecording(const uint8_t* log, int length) {
+	if (Hardware_recordingPath == NULL) {
+		return;
+	}
+
+	FILE* file = fopen(Hardware_recordingPath, "wb");
+	if (file == NULL || fwrite(log, 1, length, file) != (size_t)length) {
+		perror(Hardware_recordingPath);
+	}
+	if (file != NULL) {
+		fclose(file);
+	}
+}
+
+#if PROFILE
+/* Called on SIGUSR1 */
+void Hardware_RequestStats(int number) {
+	(void)number;
+	Hardware_statsRequested = 1;
+}
+
+/* Checks whether SIGUSR1 has arrived since this was last called */
+bool Hardware_StatsRequested() {
+	bool requested = Hardware_statsRequested;
+	Hardware_statsRequested = 0;
+	return requested;
+}
+
+/* Appends a stats record to LEDCUBE_STATS */
+void Hardware_SendStats(const uint8_t* record, int length) {
+	if (Hardware_statsSink == NULL) {
+		return;
+	}
+
+	fwrite(record, 1, length, Hardware_statsSink);
+	fflush(Hardware_statsSink);
+}
+#endif
@@ -0,0 +1,749 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "libopencm3/stm32/rcc.h" // Needed to enable clocks for particular GPIO ports
+#include "libopencm3/stm32/gpio.h" // Needed to define things on the GPIO
+#include "libopencm3/stm32/usart.h" // Needed to use USART
+#include "libopencm3/stm32/adc.h" // Needed to convert analogue signals to digital
+#include "libopencm3/stm32/dma.h" // Needed to send frames without the CPU
+#include "libopencm3/cm3/nvic.h" // Needed to enable interrupts
+#include "libopencm3/cm3/cortex.h" // Needed to mask interrupts whilst going to sleep
+#include "libopencm3/cm3/systick.h" // Needed to keep time
+#include "libopencm3/cm3/dwt.h" // Needed to count cycles when profiling
+
+
+#include "hardware.h"
+#include "profile.h"
+#include "link.h"
+
+/* DEFINING MACROS */
+#define ADC_REG ADC1
+#define SEED_STEP 0x9E3779B9 // Spreads the number of a game over every bit of its seed
+
+#define NO_FRAME -1
+#define LINK_OVERSAMPLING 16 // A USART needs a clock of at least 16 times its baud rate
+#define BITS_PER_BYTE 10 // 8N1 sends a start and a stop bit with every byte
+
+#define ADC_DMA DMA1
+#define ADC_DMA_CHANNEL DMA_CHANNEL1 // Channel of DMA1 wired to ADC1
+#define ADC_DMA_IRQ NVIC_DMA1_CHANNEL1_IRQ
+#define ADC_MAX_CHANNELS (2 * HARDWARE_MAX_PLAYERS) // Both channels of every joystick are converted in turn
+#define ADC_HIGHEST_CHANNEL 9 // Highest channel number a joystick is on
+#define ADC_HALF_BUFFER_SAMPLES 16 // Samples of each channel averaged into one sample for the joystick filter
+#define ADC_IRQ NVIC_ADC1_2_IRQ // Raised by the analog watchdog, only enabled whilst idle
+
+/* Sleeps until condition no longer holds, waking for every interrupt */
+/* Interrupts are masked whilst condition is checked, so one which comes in just before the wfi still wakes it (a */
+/* pending interrupt ends wfi even when masked) rather than the sleep lasting until the next SysTick */
+#define SLEEP_WHILE(condition) do { \
+		cm_disable_interrupts(); \
+		while (condition) { \
+			__asm__ volatile ("wfi"); \
+			cm_enable_interrupts(); \
+			__asm__ volatile ("isb"); /* Take the interrupt which woke us before masking them again */ \
+			cm_disable_interrupts(); \
+		} \
+		cm_enable_interrupts(); \
+	} while (0)
+
+// Stats records go to the PC over USART2, which the Nucleo board connects to the virtual COM port of its ST-LINK
+// Streamed frames come in over it too, as fast as the 8 MHz HSI lets it go (see Hardware_NegotiateLink)
+#define STATS_PORT GPIOA
+#define STATS_TX_PIN GPIO2
+#define STATS_RX_PIN GPIO3
+#define STATS_USART USART2
+#define STATS_BAUD 115200
+#define STATS_IRQ NVIC_USART2_EXTI26_IRQ
+#define STREAM_BAUD 460800
+
+/* STRUCTS AND ENUMS */
+/* Pins, USART and DMA channel a cube is connected through */
+struct Hardware_Port {
+	uint32_t gpioPort;
+	enum rcc_periph_clken gpioClock;
+	uint16_t txPin;
+	uint16_t rxPin;
+	uint8_t alternateFunction;
+	enum rcc_periph_clken usartClock;
+	uint32_t usart;
+	uint32_t dma;
+	uint8_t dmaChannel; // Channel of the DMA controller wired to the TX of the USART
+	uint8_t dmaIrq;
+	uint8_t usartIrq; // Raised for every byte the cube sends back
+};
+
+/* Link to one cube, a double buffer of frames (or packets holding them, see link.h) sent to it by DMA */
+/* One frame can be being sent while the next one is queued */
+struct Hardware_Link {
+	uint8_t frames[2][LINK_MAX_PACKET_SIZE];
+	int frameLengths[2];
+	volatile int sendingFrame;
+	volatile int queuedFrame;
+	int baud; // Index of the baud rate agreed with the cube, LINK_UNFRAMED for a stock cube
+	uint8_t sequence; // Sequence number of the next packet
+	struct Link_Reader reader; // Finds the LINK_NAKs the cube sends back, fed by the RX interrupt of the cube
+	volatile bool keyframeNeeded; // Whether a LINK_NAK has come in since Hardware_KeyframeNeeded last looked
+};
+
+/* Pins and ADC channels of the joystick of a player */
+struct Hardware_Stick {
+	uint32_t gpioPort;
+	enum rcc_periph_clken gpioClock;
+	uint16_t pins;
+	uint8_t channels[2];
+};
+
+/* FUNCTION DECLARATIONS */
+void Hardware_SetupLink(int cube);
+void Hardware_NegotiateLink(int cube);
+void Hardware_PortSetBaud(void* context, uint32_t baud);
+void Hardware_PortSend(void* context, const uint8_t* bytes, int length);
+int Hardware_PortReceive(void* context, uint32_t millis);
+void Hardware_PortSleep(void* context, uint32_t millis);
+void Hardware_StartFrame(int cube, int frame);
+void Hardware_FrameSent(int cube);
+void dma1_channel4_isr(void);
+void dma1_channel2_isr(void);
+void dma2_channel5_isr(void);
+void Hardware_CubeReceived(int cube);
+void usart1_exti25_isr(void);
+void usart3_exti28_isr(void);
+void uart4_exti34_isr(void);
+void sys_tick_handler(void);
+void dma1_channel1_isr(void);
+void adc1_2_isr(void);
+void Hardware_FilterSamples(const volatile uint16_t* samples);
+void Hardware_SetupHostUsart(uint32_t baud);
+void usart2_exti26_isr(void);
+
+/* GLOBAL VARIABLES */
+/* Where each cube is connected, in the order of the cubes */
+/* USART2 is left out as it goes to the ST-LINK, which takes the stats records when profiling */
+const struct Hardware_Port Hardware_ports[HARDWARE_MAX_CUBES] = {
+	{ GPIOB, RCC_GPIOB, GPIO6, GPIO7, GPIO_AF7, RCC_USART1, USART1, DMA1, DMA_CHANNEL4, NVIC_DMA1_CHANNEL4_IRQ, NVIC_USART1_EXTI25_IRQ },
+	{ GPIOB, RCC_GPIOB, GPIO10, GPIO11, GPIO_AF7, RCC_USART3, USART3, DMA1, DMA_CHANNEL2, NVIC_DMA1_CHANNEL2_IRQ, NVIC_USART3_EXTI28_IRQ },
+	{ GPIOC, RCC_GPIOC, GPIO10, GPIO11, GPIO_AF5, RCC_UART4, UART4, DMA2, DMA_CHANNEL5, NVIC_DMA2_CHANNEL5_IRQ, NVIC_UART4_EXTI34_IRQ },
+};
+
+/* Where the joystick of each player is connected, in the order of the players */
+const struct Hardware_Stick Hardware_sticks[HARDWARE_MAX_PLAYERS] = {
+	{ GPIOA, RCC_GPIOA, GPIO0 | GPIO1, {1, 2} },
+	{ GPIOC, RCC_GPIOC, GPIO0 | GPIO1, {6, 7} },
+	{ GPIOC, RCC_GPIOC, GPIO2 | GPIO3, {8, 9} },
+};
+
+/* Number of cubes and players set up by Hardware_Setup */
+int Hardware_cubes = 0;
+int Hardware_players = 0;
+
+/* Every frame goes out by DMA, so the links of all the cubes send at the same time */
+struct Hardware_Link Hardware_links[HARDWARE_MAX_CUBES];
+
+/* Circular buffer DMA fills with conversions of both channels of every joystick in turn, one half whilst the other */
+/* is filtered */
+volatile uint16_t Hardware_adcSamples[2 * ADC_HALF_BUFFER_SAMPLES * ADC_MAX_CHANNELS];
+int Hardware_adcChannels = 0;
+
+/* Latest averaged reading of each channel (by channel number) and the filters the readings of each joystick go through */
+volatile int Hardware_channelValues[ADC_HIGHEST_CHANNEL + 1];
+struct Joystick Hardware_joysticks[HARDWARE_MAX_PLAYERS];
+
+/* Milliseconds since Hardware_Setup, counted by SysTick */
+volatile uint32_t Hardware_millis = 0;
+
+/* Number of games started since Hardware_Setup */
+uint32_t Hardware_games = 0;
+
+/* Whether a joystick has been pushed since the idle state started, set by the analog watchdog */
+volatile bool Hardware_woken = false;
+#if PROFILE
+volatile uint32_t Hardware_wokenCycles; // When it was, for timing how long the first frame of the game takes
+volatile bool Hardware_wakePending = false; // Whether that first frame is still to be sent
+#endif
+
+/* Bytes streamed from the PC, put there by the RX interrupt of STATS_USART */
+struct Stream_Ring Hardware_streamRing;
+
+/* HARDWARE FUNCTIONS */
+/* Setup everything to be able to interact with the hardware (the given number of LED cubes and joysticks) */
+void Hardware_Setup(int cubes, int players) {
+	Hardware_cubes = cubes;
+	Hardware_players = players;
+
+	//// Setup GPIO B
+	rcc_periph_clock_enable(RCC_GPIOB); // Enable clock for GPIO Port B
+
+	gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO5); // GPIO Port Name, GPIO Mode, GPIO Push Up Pull Down Mode, GPIO Pin Number
+	gpio_set_output_options(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_100MHZ, GPIO5); // GPIO Port Name, GPIO Pin Driver Type, GPIO Pin Speed, GPIO Pin Number
+
+	// Set B5
+	gpio_set(GPIOB, GPIO5);
+
+	//// Setup the link to every cube
+	rcc_periph_clock_enable(RCC_DMA1); // Enable clock for DMA controller 1, which also takes the ADC conversions
+	rcc_periph_clock_enable(RCC_DMA2);
+
+	for (int cube = 0; cube < cubes; cube++) {
+		Hardware_SetupLink(cube);
+	}
+
+	//// Setup joystick pins as analogue inputs
+	for (int player = 0; player < players; player++) {
+		rcc_periph_clock_enable(Hardware_sticks[player].gpioClock);
+		gpio_mode_setup(Hardware_sticks[player].gpioPort, GPIO_MODE_ANALOG, GPIO_PUPD_NONE, Hardware_sticks[player].pins);
+	}
+
+	//// Setup ADC
+	rcc_periph_clock_enable(RCC_ADC12); // Enable clock for ADC registers 1 and 2
+
+	adc_power_off(ADC_REG); // Turn off ADC register 1 whist we set it up
+
+	adc_set_clk_prescale(ADC_REG, ADC_CCR_CKMODE_DIV1); // Setup a scaling
+	adc_disable_external_trigger_regular(ADC_REG); // We don't need to externally trigger the register...
+	adc_set_right_aligned(ADC_REG); // Make sure it is right aligned to get more usable values
+	adc_set_sample_time_on_all_channels(ADC_REG, ADC_SMPR_SMP_601DOT5CYC); // Longest sample time, we only need a few hundred samples a second
+	adc_set_resolution(ADC_REG, ADC_CFGR1_RES_12_BIT); // Get a good resolution
+
+	// Convert the joystick channels one after the other, over and over
+	uint8_t channelArray[ADC_MAX_CHANNELS];
+	Hardware_adcChannels = 0;
+	for (int player = 0; player < players; player++) {
+		channelArray[Hardware_adcChannels++] = Hardware_sticks[player].channels[0];
+		channelArray[Hardware_adcChannels++] = Hardware_sticks[player].channels[1];
+	}
+	adc_set_regular_sequence(ADC_REG, Hardware_adcChannels, channelArray);
+	adc_set_continuous_conversion_mode(ADC_REG);
+	adc_enable_dma_circular_mode(ADC_REG); // Keep asking DMA to take conversions rather than stopping after one buffer
+	adc_enable_dma(ADC_REG);
+
+	// The analog watchdog flags any conversion outside the thresholds of the joystick filter, so a joystick pushed far
+	// enough to count is seen without the core doing anything. Only set up whilst the ADC is stopped, as the watchdog
+	// can only be changed then. It interrupts only when ADC_IRQ is enabled, which is whilst the board is idle
+	adc_enable_analog_watchdog_regular(ADC_REG);
+	adc_enable_analog_watchdog_on_all_channels(ADC_REG);
+	adc_set_watchdog_low_threshold(ADC_REG, JOYSTICK_LOW);
+	adc_set_watchdog_high_threshold(ADC_REG, JOYSTICK_HIGH);
+	adc_enable_watchdog_interrupt(ADC_REG);
+
+	// DMA moves every conversion into Hardware_adcSamples and interrupts once each half of it is full
+	for (int player = 0; player < players; player++) {
+		Joystick_Init(&Hardware_joysticks[player]);
+	}
+
+	dma_channel_reset(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_set_peripheral_address(ADC_DMA, ADC_DMA_CHANNEL, (uint32_t)&ADC_DR(ADC_REG)); // Read from ADC data register
+	dma_set_memory_address(ADC_DMA, ADC_DMA_CHANNEL, (uint32_t)Hardware_adcSamples);
+	dma_set_number_of_data(ADC_DMA, ADC_DMA_CHANNEL, 2 * ADC_HALF_BUFFER_SAMPLES * Hardware_adcChannels);
+	dma_set_read_from_peripheral(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_enable_memory_increment_mode(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_set_memory_size(ADC_DMA, ADC_DMA_CHANNEL, DMA_CCR_MSIZE_16BIT);
+	dma_set_peripheral_size(ADC_DMA, ADC_DMA_CHANNEL, DMA_CCR_PSIZE_16BIT);
+	dma_set_priority(ADC_DMA, ADC_DMA_CHANNEL, DMA_CCR_PL_MEDIUM);
+	dma_enable_circular_mode(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_enable_half_transfer_interrupt(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_enable_transfer_complete_interrupt(ADC_DMA, ADC_DMA_CHANNEL);
+	dma_enable_channel(ADC_DMA, ADC_DMA_CHANNEL);
+
+	nvic_enable_irq(ADC_DMA_IRQ);
+
+	adc_power_on(ADC_REG); // Finished setup, turn on ADC register 1
+	adc_start_conversion_regular(ADC_REG); // Conversions carry on by themselves from now on
+
+	//// Setup SysTick to interrupt every millisecond
+	systick_set_frequency(1000, rcc_ahb_frequency);
+	systick_interrupt_enable();
+	systick_counter_enable();
+
+	//// Move every link to the fastest baud rate its cube can take, which needs SysTick for the timeouts
+	for (int cube = 0; cube < cubes; cube++) {
+		Hardware_NegotiateLink(cube);
+	}
+
+#if PROFILE
+	//// Setup the cycle counter and the USART stats records are sent over
+	dwt_enable_cycle_counter();
+	Hardware_SetupHostUsart(STATS_BAUD);
+#endif
+}
+
+/* Sets up STATS_USART, the link to the PC, at the given baud rate */
+void Hardware_SetupHostUsart(uint32_t baud) {
+	rcc_periph_clock_enable(RCC_GPIOA);
+	gpio_mode_setup(STATS_PORT, GPIO_MODE_AF, GPIO_PUPD_NONE, STATS_TX_PIN | STATS_RX_PIN);
+	gpio_set_af(STATS_PORT, GPIO_AF7, STATS_TX_PIN | STATS_RX_PIN);
+
+	rcc_periph_clock_enable(RCC_USART2);
+	usart_set_baudrate(STATS_USART, baud);
+	usart_set_databits(STATS_USART, 8);
+	usart_set_stopbits(STATS_USART, USART_STOPBITS_1);
+	usart_set_mode(STATS_USART, USART_MODE_TX_RX);
+	usart_set_parity(STATS_USART, USART_PARITY_NONE);
+	usart_set_flow_control(STATS_USART, USART_FLOWCONTROL_NONE);
+	usart_enable(STATS_USART);
+}
+
+/* Sets up the USART of the given cube, and the DMA channel sending frames to it */
+void Hardware_SetupLink(int cube) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+
+	Hardware_links[cube].sendingFrame = NO_FRAME;
+	Hardware_links[cube].queuedFrame = NO_FRAME;
+	Hardware_links[cube].keyframeNeeded = false;
+
+	// Setup TX and RX pins
+	rcc_periph_clock_enable(port->gpioClock);
+	gpio_mode_setup(port->gpioPort, GPIO_MODE_AF, GPIO_PUPD_NONE, port->txPin | port->rxPin);
+	gpio_set_af(port->gpioPort, port->alternateFunction, port->txPin | port->rxPin);
+
+	//// Setup USART
+	rcc_periph_clock_enable(port->usartClock); // Enable clock for USART
+
+	usart_set_baudrate(port->usart, 9600);
+	usart_set_databits(port->usart, 8);
+	usart_set_stopbits(port->usart, USART_STOPBITS_1);
+	usart_set_mode(port->usart, USART_MODE_TX_RX);
+	usart_set_parity(port->usart, USART_PARITY_NONE);
+	usart_set_flow_control(port->usart, USART_FLOWCONTROL_NONE);
+
+	usart_enable_rx_interrupt(port->usart);
+
+	usart_enable(port->usart);
+
+	//// Setup DMA to send frames over USART
+	dma_channel_reset(port->dma, port->dmaChannel);
+	dma_set_peripheral_address(port->dma, port->dmaChannel, (uint32_t)&USART_TDR(port->usart)); // Write into USART data register
+	dma_set_read_from_memory(port->dma, port->dmaChannel);
+	dma_enable_memory_increment_mode(port->dma, port->dmaChannel);
+	dma_set_memory_size(port->dma, port->dmaChannel, DMA_CCR_MSIZE_8BIT);
+	dma_set_peripheral_size(port->dma, port->dmaChannel, DMA_CCR_PSIZE_8BIT);
+	dma_set_priority(port->dma, port->dmaChannel, DMA_CCR_PL_HIGH);
+	dma_enable_transfer_complete_interrupt(port->dma, port->dmaChannel); // Interrupt once a frame has been sent
+
+	nvic_enable_irq(port->dmaIrq);
+	usart_enable_tx_dma(port->usart); // USART requests a byte from DMA whenever it is ready to send
+}
+
+/* Runs the handshake of link.h with the given cube, before any frame has been sent to it */
+/* The fastest rate offered is the fastest the clock of its USART can make, which is 460800 baud on the 8 MHz HSI */
+/* Anything from 921600 up needs the PLL to run the bus at 16 MHz or more */
+void Hardware_NegotiateLink(int cube) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+	struct Hardware_Link* link = &Hardware_links[cube];
+	struct Link_Port linkPort = { (void*)port, Hardware_PortSetBaud, Hardware_PortSend, Hardware_PortReceive, Hardware_PortSleep };
+
+	// USART1 is on APB2, the others on APB1
+	uint32_t clock = port->usart == USART1 ? rcc_apb2_frequency : rcc_apb1_frequency;
+	int offer = 0;
+	while (offer + 1 < LINK_BAUDS && Link_Baud(offer + 1) * LINK_OVERSAMPLING <= clock) {
+		offer++;
+	}
+
+	link->baud = Link_Negotiate(&linkPort, offer);
+	link->sequence = 0;
+	link->reader.received = 0;
+
+	// From now on whatever the cube sends back is taken by its RX interrupt, as it comes in
+	USART_ICR(port->usart) = USART_ICR_ORECF;
+	nvic_enable_irq(port->usartIrq);
+}
+
+/* Operations of the handshake on the USART of a cube, see struct Link_Port */
+/* They poll the USART, as its RX interrupt is only enabled once the handshake is over */
+void Hardware_PortSetBaud(void* context, uint32_t baud) {
+	const struct Hardware_Port* port = context;
+
+	// The baud rate can only be changed with the USART off, so let the last byte go first
+	while (!usart_get_flag(port->usart, USART_ISR_TC));
+	usart_disable(port->usart);
+	usart_set_baudrate(port->usart, baud);
+	usart_enable(port->usart);
+}
+
+void Hardware_PortSend(void* context, const uint8_t* bytes, int length) {
+	const struct Hardware_Port* port = context;
+
+	for (int i = 0; i < length; i++) {
+		usart_send_blocking(port->usart, bytes[i]);
+	}
+}
+
+int Hardware_PortReceive(void* context, uint32_t millis) {
+	const struct Hardware_Port* port = context;
+	uint32_t deadline = Hardware_millis + millis;
+
+	while ((int32_t)(deadline - Hardware_millis) > 0) {
+		// A byte which came in whilst the last one was still there stops the USART receiving until this is cleared
+		USART_ICR(port->usart) = USART_ICR_ORECF;
+
+		if (usart_get_flag(port->usart, USART_ISR_RXNE)) {
+			return usart_recv(port->usart);
+		}
+	}
+
+	return -1;
+}
+
+void Hardware_PortSleep(void* context, uint32_t millis) {
+	(void)context;
+	Hardware_SleepUntil(Hardware_millis + millis);
+}
+
+/* Read given channel on ADC_REG */
+/* Channels are converted continuously, so this is the latest reading rather than a new conversion */
+int Hardware_ReadChannel(int channel) {
+	if (channel < 1 || channel > ADC_HIGHEST_CHANNEL) {
+		return 0;
+	}
+
+	return Hardware_channelValues[channel];
+}
+
+/* Gets the strongest debounced deflection of the joystick of the given player since the last call */
+enum DirectionChange Hardware_ReadJoystick(int player) {
+	// Keep the DMA interrupt from feeding the filter whilst we take from it
+	nvic_disable_irq(ADC_DMA_IRQ);
+	enum DirectionChange direction = Joystick_Take(&Hardware_joysticks[player]);
+	nvic_enable_irq(ADC_DMA_IRQ);
+
+	return direction;
+}
+
+/* Called by DMA once either half of Hardware_adcSamples has been filled */
+void dma1_channel1_isr() {
+	if (dma_get_interrupt_flag(ADC_DMA, ADC_DMA_CHANNEL, DMA_HTIF)) {
+		dma_clear_interrupt_flags(ADC_DMA, ADC_DMA_CHANNEL, DMA_HTIF);
+		Hardware_FilterSamples(Hardware_adcSamples);
+	}
+
+	if (dma_get_interrupt_flag(ADC_DMA, ADC_DMA_CHANNEL, DMA_TCIF)) {
+		dma_clear_interrupt_flags(ADC_DMA, ADC_DMA_CHANNEL, DMA_TCIF);
+		Hardware_FilterSamples(Hardware_adcSamples + ADC_HALF_BUFFER_SAMPLES * Hardware_adcChannels);
+	}
+}
+
+/* Average half a buffer of conversions and feed the results to the joystick filters */
+void Hardware_FilterSamples(const volatile uint16_t* samples) {
+	int sums[ADC_MAX_CHANNELS] = {0};
+
+	for (int i = 0; i < ADC_HALF_BUFFER_SAMPLES; i++) {
+		for (int slot = 0; slot < Hardware_adcChannels; slot++) {
+			sums[slot] += samples[Hardware_adcChannels * i + slot];
+		}
+	}
+
+	// The conversions of each player take two slots of the sequence, in the order of the players
+	for (int player = 0; player < Hardware_players; player++) {
+		const uint8_t* channels = Hardware_sticks[player].channels;
+
+		Hardware_channelValues[channels[0]] = sums[2 * player] / ADC_HALF_BUFFER_SAMPLES;
+		Hardware_channelValues[channels[1]] = sums[2 * player + 1] / ADC_HALF_BUFFER_SAMPLES;
+
+		Joystick_Feed(&Hardware_joysticks[player], Hardware_channelValues[channels[0]], Hardware_channelValues[channels[1]]);
+	}
+}
+
+/* Whether Hardware_SendFrame would return straight away for the given cube */
+bool Hardware_CubeReady(int cube) {
+	return Hardware_links[cube].queuedFrame == NO_FRAME;
+}
+
+/* Checks whether the given cube has lost a frame since this was last called, so the next one has to be a full frame */
+/* The LINK_NAK is found by the RX interrupt of the cube, as the USART only holds one byte of its three */
+bool Hardware_KeyframeNeeded(int cube) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	// Keep the RX interrupt from setting the flag between it being read and cleared
+	nvic_disable_irq(port->usartIrq);
+	bool needed = link->keyframeNeeded;
+	link->keyframeNeeded = false;
+	nvic_enable_irq(port->usartIrq);
+
+	return needed;
+}
+
+/* Microseconds the link to the given cube takes to send a frame of length bytes, in its packet if it has one */
+uint32_t Hardware_FrameMicros(int cube, int length) {
+	const struct Hardware_Link* link = &Hardware_links[cube];
+	int bytes = link->baud == LINK_UNFRAMED ? length : length + LINK_OVERHEAD;
+
+	return (uint32_t)((uint64_t)bytes * BITS_PER_BYTE * 1000000 / Link_Baud(link->baud));
+}
+
+/* Queues given frame to be sent to the given LED cube */
+/* Returns straight away unless a frame is already queued for it, in which case it waits for that one to start sending */
+/* Frames are never dropped, as a delta frame only makes sense after every frame before it */
+/* A cube which took part in the handshake gets the frame in a packet, so it can tell when one was corrupted */
+/* Each cube has a DMA channel of its own, so the frames for every cube go out at the same time */
+void Hardware_SendFrame(int cube, const uint8_t* frame, int length) {
+	struct Hardware_Link* link = &Hardware_links[cube];
+	uint8_t irq = Hardware_ports[cube].dmaIrq;
+
+	SLEEP_WHILE(link->queuedFrame != NO_FRAME);
+
+#if PROFILE
+	// The first frame since a joystick woke the board is as soon as it responds to it
+	if (Hardware_wakePending) {
+		PROFILE_END(PROFILE_WAKE, Hardware_wokenCycles);
+		Hardware_wakePending = false;
+	}
+#endif
+
+	// Keep the DMA interrupt from changing which frame is being sent whilst we fill the other one
+	nvic_disable_irq(irq);
+
+	int buffer = link->sendingFrame == 0 ? 1 : 0;
+
+	if (link->baud == LINK_UNFRAMED) {
+		for (int i = 0; i < length; i++) {
+			link->frames[buffer][i] = frame[i];
+		}
+		link->frameLengths[buffer] = length;
+	} else {
+		link->frameLengths[buffer] = Link_EncodePacket(link->sequence++, frame, length, link->frames[buffer]);
+	}
+
+	// Send now if the link is idle, otherwise after the frame being sent
+	if (link->sendingFrame == NO_FRAME) {
+		Hardware_StartFrame(cube, buffer);
+	} else {
+		link->queuedFrame = buffer;
+	}
+
+	nvic_enable_irq(irq);
+}
+
+/* Waits until every queued frame has been sent to every LED cube */
+void Hardware_FlushCubes() {
+	for (int cube = 0; cube < Hardware_cubes; cube++) {
+		SLEEP_WHILE(Hardware_links[cube].sendingFrame != NO_FRAME);
+
+		// The last byte is still in the USART once DMA has finished
+		while (!usart_get_flag(Hardware_ports[cube].usart, USART_ISR_TC));
+	}
+}
+
+/* Start DMA transfer of frame to the USART of the given cube */
+void Hardware_StartFrame(int cube, int frame) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	link->sendingFrame = frame;
+
+	dma_set_memory_address(port->dma, port->dmaChannel, (uint32_t)link->frames[frame]);
+	dma_set_number_of_data(port->dma, port->dmaChannel, link->frameLengths[frame]);
+	dma_enable_channel(port->dma, port->dmaChannel);
+}
+
+/* Called once DMA has handed the last byte of a frame to the USART of the given cube */
+void Hardware_FrameSent(int cube) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+	struct Hardware_Link* link = &Hardware_links[cube];
+
+	if (!dma_get_interrupt_flag(port->dma, port->dmaChannel, DMA_TCIF)) {
+		return;
+	}
+
+	dma_clear_interrupt_flags(port->dma, port->dmaChannel, DMA_TCIF);
+	dma_disable_channel(port->dma, port->dmaChannel); // Needed to be able to reload the number of bytes
+
+	// Move on to the queued frame if there is one
+	if (link->queuedFrame != NO_FRAME) {
+		Hardware_StartFrame(cube, link->queuedFrame);
+		link->queuedFrame = NO_FRAME;
+	} else {
+		link->sendingFrame = NO_FRAME;
+	}
+}
+
+/* DMA interrupts of the TX of each cube, in the order of Hardware_ports */
+void dma1_channel4_isr() {
+	Hardware_FrameSent(0);
+}
+
+void dma1_channel2_isr() {
+	Hardware_FrameSent(1);
+}
+
+void dma2_channel5_isr() {
+	Hardware_FrameSent(2);
+}
+
+/* Takes the byte the given cube sent back, once the handshake is over the only thing it sends being LINK_NAK */
+void Hardware_CubeReceived(int cube) {
+	const struct Hardware_Port* port = &Hardware_ports[cube];
+	struct Hardware_Link* link = &Hardware_links[cube];
+	uint8_t type, value;
+
+	// A byte which came in whilst the last one was still there stops the USART receiving until this is cleared
+	USART_ICR(port->usart) = USART_ICR_ORECF;
+
+	while (usart_get_flag(port->usart, USART_ISR_RXNE)) {
+		uint8_t byte = usart_recv(port->usart);
+
+		if (link->baud != LINK_UNFRAMED && Link_ReadMessage(&link->reader, byte, &type, &value) && type == LINK_NAK) {
+			link->keyframeNeeded = true;
+		}
+	}
+}
+
+/* RX interrupts of each cube, in the order of Hardware_ports */
+void usart1_exti25_isr() {
+	Hardware_CubeReceived(0);
+}
+
+void usart3_exti28_isr() {
+	Hardware_CubeReceived(1);
+}
+
+void uart4_exti34_isr() {
+	Hardware_CubeReceived(2);
+}
+
+/* Seed for the random numbers of a game, different for every game the board plays */
+/* Mixes the number of the game with when it starts (which depends on how long the idle before it lasted) and the */
+/* noise in the low bits of the latest joystick conversions, Random_Seed scrambling the result */
+uint32_t Hardware_GetSeed() {
+	uint32_t seed = ++Hardware_games * SEED_STEP ^ Hardware_millis;
+
+	for (int i = 0; i < 2 * ADC_HALF_BUFFER_SAMPLES * Hardware_adcChannels; i++) {
+		seed = (seed << 3 | seed >> 29) ^ (Hardware_adcSamples[i] & 0x7);
+	}
+
+	return seed;
+}
+
+/* Milliseconds since Hardware_Setup */
+uint32_t Hardware_GetMillis() {
+	return Hardware_millis;
+}
+
+/* Sleep until Hardware_GetMillis reaches millis, waking up for every interrupt in between (SysTick at the latest) */
+void Hardware_SleepUntil(uint32_t millis) {
+	SLEEP_WHILE((int32_t)(millis - Hardware_millis) > 0);
+}
+
+/* IDLE FUNCTIONS */
+/* Starts the idle state between games, in which a joystick being pushed wakes the board. Always returns true */
+/* The core sleeps (Sleep mode, as the ADC would stop along with its clock in Stop mode and could not wake it) and */
+/* the joystick filter is no longer fed, so the ADC and DMA carry on converting by themselves. The core then only */
+/* wakes for SysTick, the links of the cubes, and the analog watchdog once any channel goes outside JOYSTICK_LOW to */
+/* JOYSTICK_HIGH. That is seen at the end of the conversion of the channel, which comes round every 2 * players */
+/* conversions of 614 ADC clocks (154 us for one player at 8 MHz), and the interrupt is taken within a few cycles */
+bool Hardware_StartIdle() {
+	nvic_disable_irq(ADC_DMA_IRQ);
+
+	// Only pushes from now on count, not ones made during the last game
+	Hardware_woken = false;
+	adc_clear_watchdog_flag(ADC_REG);
+	nvic_clear_pending_irq(ADC_IRQ);
+	nvic_enable_irq(ADC_IRQ);
+
+	return true;
+}
+
+/* Sleeps until Hardware_GetMillis reaches millis or a joystick is pushed, returns whether one was */
+bool Hardware_SleepUntilWoken(uint32_t millis) {
+	SLEEP_WHILE(!Hardware_woken && (int32_t)(millis - Hardware_millis) > 0);
+
+	return Hardware_woken;
+}
+
+/* Ends the idle state, starting the joystick filters again from fresh samples */
+/* So the push which woke the board only steers once it has lasted JOYSTICK_DEBOUNCE samples, as any other would */
+void Hardware_StopIdle() {
+	nvic_disable_irq(ADC_IRQ);
+
+	for (int player = 0; player < Hardware_players; player++) {
+		Joystick_Init(&Hardware_joysticks[player]);
+	}
+	nvic_enable_irq(ADC_DMA_IRQ);
+}
+
+/* Called by the analog watchdog when a joystick is pushed whilst idle */
+/* The watchdog flags every conversion outside the thresholds, so it is only listened to once */
+void adc1_2_isr() {
+	if (!adc_get_watchdog_flag(ADC_REG)) {
+		return;
+	}
+
+	nvic_disable_irq(ADC_IRQ);
+	adc_clear_watchdog_flag(ADC_REG);
+	Hardware_woken = true;
+
+#if PROFILE
+	Hardware_wokenCycles = Profile_Cycles();
+	Hardware_wakePending = true;
+#endif
+}
+
+/* Keeps the recording of a game */
+/* There is nowhere to put it on the board, so it stays in RAM (Game_recordingLog) for a debugger to dump */
+void Hardware_SaveRecording(const uint8_t* log, int length) {
+	(void)log;
+	(void)length;
+}
+
+/* Starts taking the bytes the PC streams into a ring, one interrupt a byte */
+/* At STREAM_BAUD that is an interrupt every 22 us, 170 cycles at 8 MHz, of which the interrupt takes a few dozen */
+struct Stream_Ring* Hardware_OpenStream() {
+	Stream_InitRing(&Hardware_streamRing);
+
+	Hardware_SetupHostUsart(STREAM_BAUD);
+	usart_enable_rx_interrupt(STATS_USART);
+	nvic_enable_irq(STATS_IRQ);
+
+	return &Hardware_streamRing;
+}
+
+/* Sleeps until more than available bytes of the stream have come in, returning true as the PC can always send more */
+/* The check is made with interrupts masked, so a byte coming in just before the sleep still wakes it */
+bool Hardware_WaitForStream(uint32_t available) {
+	SLEEP_WHILE(Stream_Available(&Hardware_streamRing) <= available);
+
+	return true;
+}
+
+/* Sends the replies of the board to the PC, a couple of bytes at a time */
+void Hardware_SendToHost(const uint8_t* bytes, int length) {
+	for (int i = 0; i < length; i++) {
+		usart_send_blocking(STATS_USART, bytes[i]);
+	}
+}
+
+/* Called by STATS_USART for every byte from the PC */
+void usart2_exti26_isr() {
+	// A byte which came in whilst the last one was still there stops the USART receiving until this is cleared
+	if (usart_get_flag(STATS_USART, USART_ISR_ORE)) {
+		USART_ICR(STATS_USART) = USART_ICR_ORECF;
+		Hardware_streamRing.overruns++;
+	}
+
+	while (usart_get_flag(STATS_USART, USART_ISR_RXNE)) {
+		Stream_Push(&Hardware_streamRing, usart_recv(STATS_USART));
+	}
+}
+
+#if PROFILE
+/* Checks whether the PC has sent PROFILE_REQUEST since this was last called */
+/* Polled once a tick, anything else received is dropped */
+bool Hardware_StatsRequested() {
+	bool requested = false;
+
+	while (usart_get_flag(STATS_USART, USART_ISR_RXNE)) {
+		requested |= usart_recv(STATS_USART) == PROFILE_REQUEST;
+	}
+
+	return requested;
+}
+
+/* Sends a stats record to the PC, waiting for the USART (83 bytes take 7 ms at 115200 baud) */
+void Hardware_SendStats(const uint8_t* record, int length) {
+	for (int i = 0; i < length; i++) {
+		usart_send_blocking(STATS_USART, record[i]);
+	}
+}
+#endif
+
+/* Called by SysTick every millisecond */
+void sys_tick_handler() {
+	Hardware_millis++;
+}
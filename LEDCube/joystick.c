@@ -0,0 +1,62 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "joystick.h"
+
+/* JOYSTICK FUNCTIONS */
+/* Gets the DirectionChange a single sample of channels 1 and 2 is pointing in */
+/* And how far past its threshold the deflection is in strength */
+enum DirectionChange Joystick_Classify(int channel1, int channel2, int* strength) {
+	if (channel2 > JOYSTICK_HIGH) { // If controller to the left
+		*strength = channel2 - JOYSTICK_HIGH;
+		return LEFT;
+	} else if (channel2 < JOYSTICK_LOW) { // Joystick moved to right
+		*strength = JOYSTICK_LOW - channel2;
+		return RIGHT;
+	} else if (channel1 > JOYSTICK_HIGH) { // Joystick moved up
+		*strength = channel1 - JOYSTICK_HIGH;
+		return UP;
+	} else if (channel1 < JOYSTICK_LOW) { // Joystick moved down
+		*strength = JOYSTICK_LOW - channel1;
+		return DOWN;
+	} else { // Joystick not moved enough in any particular direction
+		*strength = 0;
+		return CENTRE;
+	}
+}
+
+/* Start a joystick at rest */
+void Joystick_Init(struct Joystick* joystick) {
+	joystick->candidate = CENTRE;
+	joystick->candidateSamples = 0;
+	joystick->latched = CENTRE;
+	joystick->latchedStrength = 0;
+}
+
+/* Add the next sample of channels 1 and 2 to the filter */
+void Joystick_Feed(struct Joystick* joystick, int channel1, int channel2) {
+	int strength;
+	enum DirectionChange direction = Joystick_Classify(channel1, channel2, &strength);
+
+	// Debounce by counting how many samples in a row point the same way
+	if (direction == joystick->candidate) {
+		joystick->candidateSamples++;
+	} else {
+		joystick->candidate = direction;
+		joystick->candidateSamples = 1;
+	}
+
+	// Latch the deflection if it has lasted long enough and is the strongest one yet
+	if (direction != CENTRE && joystick->candidateSamples >= JOYSTICK_DEBOUNCE && strength > joystick->latchedStrength) {
+		joystick->latched = direction;
+		joystick->latchedStrength = strength;
+	}
+}
+
+/* Gets the strongest deflection since the last call, and starts looking for a new one */
+enum DirectionChange Joystick_Take(struct Joystick* joystick) {
+	enum DirectionChange direction = joystick->latched;
+
+	joystick->latched = CENTRE;
+	joystick->latchedStrength = 0;
+
+	return direction;
+}
@@ -0,0 +1,37 @@
+/* Turns raw ADC readings of the joystick into the direction changes the game understands */
+/* Samples are debounced and the strongest deflection since the direction was last taken is latched, */
+/* so a flick of the joystick between two ticks of the game is not lost */
+#ifndef JOYSTICK_H
+#define JOYSTICK_H
+
+/* DEFINING MACROS */
+#define JOYSTICK_LOW 1500 // Readings below this are a deflection towards 0
+#define JOYSTICK_HIGH 2500 // Readings above this are a deflection towards the maximum
+#define JOYSTICK_CENTRE 2048 // Reading of a channel at rest
+#define JOYSTICK_DEBOUNCE 4 // Number of samples in a row a deflection has to last to count
+
+/* STRUCTS AND ENUMS */
+/* Enum to interface between logic of program and analogue values of joystick */
+enum DirectionChange {
+	RIGHT,
+	LEFT,
+	UP,
+	DOWN,
+	CENTRE,
+};
+
+/* State of the filter of one joystick */
+struct Joystick {
+	enum DirectionChange candidate; // Direction of the latest samples
+	int candidateSamples; // Number of samples in a row in that direction
+	enum DirectionChange latched; // Strongest debounced deflection since the last Joystick_Take
+	int latchedStrength; // How far that deflection was past its threshold
+};
+
+/* FUNCTION DECLARATIONS */
+enum DirectionChange Joystick_Classify(int channel1, int channel2, int* strength);
+void Joystick_Init(struct Joystick* joystick);
+void Joystick_Feed(struct Joystick* joystick, int channel1, int channel2);
+enum DirectionChange Joystick_Take(struct Joystick* joystick);
+
+#endif
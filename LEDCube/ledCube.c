@@ -1,490 +1,584 @@
 /* INCLUDING NECESSARY LIBRARIES */
-#include "libopencm3/stm32/rcc.h" // Needed to enable clocks for particular GPIO ports
-#include "libopencm3/stm32/gpio.h" // Needed to define things on the GPIO
-#include "libopencm3/stm32/usart.h" // Needed to use USART
-#include "libopencm3/stm32/adc.h" // Needed to convert analogue signals to digital
+#include "hardware.h" // Needed to interact with the LED cube and joystick
+#include "game.h" // Needed for the logic of the game itself
+#include "frame.h" // Needed to encode the cube map into frames for the cube
+#include "scheduler.h" // Needed to run the game at a steady speed
+#include "joystick.h" // Needed for the direction changes coming from the joystick
+#include "profile.h" // Needed to time the phases of a tick when profiling
+#include "recording.h" // Needed to record the game so it can be replayed
+#include "bam.h" // Needed to show brightness on cubes which only know on and off
+#include "autopilot.h" // Needed to play the game without anyone at the joysticks
+#include "stream.h" // Needed to show animations streamed from a PC
+#include "anim.h" // Needed to play the animations built into the firmware
 
 #include <stdio.h>
-#include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 /* DEFINING MACROS */
-#define LEDCUBE_PORT GPIOB
-#define TX_PIN GPIO6
-#define RX_PIN GPIO7
-#define USART_PORT USART1
-#define NUM_LEDS 512
-#define ADC_REG ADC1
-
-#define WIN_LENGTH 100
-
-/* STRUCTS AND ENUMS */
-enum CellState { EMPTY, APPLE, SNAKE, WALL };
-
-/* Enum to interface between logic of program and analogue values of joystick */
-enum DirectionChange {
-	RIGHT,
-	LEFT,
-	UP,
-	DOWN,
-	CENTRE,
-};
-
-/* Struct to representing a single segment of the snake */
-struct Snake_Segment {
-	/* Position of snake */
-	int x;
-	int y;
-	int z;
-
-	/* Next and previous segments of snake */
-	struct Snake_Segment* Next;
-	struct Snake_Segment* Prev;
-};
+/* Time between steps of the snake in milliseconds, and what to do about steps which are late */
+#ifndef TICK_MILLIS
+#define TICK_MILLIS 1000
+#endif
+#define TICK_POLICY SCHEDULER_SKIP
+
+/* Whether the cube firmware understands delta frames (see frame.h), the stock firmware only takes full frames */
+#ifndef DELTA_FRAMES
+#define DELTA_FRAMES 0
+#endif
+
+/* Number of players, each with a joystick and a snake of their own, and of cubes they play on */
+/* The players are shared out over the cubes in order, each cube being a game of its own for PLAYERS / CUBES of them */
+#ifndef PLAYERS
+#define PLAYERS 1
+#endif
+#ifndef CUBES
+#define CUBES 1
+#endif
+#define SNAKES_PER_CUBE (PLAYERS / CUBES)
+
+#if CUBES < 1 || CUBES > HARDWARE_MAX_CUBES || PLAYERS > HARDWARE_MAX_PLAYERS || PLAYERS % CUBES != 0
+#error "PLAYERS has to be a multiple of CUBES, and the board only has HARDWARE_MAX_CUBES and HARDWARE_MAX_PLAYERS"
+#endif
+#if SNAKES_PER_CUBE > GAME_MAX_SNAKES
+#error "more snakes on a cube than GAME_MAX_SNAKES"
+#endif
+
+/* Whether LEDs are shown at different brightnesses (see bam.h), the apple dimmer than the snakes and a win fading in */
+/* This sends several frames a tick, each plane of brightness in turn, so it takes far more of the link */
+#ifndef GREYSCALE
+#define GREYSCALE 0
+#endif
+#define SNAKE_LEVEL BAM_MAX_LEVEL
+#define APPLE_LEVEL 3
+#define WIN_FADE_MILLIS 2000 // Time taken by the cube of a winner to fade in to every LED fully on
+
+/* Whether the snakes steer themselves (see autopilot.h) rather than follow the joysticks, to run the cube as a demo */
+#ifndef AUTOPILOT
+#define AUTOPILOT 0
+#endif
+
+/* Whether the board shows animations a PC streams to it (see stream.h) rather than playing the game */
+#ifndef STREAM
+#define STREAM 0
+#endif
+#if STREAM && PROFILE
+#error "STREAM and PROFILE both talk to the PC over the same USART"
+#endif
+
+/* Time the cubes are left showing how a game ended before the attract animation, and between runs of it */
+#define ATTRACT_PAUSE_MILLIS 2000
+
+/* Bytes kept for the recording of a game, enough for hours of play at a tick a second */
+/* Only the game on the first cube is recorded, and only with one snake on it as a recording has a single input a tick */
+#define RECORDING_SIZE 4096
+#define RECORDING (SNAKES_PER_CUBE == 1)
 
 /* FUNCTION DECLARATIONS */
-enum DirectionChange Controller_GetDirection(void);
+enum DirectionChange Controller_GetDirection(int player);
 
 void Game_Over(void);
 void Game_Start(void);
-
-void Cube_SetBitAt(int x, int y, int z);
-void Cube_ClearBitAt(int x, int y, int z);
-bool Cube_IsBitOnAt(int x, int y, int z);
-void Cube_GenerateApple(void);
-enum CellState Cube_GetCellStateAt(int x, int y, int z);
-bool Cube_DimensionOutOfBounds(int d);
-bool Cube_IsSnakeSegment(int x, int y, int z);
-void Cube_SetAll(void);
-
-void Snake_Init(int x, int y, int z);
-void Snake_Turn(enum DirectionChange directionChange);
-bool Snake_Step(void);
-void Snake_Free(void);
-void Snake_AddHead(int x, int y, int z);
-void Snake_PopTail(void);
-void Snake_NormalStep(int x, int y, int z);
-void Snake_AppleStep(int x, int y, int z);
-
-void Hardware_Setup(void);
-int Hardware_ReadChannel(int channel);
-void Hardware_RenderCube(void);
+bool Game_Tick(void);
+bool Game_Render(int cube);
+void Game_SendMap(int cube, const Cube_Column* map, const uint64_t* dirty);
+void Game_Shade(int cube);
+void Game_SendPlane(int cube, int plane, int lowestPlane);
+void Game_ShowPlanes(uint32_t until);
+void Game_FadeIn(void);
+bool Game_PlayAnimation(enum Anim_Name name, uint32_t cubes, bool wakeable);
+bool Game_Attract(void);
+void Game_PlayStream(void);
+#if PROFILE
+void Game_SendStats(bool always);
+#endif
 
 /* GLOBAL VARIABLES */
-/* Variables for linked list representing snake */
-int Snake_size = 0;
-struct Snake_Segment* Snake_head;
-struct Snake_Segment* Snake_tail;
+/* The game being played on each cube, and how it stands */
+struct GameState Game_states[CUBES];
+enum GameResult Game_results[CUBES];
+
+/* Paces the game loop */
+struct Scheduler Game_scheduler;
+
+/* Turns the cube map of each of Game_states into the frames sent to its cube */
+struct Frame_Encoder Game_encoders[CUBES];
+
+/* Brightness of every LED of each cube when GREYSCALE, the planes of which are sent in turn by Game_bam */
+struct Bam_Framebuffer Game_framebuffers[CUBES];
+struct Bam_Scheduler Game_bam;
+int Game_winLevel; // Brightness of the cube of a winner, which Game_FadeIn brings up
 
-/* Current (x, y, z) direction of snake */
-int Snake_currentDirection[3] = {1, 0, 0};
+#if AUTOPILOT
+/* Steers the snake of each player */
+struct Autopilot Controller_autopilots[PLAYERS];
+#endif
 
-/* This array is a representation of the cube and is rendered */
-char Cube_map[64];
+/* Frame of a built in animation being played, shared by every cube playing it */
+Cube_Column Game_animationMap[CUBE_COLUMNS];
+
+/* Reads the animations streamed from the PC when STREAM */
+struct Stream_Reader Game_streamReader;
+
+/* Recording of the inputs of the game on the first cube */
+uint8_t Game_recordingLog[RECORDING_SIZE];
+struct Recording Game_recording;
 
 /* CONTROLLER FUNCTIONS */
-/* Function to interface between program and joystick */
-/* By getting appropriate DirectionChange depending on value of joystick */
-enum DirectionChange Controller_GetDirection() {
-	// Read appropriate channels
-	int channel1 = Hardware_ReadChannel(1);
-	int channel2 = Hardware_ReadChannel(2);
-
-	if (channel2 > 2500) { // If controller to the left
-		return LEFT;
-	} else if (channel2 < 1500) { // Joystick moved to right
-		return RIGHT;
-	} else if (channel1 > 2500) { // Joystick moved up
-		return UP;
-	} else if (channel1 < 1500) { // Joystick moved down
-		return DOWN;
-	} else { // Joystick not moved enough in any particular direction
+/* Function to interface between program and the joystick of a player */
+/* The joysticks are sampled continuously in the background and filtered by joystick.c */
+/* So this only takes the strongest deflection since the last tick, without waiting on the ADC */
+/* With AUTOPILOT the snake of the player steers itself instead, which takes a bounded share of the tick */
+enum DirectionChange Controller_GetDirection(int player) {
+#if AUTOPILOT
+	struct GameState* game = &Game_states[player / SNAKES_PER_CUBE];
+	struct Snake* snake = &game->snakes[player % SNAKES_PER_CUBE];
+
+	if (snake->result != GAME_PLAYING) {
 		return CENTRE;
 	}
+
+	return Autopilot_Choose(&Controller_autopilots[player], game, snake);
+#else
+	return Hardware_ReadJoystick(player);
+#endif
 }
 
 /* GAME FUNCTIONS */
 /* Runs functions needed to be called at end of game */
 void Game_Over() {
-	// Cleanup memory
-	Snake_Free();
-}
-
-/* Called when game is started, all the logic of the game stems from here */
-void Game_Start() {
-	Snake_Init(0, 5, 5); // Initialize snake such that its tail is at the position (0, 5, 5)
-			     // And its head is one step in the current direction
+	// Leave every cube showing all its lit LEDs, rather than whichever plane it was on, fading in those of winners
+	if (GREYSCALE) {
+		Game_FadeIn();
 
-	// Game loop
-	while (true) {
-		Snake_Turn(Controller_GetDirection()); // Turn (or continue forwards) snake depending on joystick
+		for (int cube = 0; cube < CUBES; cube++) {
+			Game_SendPlane(cube, BAM_BITS - 1, BAM_BITS - 1);
+		}
+	}
 
-		// Try and move the snake in its current direction, otherwise end the game
-		if (!Snake_Step()) {
-			break;
+	// Play the win animation on the cube of every winner, which ends with every LED on
+	uint32_t winners = 0;
+	for (int cube = 0; cube < CUBES; cube++) {
+		if (Game_results[cube] == GAME_WON) {
+			winners |= 1U << cube;
 		}
+	}
+	Game_PlayAnimation(ANIM_WIN, winners, false);
 
-		Hardware_RenderCube(); // Render snake onto map
+	// Make sure the last frames have reached the cubes
+	Hardware_FlushCubes();
 
-		// If win condition is met (snake length is at WIN_LENGTH)
-		if (Snake_size == WIN_LENGTH) {
-			// Set all LEDs on to indicate the player has won
-			Cube_SetAll();
-			Hardware_RenderCube();
+	// A cube which was still busy at its last render was left the changes for the next one, which there now is not
+	// So they are sent now that every cube is ready, or the cube would show the game a tick or more before it ended
+	if (!GREYSCALE) {
+		bool rendered = false;
 
-			// And end the game loop
-			break;
-		}
+		for (int cube = 0; cube < CUBES; cube++) {
+			uint64_t dirty = 0;
+			for (int i = 0; i < CUBE_DIRTY_WORDS; i++) {
+				dirty |= Game_states[cube].cube.dirty[i];
+			}
 
-		for (volatile unsigned int tmr=1e6; tmr > 0; tmr--); // Sleep for 1 second
-	};
+			if (dirty != 0 && !(winners & 1U << cube)) {
+				rendered |= Game_Render(cube);
+			}
+		}
 
-	Game_Over();
-}
+		if (rendered) {
+			Hardware_FlushCubes();
+		}
+	}
 
-/* CUBE FUNCTIONS */
-/* Sets bit corresponding to x, y, z position */
-void Cube_SetBitAt(int x, int y, int z) {
-	int i = 8 * y + x;
-	Cube_map[i] = Cube_map[i] | 1 << z;
-}
+#if PROFILE
+	// Send whatever was timed since the stats were last asked for
+	Game_SendStats(true);
+#endif
 
-/* Clears bit corresponding to x, y, z position */
-void Cube_ClearBitAt(int x, int y, int z) {
-	int i = 8 * y + x;
-	Cube_map[i] = Cube_map[i] & ~(1 << z);
-}
+	// Keep the recording of the game so that it can be replayed
+	if (RECORDING) {
+		int length = Recording_Finish(&Game_recording, Game_results[0]);
+		Hardware_SaveRecording(Game_recordingLog, length);
+	}
 
-/* Gets bit corresponding to x, y, z position */
-bool Cube_IsBitOnAt(int x, int y, int z) {
-	int i = 8 * y + x;
-	return Cube_map[i] & 1 << z;
+	// Reset the snakes
+	for (int cube = 0; cube < CUBES; cube++) {
+		for (int i = 0; i < SNAKES_PER_CUBE; i++) {
+			Snake_Free(&Game_states[cube].snakes[i]);
+		}
+	}
 }
 
-/* Generates an apple on a random non-snake position on the map */
-void Cube_GenerateApple() {
-	int x, y, z;
+/* Called when game is started, all the logic of the game stems from here */
+void Game_Start() {
+	// Start from empty cubes, with apples placed according to the seed of this game (and the cube, if there are more)
+	uint32_t seed = Hardware_GetSeed();
+	for (int cube = 0; cube < CUBES; cube++) {
+		Game_InitPlayers(&Game_states[cube], seed + cube, SNAKES_PER_CUBE);
+		Game_results[cube] = GAME_PLAYING;
+		Frame_InitEncoder(&Game_encoders[cube], DELTA_FRAMES);
+	}
+#if AUTOPILOT
+	for (int player = 0; player < PLAYERS; player++) {
+		Autopilot_Init(&Controller_autopilots[player]);
+	}
+#endif
+	if (RECORDING) {
+		Recording_Start(&Game_recording, Game_recordingLog, RECORDING_SIZE, seed, Game_states[0].winLength);
+	}
 
-	// Pick a random position until that random positions corresponding bit is not 1
-	do {
-		x = rand() % 8;
-		y = rand() % 8;
-		z = rand() % 8;
-	} while (Cube_IsBitOnAt(x, y, z) != 0);
+	Scheduler_Init(&Game_scheduler, TICK_MILLIS, TICK_POLICY);
 
-	// Set the bit at the chosen position
-	Cube_SetBitAt(x, y, z);
-}
+	// Every plane has to be sent in its own unit of time, and the slowest link decides how long that is
+	if (GREYSCALE) {
+		uint32_t frameMicros = 0;
+		for (int cube = 0; cube < CUBES; cube++) {
+			uint32_t micros = Hardware_FrameMicros(cube, FRAME_MAX_SIZE);
+			frameMicros = micros > frameMicros ? micros : frameMicros;
+		}
 
-/* Checks if a variable of a dimension (x, y or z) is within the valid range */
-bool Cube_DimensionOutOfBounds(int d) {
-	if (d < 0 || d >= 8) {
-		return true;
+		Bam_InitScheduler(&Game_bam, (frameMicros + 999) / 1000, TICK_MILLIS, Hardware_GetMillis());
+		Game_winLevel = 1;
 	}
 
-	return false;
-}
+#if PROFILE
+	Profile_Reset();
+#endif
 
-/* Checks if a position on the map is a segment of the snake */
-bool Cube_IsSnakeSegment(int x, int y, int z) {
-	// Make a copy of the Snake_head pointer we can manipulate
-	struct Snake_Segment* current = Snake_head;
+	// Game loop
+	bool playing = true;
+	while (playing) {
+		// Cycle through the planes of brightness until the next tick is due
+		if (GREYSCALE) {
+			Game_ShowPlanes(Game_scheduler.nextTick);
+		}
 
-	// Iterate through all segments of the linked list representing the snake
-	while (current != NULL) {
-		// If any of their positions match with given position return true
-		if (x == current->x && y == current->y && z == current->z) {
-			return true;
+		// Sleep until the next tick is due, then run it (and any missed ones if the scheduler catches up)
+		int ticks = Scheduler_WaitForTick(&Game_scheduler);
+
+		for (int tick = 0; tick < ticks && playing; tick++) {
+			PROFILE_BEGIN(tickStart);
+			playing = Game_Tick();
+			PROFILE_END(PROFILE_TICK, tickStart);
 		}
 
-		current = current->Next;
-	}
+#if PROFILE
+		// Outside of the timed ticks, as sending the stats takes a while
+		Game_SendStats(false);
+#endif
+	};
 
-	return false;
+	Game_Over();
 }
 
-/* Gets cell state (WALL, SNAKE, APPLE, EMPTY) of position */
-enum CellState Cube_GetCellStateAt(int x, int y, int z) {
-	// Check if given position is within valid bounds of the cube
-	if (Cube_DimensionOutOfBounds(x) || Cube_DimensionOutOfBounds(y) || Cube_DimensionOutOfBounds(z)) {
-		return WALL;
+/* Runs one step of the game on every cube still playing, returns whether any of them carries on */
+bool Game_Tick() {
+	enum DirectionChange directionChanges[PLAYERS];
+	bool stepped[CUBES];
+	bool won = false;
+	bool playing = false;
+
+	PROFILE_BEGIN(inputStart);
+	for (int player = 0; player < PLAYERS; player++) {
+		directionChanges[player] = Controller_GetDirection(player);
+	}
+	PROFILE_END(PROFILE_INPUT, inputStart);
+
+	// Turn (or continue forwards) every snake depending on its joystick, then try and move it
+	PROFILE_BEGIN(stepStart);
+	for (int cube = 0; cube < CUBES; cube++) {
+		stepped[cube] = Game_results[cube] == GAME_PLAYING;
+		if (stepped[cube]) {
+			Game_results[cube] = Game_StepPlayers(&Game_states[cube], directionChanges + cube * SNAKES_PER_CUBE);
+		}
+	}
+	PROFILE_END(PROFILE_STEP, stepStart);
+
+	if (RECORDING && stepped[0]) {
+		Recording_Tick(&Game_recording, directionChanges[0], Game_states[0].cube.map);
+	}
+
+	// Render every game which carries on (unless its cube is still busy with the last frame)
+	// The frames of every cube are started before waiting on any, so they go over their links at the same time
+	// A game where every snake ran into something ends without rendering that last step
+	PROFILE_BEGIN(renderStart);
+	for (int cube = 0; cube < CUBES; cube++) {
+		if (stepped[cube] && (Game_results[cube] == GAME_PLAYING || Game_results[cube] == GAME_WON)) {
+			Game_Render(cube);
+		}
 	}
+	PROFILE_END(PROFILE_RENDER, renderStart);
 
-	// Check if given position corresponds to a snake segment or an apple and handle appropriately if so
-	if (Cube_IsBitOnAt(x, y, z)) {
-		if (Cube_IsSnakeSegment(x, y, z)) {
-			return SNAKE;
+	for (int cube = 0; cube < CUBES; cube++) {
+		// Set all LEDs on to indicate a player has won
+		if (stepped[cube] && Game_results[cube] == GAME_WON) {
+			Cube_SetAll(&Game_states[cube]);
+			won = true;
 		}
 
-		return APPLE;
+		playing |= Game_results[cube] == GAME_PLAYING;
 	}
 
-	// None of previous conditions were met so given position corresponds to an empty cell
-	return EMPTY;
-}
+	if (won) {
+		Hardware_FlushCubes();
 
-void Cube_SetAll() {
-	// Set all cells to ON in Cube_map
-	for (int i = 0; i < 64; i++) {
-		Cube_map[i] = 1;
+		for (int cube = 0; cube < CUBES; cube++) {
+			if (stepped[cube] && Game_results[cube] == GAME_WON) {
+				Game_Render(cube);
+			}
+		}
 	}
-}
 
-/* SNAKE FUNCTIONS*/
-/* Initializes linked list representing snake with Snake_tail at given position */
-/* And Snake_head the position it is facing with currentDirection */
-void Snake_Init(int x, int y, int z) {
-	// Initialize Snake_head and Snake_tail pointers
-	Snake_head = (struct Snake_Segment*)malloc(sizeof(struct Snake_Segment));
-	Snake_tail = Snake_head;
-
-	// Assign given position to Snake_head
-	Snake_head->x = x;
-	Snake_head->y = y;
-	Snake_head->z = z;
-
-	// Set bit on map corresponding to position
-	Cube_SetBitAt(x, y, z);
-
-	// As there is currently only one segment, set next and previous segments to NULL
-	Snake_head->Next = NULL;
-	Snake_head->Prev = NULL;
-
-	// Initialize Snake_size as 1
-	Snake_size = 1;
-
-	// Move the snake once in its current direction using the same logic as if it ate an apple
-	// So that it starts at a length of 2 and an apple is randomly generated on the map
-	int newX = Snake_head->x + Snake_currentDirection[0];
-	int newY = Snake_head->y + Snake_currentDirection[1];
-	int newZ = Snake_head->z + Snake_currentDirection[2];
-	Snake_AppleStep(newX, newY, newZ);
+	// The game loop ends once the games on every cube have
+	return playing;
 }
 
-/* Add head of linked list representing snake at the given position */
-void Snake_AddHead(int x, int y, int z) {
-	// Change the map accordingly
-	Cube_SetBitAt(x, y, z);
+/* Sends whatever has changed in the cube map of the given cube to it */
+/* Returns false without sending if the cube is still busy, the changes are then sent with the next render */
+bool Game_Render(int cube) {
+	struct GameState* game = &Game_states[cube];
+
+	if (!Hardware_CubeReady(cube)) {
+		return false;
+	}
+
+	// A cube which lost a frame needs a full one, as any delta frame after it would leave the cube wrong
+	if (Hardware_KeyframeNeeded(cube)) {
+		Game_encoders[cube].keyframeNeeded = true;
+	}
 
-	// Allocate some new memory for the new segment to be pushed in
-	struct Snake_Segment* newHead = (struct Snake_Segment*)malloc(sizeof(struct Snake_Segment));
+	if (GREYSCALE) {
+		Game_Shade(cube);
+		Game_SendPlane(cube, Game_bam.plane, Game_bam.lowestPlane);
+	} else {
+		Game_SendMap(cube, game->cube.map, game->cube.dirty);
+	}
+	memset(game->cube.dirty, 0, sizeof(game->cube.dirty));
 
-	// Initialize the position of the new head at given position
-	newHead->x = x;
-	newHead->y = y;
-	newHead->z = z;
+	return true;
+}
 
-	// Set connections of the new head segment appropriately
-	newHead->Next = Snake_head;
-	newHead->Prev = NULL;
+/* Sends whatever has changed in map to the given cube, dirty marking the columns which may have (see Frame_Encode) */
+void Game_SendMap(int cube, const Cube_Column* map, const uint64_t* dirty) {
+	uint8_t frame[FRAME_MAX_SIZE];
 
-	// Edit connections of the previous head appropriately
-	Snake_head->Prev = newHead;
+	int length = Frame_Encode(&Game_encoders[cube], map, dirty, frame);
 
-	// Reassign variable containing the pointer to the head of the snake to the new head
-	Snake_head = newHead;
+	if (length > 0) {
+		Hardware_SendFrame(cube, frame, length);
+	}
 }
 
-/* Pop tail of linked list representing snake */
-void Snake_PopTail() {
-	// Clear bit accordingly
-	Cube_ClearBitAt(Snake_tail->x, Snake_tail->y, Snake_tail->z);
+/* BRIGHTNESS FUNCTIONS */
+/* Works out the brightness of every LED of the given cube from its game */
+void Game_Shade(int cube) {
+	const struct GameState* game = &Game_states[cube];
+	struct Bam_Framebuffer* framebuffer = &Game_framebuffers[cube];
+	int apple = game->cube.apple;
 
-	// Set tail to be second last element in linked list
-	Snake_tail = Snake_tail->Prev;
+	Bam_Clear(framebuffer);
 
-	free(Snake_tail->Next); // Free memory used by previous tail
+	// The cube of a winner is every LED at once, see Game_FadeIn
+	if (Game_results[cube] == GAME_WON) {
+		Bam_FillMap(framebuffer, game->cube.map, Game_winLevel);
+		return;
+	}
 
-	// New tail is no longer connected to the previous tail
-	Snake_tail->Next = NULL;
+	Bam_FillMap(framebuffer, game->cube.map, SNAKE_LEVEL);
+	if (apple != NO_APPLE) {
+		Bam_SetLevel(framebuffer, CELL_X(apple), CELL_Y(apple), CELL_Z(apple), APPLE_LEVEL);
+	}
 }
 
-/* Called when snake takes a normal step with the new head assumed to be at the given position*/
-void Snake_NormalStep(int x, int y, int z) {
-	// When a normal step is taken, we insert the new head and pop the current tail
-	Snake_AddHead(x, y, z);
-	Snake_PopTail();
-}
+/* Sends a plane of brightness of the given cube, unless it is already showing it */
+void Game_SendPlane(int cube, int plane, int lowestPlane) {
+	Cube_Column map[CUBE_COLUMNS];
+	uint64_t dirty[CUBE_DIRTY_WORDS];
+
+	Bam_GetPlane(&Game_framebuffers[cube], plane, lowestPlane, map);
 
-/* Called when snake eats an apple with the new head assumed to be at the given position */
-void Snake_AppleStep(int x, int y, int z) {
-	// When snake eats an apple, its size increases by one and we insert a new head
-	Snake_AddHead(x, y, z);
-	Snake_size++;
+	// A plane the same as the one before (as all of them are for a cube which is all on or off) costs nothing
+	if (!Game_encoders[cube].keyframeNeeded && memcmp(map, Game_encoders[cube].shown, sizeof(map)) == 0) {
+		return;
+	}
 
-	// Generate an apple
-	Cube_GenerateApple();
+	memset(dirty, 0xFF, sizeof(dirty));
+	Game_SendMap(cube, map, dirty);
 }
 
-/* Change currentDirection depending on directionChange */
-void Snake_Turn(enum DirectionChange directionChange) {
-	switch (directionChange) {
-		case LEFT:
-			// If snake was going inwards or outwards, set direction to absolute left
-			if (Snake_currentDirection[2] == 1 || Snake_currentDirection[2] == -1) {
-				Snake_currentDirection[0] = 0;
-				Snake_currentDirection[1] = -1;
-				Snake_currentDirection[2] = 0;
-			// Otherwise turn left relative to current direction
-			} else {
-				Snake_currentDirection[2] = Snake_currentDirection[0];
-				Snake_currentDirection[0] = Snake_currentDirection[1];
-				Snake_currentDirection[1] = -Snake_currentDirection[2];
-
-				Snake_currentDirection[2] = 0;
-			}
+/* Sends each plane of every cube still playing (or won) when it is due, until the given time */
+void Game_ShowPlanes(uint32_t until) {
+	while ((int32_t)(until - Game_bam.nextPlane) > 0) {
+		Hardware_SleepUntil(Game_bam.nextPlane);
+		int plane = Bam_Advance(&Game_bam, Hardware_GetMillis());
 
-			break;
-		case RIGHT:
-			// If snake was going inwards or outwards, set direction to absolute right
-			if (Snake_currentDirection[2] == 1 || Snake_currentDirection[2] == -1) {
-				Snake_currentDirection[0] = 0;
-				Snake_currentDirection[1] = 1;
-				Snake_currentDirection[2] = 0;
-			// Otherwise turn right relative to current direction
-			} else {
-				Snake_currentDirection[2] = Snake_currentDirection[0];
-				Snake_currentDirection[0] = -Snake_currentDirection[1];
-				Snake_currentDirection[1] = Snake_currentDirection[2];
-
-				Snake_currentDirection[2] = 0;
+		for (int cube = 0; cube < CUBES; cube++) {
+			if (Game_results[cube] == GAME_PLAYING || Game_results[cube] == GAME_WON) {
+				Game_SendPlane(cube, plane, Game_bam.lowestPlane);
 			}
+		}
+	}
+}
 
-			break;
-		case UP:
-			// If snake is not currently going inwards, set the direction to inwards
-			if (!(Snake_currentDirection[2] == -1)) {
-				Snake_currentDirection[0] = 0;
-				Snake_currentDirection[1] = 0;
-				Snake_currentDirection[2] = 1;
-			}
+/* Brings the cube of every winner up from dim to every LED fully on over WIN_FADE_MILLIS */
+void Game_FadeIn() {
+	uint32_t step = WIN_FADE_MILLIS / BAM_MAX_LEVEL;
+
+	for (int level = 1; level <= BAM_MAX_LEVEL; level++) {
+		Game_winLevel = level;
 
-			break;
-		case DOWN:
-			// If snake is not currently going outwards, set the direction to outwards
-			if (!(Snake_currentDirection[2] == 1)) {
-				Snake_currentDirection[0] = 0;
-				Snake_currentDirection[1] = 0;
-				Snake_currentDirection[2] = -1;
+		for (int cube = 0; cube < CUBES; cube++) {
+			if (Game_results[cube] == GAME_WON) {
+				Game_Shade(cube);
 			}
+		}
 
-			break;
-		case CENTRE:
-			// Don't change Snake_currentDirection
-			break;
+		Game_ShowPlanes(Hardware_GetMillis() + step);
 	}
 }
 
-/* Try and move one step in currentDirection */
-/* Return whether it succeeded */
-bool Snake_Step() {
-	// New position head of snake will be trying to go to
-	int newX = Snake_head->x + Snake_currentDirection[0];
-	int newY = Snake_head->y + Snake_currentDirection[1];
-	int newZ = Snake_head->z + Snake_currentDirection[2];
-
-	// Get the state of the cell and handle appropriately
-	enum CellState cellState = Cube_GetCellStateAt(newX, newY, newZ);
-	switch (cellState) {
-		case (WALL):
-		case (SNAKE):
-			return false;
-			break;
-		case (APPLE):
-			Snake_AppleStep(newX, newY, newZ);
-			break;
-		case (EMPTY):
-			Snake_NormalStep(newX, newY, newZ);
-			break;
+#if PROFILE
+/* Sends the stats of every phase if they were asked for (or always), then starts them again */
+void Game_SendStats(bool always) {
+	uint8_t record[PROFILE_MAX_RECORD_SIZE];
+
+	if (!always && !Hardware_StatsRequested()) {
+		return;
 	}
 
-	return true;
+	int length = Profile_Encode(record);
+	Hardware_SendStats(record, length);
+	Profile_Reset();
 }
-
-// Free memory of the linked list representing the snake at the end
-void Snake_Free() {
-	// Iterate through linked list representing snake
-	while (Snake_head != NULL) {
-		struct Snake_Segment* segment = Snake_head;
-		Snake_head = Snake_head->Next;
-		free(segment); // Free memory of segment
+#endif
+
+/* ANIMATION FUNCTIONS */
+/* Plays an animation built into the firmware on the cubes set in cubes (bit i being cube i), a frame as each is due */
+/* Only a frame is ever decoded at a time, straight into Game_animationMap, and only the columns it changes are sent */
+/* If wakeable it stops as soon as a joystick is pushed (see Hardware_SleepUntilWoken), returning whether one was */
+bool Game_PlayAnimation(enum Anim_Name name, uint32_t cubes, bool wakeable) {
+	const uint8_t* animation = Anim_Get(name);
+	struct Anim_Player player;
+	uint64_t dirty[CUBE_DIRTY_WORDS] = {0};
+
+	// The animations were made for another size of cube
+	if (animation == NULL || cubes == 0) {
+		return false;
 	}
-}
 
-/* HARDWARE FUNCTIONS */
-/* Setup everything to be able to interact with the hardware (the LED cube and a joystick) */
-void Hardware_Setup() {
-	//// Setup GPIO B
-	rcc_periph_clock_enable(RCC_GPIOB); // Enable clock for GPIO Port B
-					
-	gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO5); // GPIO Port Name, GPIO Mode, GPIO Push Up Pull Down Mode, GPIO Pin Number
-	gpio_set_output_options(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_100MHZ, GPIO5); // GPIO Port Name, GPIO Pin Driver Type, GPIO Pin Speed, GPIO Pin Number
+	uint32_t frameMillis = Anim_FrameMillis(animation);
+	uint32_t due = Hardware_GetMillis();
 
-	//// Setup LED cube pins
-	// Set B5
-	gpio_set(GPIOB, GPIO5);
+	Anim_Start(&player, animation, Game_animationMap, dirty);
+	while (true) {
+		PROFILE_BEGIN(animationStart);
+		bool more = Anim_NextFrame(&player, Game_animationMap, dirty);
+		PROFILE_END(PROFILE_ANIMATION, animationStart);
 
-	// Setup TX pin
-	gpio_mode_setup(LEDCUBE_PORT, GPIO_MODE_AF, GPIO_PUPD_NONE, TX_PIN);
-	gpio_set_af(LEDCUBE_PORT, GPIO_AF7, TX_PIN);
+		if (!more) {
+			return false;
+		}
 
-	// Setup RX pin
-	gpio_mode_setup(LEDCUBE_PORT, GPIO_MODE_AF, GPIO_PUPD_NONE, RX_PIN);
-	gpio_set_af(LEDCUBE_PORT, GPIO_AF7, RX_PIN);
+		for (int cube = 0; cube < CUBES; cube++) {
+			if (cubes >> cube & 1) {
+				if (Hardware_KeyframeNeeded(cube)) {
+					Game_encoders[cube].keyframeNeeded = true;
+				}
 
-	//// Setup USART
-	rcc_periph_clock_enable(RCC_USART1); // Enable clock for USART
+				Game_SendMap(cube, Game_animationMap, dirty);
+			}
+		}
+		memset(dirty, 0, sizeof(dirty));
 
-	usart_set_baudrate(USART_PORT, 9600);
-	usart_set_databits(USART_PORT, 8);
-	usart_set_stopbits(USART_PORT, USART_STOPBITS_1);
-	usart_set_mode(USART_PORT, USART_MODE_TX_RX);
-	usart_set_parity(USART_PORT, USART_PARITY_NONE);
-	usart_set_flow_control(USART_PORT, USART_FLOWCONTROL_NONE);
+		due += frameMillis;
+		if (!wakeable) {
+			Hardware_SleepUntil(due);
+		} else if (Hardware_SleepUntilWoken(due)) {
+			return true;
+		}
+	}
+}
 
-	usart_enable_rx_interrupt(USART_PORT);
-	usart_enable_tx_interrupt(USART_PORT);
+/* IDLE FUNCTIONS */
+/* Waits between games with the core asleep, playing the attract animation on every cube until a joystick is pushed */
+/* With AUTOPILOT nobody need be there to push one, so the next game starts after the animation has played once */
+/* Returns false if nothing will ever push one, which only happens on the host once LEDCUBE_GAMES have been played */
+bool Game_Attract() {
+	if (!Hardware_StartIdle()) {
+		return false;
+	}
 
-	usart_enable(USART_PORT);
+	bool woken = Hardware_SleepUntilWoken(Hardware_GetMillis() + ATTRACT_PAUSE_MILLIS);
+	while (!woken) {
+		woken = Game_PlayAnimation(ANIM_ATTRACT, (1U << CUBES) - 1, true) || Hardware_SleepUntilWoken(Hardware_GetMillis() + ATTRACT_PAUSE_MILLIS);
+		woken = woken || AUTOPILOT;
+	}
 
-	//// Setup ADC
-	rcc_periph_clock_enable(RCC_ADC12); // Enable clock for ADC registers 1 and 2
+	Hardware_StopIdle();
+	return true;
+}
 
-	adc_power_off(ADC_REG); // Turn off ADC register 1 whist we set it up
+/* STREAM FUNCTIONS */
+/* Passes every frame the PC streams on to its cube, for as long as the PC keeps sending */
+/* The map of a frame is encoded straight out of the ring into the buffer its link sends from, and only then handed */
+/* back to the PC as credit, so the PC can never send more than the ring holds */
+void Game_PlayStream() {
+	struct Stream_Ring* ring = Hardware_OpenStream();
+	struct Stream_Message message;
+	uint64_t dirty[CUBE_DIRTY_WORDS] = {0};
+	uint8_t reply[2];
+
+	// Any column of a streamed map may have changed
+	for (int i = 0; i < CUBE_COLUMNS; i++) {
+		dirty[i / 64] |= 1ULL << i % 64;
+	}
 
-	adc_set_clk_prescale(ADC_REG, ADC_CCR_CKMODE_DIV1); // Setup a scaling
-	adc_disable_external_trigger_regular(ADC_REG); // We don't need to externally trigger the register...
-	adc_set_right_aligned(ADC_REG); // Make sure it is right aligned to get more usable values
-	adc_set_sample_time_on_all_channels(ADC_REG, ADC_SMPR_SMP_61DOT5CYC); // Set up sample time
-	adc_set_resolution(ADC_REG, ADC_CFGR1_RES_12_BIT); // Get a good resolution
+	Stream_InitReader(&Game_streamReader);
+	for (int cube = 0; cube < CUBES; cube++) {
+		Frame_InitEncoder(&Game_encoders[cube], DELTA_FRAMES);
+	}
 
-	adc_power_on(ADC_REG); // Finished setup, turn on ADC register 1
-}
+	do {
+		while (Stream_Next(&Game_streamReader, ring, &message)) {
+			if (message.type == STREAM_MESSAGE_HELLO) {
+				Stream_Release(ring, &message);
+
+				reply[0] = STREAM_WINDOW;
+				reply[1] = STREAM_WINDOW_FRAMES;
+				Hardware_SendToHost(reply, 2);
+				continue;
+			}
 
-/* Read given channel on ADC_REG */
-int Hardware_ReadChannel(int channel) {
-	uint8_t channelArray[] = {channel}; // Define the channel that we want to look at
-	adc_set_regular_sequence(ADC_REG, 1, channelArray); // Set up the channel
-	adc_start_conversion_regular(ADC_REG); // Start converting the analogue signal
+			// Waits for the link of the cube if it already has a frame queued, which is what paces the PC
+			if (message.cube < CUBES) {
+				if (Hardware_KeyframeNeeded(message.cube)) {
+					Game_encoders[message.cube].keyframeNeeded = true;
+				}
 
-	while(!(adc_eoc(ADC_REG))); // Wait until the register is ready to read data
+				Game_SendMap(message.cube, message.map, dirty);
+			}
+			Stream_Release(ring, &message);
 
-	return adc_read_regular(ADC_REG); // Read the value from the register and channel
+			reply[0] = STREAM_CREDIT;
+			Hardware_SendToHost(reply, 1);
+		}
+	} while (Hardware_WaitForStream(Stream_Available(ring)));
+
+	Hardware_FlushCubes();
 }
 
-/* Renders Cube_map on the LED cube */
-void Hardware_RenderCube() {
-	usart_send_blocking(USART_PORT, 0xF2); // To asynchonously start data transmission
+int main(void) {
+	Hardware_Setup(CUBES, PLAYERS);
 
-	// Render Cube_map on cube
-	for (int i = 0; i < 64; i++) {
-		usart_send_blocking(USART_PORT, Cube_map[i]);
+	if (STREAM) {
+		Game_PlayStream();
+		return 0;
 	}
-}
 
+	// Play game after game, idling in between
+	do {
+		Game_Start();
+	} while (Game_Attract());
 
-int main(void) {
-	Hardware_Setup();
-	Game_Start();
 	return 0;
 }
@@ -0,0 +1,296 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "link.h"
+
+#include <string.h>
+
+/* GLOBAL VARIABLES */
+/* Baud rates a link can run at, slowest first. Index 0 is the 9600 every link starts at */
+const uint32_t Link_bauds[LINK_BAUDS] = { 9600, 115200, 230400, 460800, 921600, 2000000, 3000000 };
+
+/* LINK FUNCTIONS */
+/* Gets the baud rate of an index, LINK_UNFRAMED being 9600 too */
+uint32_t Link_Baud(int index) {
+	if (index < 0 || index >= LINK_BAUDS) {
+		return Link_bauds[0];
+	}
+
+	return Link_bauds[index];
+}
+
+/* Adds bytes to a CRC-16/CCITT (polynomial 0x1021) started from LINK_CRC_START */
+/* A byte at a time without a table, which is a handful of shifts rather than 8 rounds of one */
+uint16_t Link_Crc(uint16_t crc, const uint8_t* bytes, int length) {
+	for (int i = 0; i < length; i++) {
+		uint8_t x = crc >> 8 ^ bytes[i];
+		x ^= x >> 4;
+		crc = (uint16_t)(crc << 8 ^ (uint16_t)x << 12 ^ (uint16_t)x << 5 ^ x);
+	}
+
+	return crc;
+}
+
+/* Encodes a message into message (which must hold LINK_MESSAGE_SIZE bytes), returns its size */
+/* The check byte is the complement of the sum of the other two, which is never FRAME_START for any message the */
+/* controller sends, so a stock cube waiting for a frame does not mistake the handshake for one */
+int Link_EncodeMessage(uint8_t type, uint8_t value, uint8_t* message) {
+	message[0] = type;
+	message[1] = value;
+	message[2] = (uint8_t)~(type + value);
+
+	return LINK_MESSAGE_SIZE;
+}
+
+/* Feeds a byte from the cube to reader, returns true once it completes a message (of the given type and value) */
+/* Anything which is not a message is skipped */
+bool Link_ReadMessage(struct Link_Reader* reader, uint8_t byte, uint8_t* type, uint8_t* value) {
+	if (reader->received == 0 && byte != LINK_ACK && byte != LINK_NAK) {
+		return false;
+	}
+
+	reader->message[reader->received++] = byte;
+	if (reader->received < LINK_MESSAGE_SIZE) {
+		return false;
+	}
+
+	reader->received = 0;
+	if (reader->message[2] != (uint8_t)~(reader->message[0] + reader->message[1])) {
+		return false;
+	}
+
+	*type = reader->message[0];
+	*value = reader->message[1];
+	return true;
+}
+
+/* Puts frame into a packet with the given sequence number (packet must hold LINK_MAX_PACKET_SIZE bytes) */
+/* Returns the size of the packet */
+int Link_EncodePacket(uint8_t sequence, const uint8_t* frame, int length, uint8_t* packet) {
+	packet[0] = LINK_PACKET;
+	packet[1] = sequence;
+	packet[2] = length & 0xFF;
+	packet[3] = length >> 8;
+	memcpy(packet + LINK_HEADER_SIZE, frame, length);
+
+	uint16_t crc = Link_Crc(LINK_CRC_START, packet + 1, LINK_HEADER_SIZE - 1 + length);
+	packet[LINK_HEADER_SIZE + length] = crc & 0xFF;
+	packet[LINK_HEADER_SIZE + length + 1] = crc >> 8;
+
+	return length + LINK_OVERHEAD;
+}
+
+/* CONTROLLER FUNCTIONS */
+/* Runs the handshake on a link at 9600 baud, offering baud rates from index offer down */
+/* Returns the index of the baud rate the link ends up at, or LINK_UNFRAMED if the cube never answered */
+int Link_Negotiate(const struct Link_Port* port, int offer) {
+	uint8_t message[LINK_MESSAGE_SIZE];
+
+	for (int baud = offer; baud >= 0;) {
+		// Offer the rate at 9600, which a cube which went back to 9600 always hears
+		port->setBaud(port->context, Link_Baud(0));
+		port->send(port->context, message, Link_EncodeMessage(LINK_HELLO, baud, message));
+
+		int chosen = Link_AwaitAck(port);
+		if (chosen < 0 || chosen > baud) {
+			return LINK_UNFRAMED;
+		}
+
+		// Both ends change rate, then check the link works at it
+		port->setBaud(port->context, Link_Baud(chosen));
+		port->sleep(port->context, LINK_SWITCH_MILLIS);
+		port->send(port->context, message, Link_EncodeMessage(LINK_SYNC, chosen, message));
+
+		if (Link_AwaitAck(port) == chosen) {
+			return chosen;
+		}
+
+		// The link does not work at that rate, wait for the cube to give up on it too and try a slower one
+		port->setBaud(port->context, Link_Baud(0));
+		port->sleep(port->context, LINK_SYNC_MILLIS);
+		baud = chosen - 1;
+	}
+
+	port->setBaud(port->context, Link_Baud(0));
+	return LINK_UNFRAMED;
+}
+
+/* Waits for the cube to answer LINK_ACK, returns its value or -1 if it does not */
+int Link_AwaitAck(const struct Link_Port* port) {
+	struct Link_Reader reader = {0};
+	uint8_t type, value;
+	int byte;
+
+	// A few messages worth of bytes at most, so a noisy line cannot keep it waiting forever
+	for (int i = 0; i < 4 * LINK_MESSAGE_SIZE; i++) {
+		byte = port->receive(port->context, LINK_REPLY_MILLIS);
+		if (byte < 0) {
+			return -1;
+		}
+
+		if (Link_ReadMessage(&reader, byte, &type, &value) && type == LINK_ACK) {
+			return value;
+		}
+	}
+
+	return -1;
+}
+
+/* CUBE FUNCTIONS */
+/* Get ready to receive at 9600 as a stock cube would, maxBaud being the fastest rate the cube can do */
+void Link_InitReceiver(struct Link_Receiver* receiver, int maxBaud) {
+	memset(receiver, 0, sizeof(*receiver));
+	receiver->maxBaud = maxBaud;
+	receiver->baud = 0;
+	receiver->state = LINK_WAITING;
+	Frame_InitDecoder(&receiver->decoder);
+}
+
+/* Feeds a byte received by the cube to receiver, returns the size of any reply to send back (put in reply, which */
+/* must hold LINK_MESSAGE_SIZE bytes). A reply to LINK_HELLO is sent at the old rate, then the USART changes to baud */
+int Link_Receive(struct Link_Receiver* receiver, uint8_t byte, uint8_t* reply) {
+	int length;
+
+	switch (receiver->state) {
+		case LINK_WAITING:
+			// Bare frames are taken until the handshake has started, and nothing can interrupt one of them
+			if (!receiver->framed && !receiver->switching && receiver->decoder.state != FRAME_WAITING) {
+				receiver->frames += Frame_Decode(&receiver->decoder, byte);
+				return 0;
+			}
+
+			if (byte == LINK_HELLO || byte == LINK_SYNC) {
+				receiver->state = LINK_MESSAGE;
+			} else if (receiver->framed && byte == LINK_PACKET) {
+				receiver->state = LINK_HEADER;
+			} else {
+				if (!receiver->framed && !receiver->switching) {
+					receiver->frames += Frame_Decode(&receiver->decoder, byte);
+				}
+				return 0;
+			}
+
+			receiver->packet[0] = byte;
+			receiver->received = 1;
+			return 0;
+		case LINK_MESSAGE:
+			receiver->packet[receiver->received++] = byte;
+			if (receiver->received < LINK_MESSAGE_SIZE) {
+				return 0;
+			}
+
+			receiver->state = LINK_WAITING;
+			return Link_ReceiveMessage(receiver, reply);
+		case LINK_HEADER:
+			receiver->packet[receiver->received++] = byte;
+			if (receiver->received < LINK_HEADER_SIZE) {
+				return 0;
+			}
+
+			// A length no frame can have means the header was corrupted
+			length = receiver->packet[2] | receiver->packet[3] << 8;
+			if (length == 0 || length > FRAME_MAX_SIZE) {
+				receiver->state = LINK_WAITING;
+				receiver->crcErrors++;
+				return Link_Nak(receiver, reply);
+			}
+
+			receiver->length = LINK_HEADER_SIZE + length + 2;
+			receiver->state = LINK_BODY;
+			return 0;
+		case LINK_BODY:
+			receiver->packet[receiver->received++] = byte;
+			if (receiver->received < receiver->length) {
+				return 0;
+			}
+
+			receiver->state = LINK_WAITING;
+			return Link_ReceivePacket(receiver, reply);
+	}
+
+	return 0;
+}
+
+/* Handles a whole message of the handshake in receiver->packet */
+int Link_ReceiveMessage(struct Link_Receiver* receiver, uint8_t* reply) {
+	uint8_t type = receiver->packet[0];
+	uint8_t value = receiver->packet[1];
+
+	if (receiver->packet[2] != (uint8_t)~(type + value) || value >= LINK_BAUDS) {
+		return 0;
+	}
+
+	if (type == LINK_HELLO) {
+		// Take the fastest rate both ends can do, starting over if the controller was reset
+		receiver->baud = value < receiver->maxBaud ? value : receiver->maxBaud;
+		receiver->framed = false;
+		receiver->switching = true;
+		return Link_EncodeMessage(LINK_ACK, receiver->baud, reply);
+	}
+
+	if (type == LINK_SYNC && value == receiver->baud && (receiver->switching || receiver->framed)) {
+		// The first packet is always a full frame, see Frame_InitEncoder
+		receiver->framed = true;
+		receiver->switching = false;
+		receiver->expected = 0;
+		receiver->resyncing = false;
+		return Link_EncodeMessage(LINK_ACK, receiver->baud, reply);
+	}
+
+	return 0;
+}
+
+/* Handles a whole packet in receiver->packet, showing its frame unless it was corrupted or a packet was lost */
+int Link_ReceivePacket(struct Link_Receiver* receiver, uint8_t* reply) {
+	const uint8_t* packet = receiver->packet;
+	int length = receiver->length - LINK_OVERHEAD;
+	const uint8_t* frame = packet + LINK_HEADER_SIZE;
+	uint16_t crc = packet[receiver->length - 2] | packet[receiver->length - 1] << 8;
+
+	if (Link_Crc(LINK_CRC_START, packet + 1, LINK_HEADER_SIZE - 1 + length) != crc) {
+		receiver->crcErrors++;
+		return Link_Nak(receiver, reply);
+	}
+
+	uint8_t sequence = packet[1];
+	bool full = frame[0] == FRAME_START;
+
+	// A delta frame only makes sense after every frame before it, so after a lost one wait for a full frame
+	// The full frame asked for has already been asked for if resyncing, unless it was corrupted too
+	if (!full && (sequence != receiver->expected || receiver->resyncing)) {
+		int replyLength = receiver->resyncing ? 0 : Link_Nak(receiver, reply);
+
+		receiver->expected = sequence + 1;
+		receiver->dropped++;
+		return replyLength;
+	}
+
+	receiver->expected = sequence + 1;
+	receiver->resyncing = false;
+
+	receiver->decoder.state = FRAME_WAITING;
+	for (int i = 0; i < length; i++) {
+		receiver->frames += Frame_Decode(&receiver->decoder, frame[i]);
+	}
+
+	return 0;
+}
+
+/* Asks the controller for a full frame, which is asked for again by every corrupted packet as it may have been it */
+int Link_Nak(struct Link_Receiver* receiver, uint8_t* reply) {
+	receiver->resyncing = true;
+	receiver->naks++;
+	return Link_EncodeMessage(LINK_NAK, receiver->expected, reply);
+}
+
+/* Called by the cube when LINK_SYNC_MILLIS have gone by since it changed rate, goes back to 9600 unless it got LINK_SYNC */
+void Link_ReceiverTimeout(struct Link_Receiver* receiver) {
+	if (!receiver->switching) {
+		return;
+	}
+
+	// Whatever arrived at the new rate was noise, so it must not be taken for the start of a frame either
+	receiver->baud = 0;
+	receiver->framed = false;
+	receiver->switching = false;
+	receiver->state = LINK_WAITING;
+	receiver->decoder.state = FRAME_WAITING;
+}
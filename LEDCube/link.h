@@ -0,0 +1,104 @@
+/* Framed and checksummed link to the LED cube, and the handshake which moves it to a higher baud rate */
+/* Every link starts at 9600 baud. The controller sends LINK_HELLO with the fastest rate it can do, and a cube which
+ * understands this protocol answers LINK_ACK with the fastest rate both can do. Both switch to it, the controller
+ * sends LINK_SYNC at the new rate and the cube answers LINK_ACK again. If that answer never comes both go back to 9600
+ * (the cube after LINK_SYNC_MILLIS) and the controller offers the next slower rate, down to framed 9600. A stock cube
+ * never answers LINK_HELLO, so the link stays at 9600 sending bare frames (see frame.h) as it always did
+ *
+ * Messages are three bytes, the type, a value and a check byte. Frames go inside packets:
+ *   LINK_PACKET, sequence number, length of the frame (2 bytes), the frame, CRC-16/CCITT of everything from the
+ *   sequence number to the end of the frame (2 bytes). Multi byte values are little endian
+ * The cube drops any packet with a bad CRC, so a corrupted byte is never shown. When it drops one, or sees a sequence
+ * number it did not expect, it answers LINK_NAK and ignores delta frames until the full frame the controller sends
+ * in reply arrives */
+#ifndef LINK_H
+#define LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "frame.h" // Needed for the frames carried by packets, and to decode them on the cube
+
+/* DEFINING MACROS */
+#define LINK_HELLO 0xA1 // Controller offers the baud rate of the value, sent at 9600
+#define LINK_ACK 0xA2 // Cube takes the baud rate of the value
+#define LINK_SYNC 0xA3 // Controller checks the link at the new baud rate of the value
+#define LINK_NAK 0xA4 // Cube lost a packet, the value being the sequence number it expected
+#define LINK_PACKET 0xA5 // Start of a packet
+#define LINK_MESSAGE_SIZE 3
+#define LINK_HEADER_SIZE 4
+#define LINK_OVERHEAD (LINK_HEADER_SIZE + 2) // Bytes a packet adds to a frame
+#define LINK_MAX_PACKET_SIZE (FRAME_MAX_SIZE + LINK_OVERHEAD)
+
+#define LINK_CRC_START 0xFFFF
+#define LINK_BAUDS 7 // Number of baud rates, see Link_Baud
+#define LINK_UNFRAMED -1 // Baud rate index of a link to a stock cube, which takes bare frames at 9600
+
+#define LINK_REPLY_MILLIS 20 // How long the controller waits for an answer to a message
+#define LINK_SWITCH_MILLIS 2 // How long the controller gives the cube to change baud rate
+#define LINK_SYNC_MILLIS 50 // How long the cube waits at a new baud rate for LINK_SYNC before going back to 9600
+
+/* STRUCTS AND ENUMS */
+/* Finds the messages in the bytes coming from the other end of a link */
+struct Link_Reader {
+	uint8_t message[LINK_MESSAGE_SIZE];
+	int received;
+};
+
+/* Where the cube is within a packet */
+enum Link_ReceiverState {
+	LINK_WAITING, // Waiting for a message or the start of a packet
+	LINK_MESSAGE, // Reading the rest of a message
+	LINK_HEADER, // Reading the sequence number and length of a packet
+	LINK_BODY, // Reading the frame and CRC of a packet
+};
+
+/* Cube end of a link, a reference for what the cube firmware has to do */
+struct Link_Receiver {
+	int maxBaud; // Index of the fastest baud rate the cube can do
+	int baud; // Index of the baud rate the cube's USART should be at
+	bool framed; // Whether the handshake has finished, until then bare frames are taken as a stock cube would
+	bool switching; // Changed baud rate and waiting for LINK_SYNC, Link_ReceiverTimeout goes back to 9600
+
+	enum Link_ReceiverState state;
+	uint8_t packet[LINK_MAX_PACKET_SIZE];
+	int received;
+	int length; // Number of bytes of the packet expected
+
+	uint8_t expected; // Sequence number of the next packet
+	bool resyncing; // Lost a packet, waiting for a full frame
+
+	struct Frame_Decoder decoder; // What the cube shows
+
+	unsigned long frames; // Frames shown
+	unsigned long crcErrors; // Packets dropped because of a bad CRC
+	unsigned long dropped; // Delta frames dropped whilst waiting for a full frame
+	unsigned long naks; // LINK_NAKs sent
+};
+
+/* What Link_Negotiate needs of the controller end of a link */
+struct Link_Port {
+	void* context;
+	void (*setBaud)(void* context, uint32_t baud); // Once every byte sent so far has gone
+	void (*send)(void* context, const uint8_t* bytes, int length);
+	int (*receive)(void* context, uint32_t millis); // Next byte, or -1 if none comes within millis
+	void (*sleep)(void* context, uint32_t millis);
+};
+
+/* FUNCTION DECLARATIONS */
+uint32_t Link_Baud(int index);
+uint16_t Link_Crc(uint16_t crc, const uint8_t* bytes, int length);
+int Link_EncodeMessage(uint8_t type, uint8_t value, uint8_t* message);
+bool Link_ReadMessage(struct Link_Reader* reader, uint8_t byte, uint8_t* type, uint8_t* value);
+int Link_EncodePacket(uint8_t sequence, const uint8_t* frame, int length, uint8_t* packet);
+int Link_Negotiate(const struct Link_Port* port, int offer);
+int Link_AwaitAck(const struct Link_Port* port);
+
+void Link_InitReceiver(struct Link_Receiver* receiver, int maxBaud);
+int Link_Receive(struct Link_Receiver* receiver, uint8_t byte, uint8_t* reply);
+int Link_ReceiveMessage(struct Link_Receiver* receiver, uint8_t* reply);
+int Link_ReceivePacket(struct Link_Receiver* receiver, uint8_t* reply);
+int Link_Nak(struct Link_Receiver* receiver, uint8_t* reply);
+void Link_ReceiverTimeout(struct Link_Receiver* receiver);
+
+#endif
@@ -0,0 +1,111 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "policy.h"
+#include "bitboard.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* GLOBAL VARIABLES */
+/* Names of the policies, in the order of enum Policy_Kind */
+const char* const Policy_names[] = { "straight", "random", "greedy", "autopilot" };
+
+/* POLICY FUNCTIONS */
+/* Sets up a controller of the given kind, seed only matters to the ones making random choices */
+void Policy_Init(struct Policy* policy, enum Policy_Kind kind, uint32_t seed) {
+	policy->kind = kind;
+	Random_Seed(&policy->random, seed);
+	Autopilot_Init(&policy->autopilot);
+}
+
+/* Looks up a policy by name, returns false if there is no such policy */
+bool Policy_FromName(const char* name, enum Policy_Kind* kind) {
+	for (int i = 0; i < (int)(sizeof(Policy_names) / sizeof(Policy_names[0])); i++) {
+		if (strcmp(name, Policy_names[i]) == 0) {
+			*kind = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Gets the name of a policy */
+const char* Policy_Name(enum Policy_Kind kind) {
+	return Policy_names[kind];
+}
+
+/* Checks whether snake survives its next step if it makes directionChange */
+/* freeNeighbours is the mask of the neighbours of the head not taken by any snake, from Bitboard_FreeNeighbours */
+/* Also gives the position the head would move to */
+bool Policy_IsSafe(const struct Snake* snake, unsigned freeNeighbours, enum DirectionChange directionChange, int* x, int* y, int* z) {
+	enum Direction direction = Snake_TurnDirection(snake->direction, directionChange);
+	const int8_t* step = Snake_StepOf(direction);
+	uint16_t head = snake->body[snake->head];
+
+	*x = CELL_X(head) + step[0];
+	*y = CELL_Y(head) + step[1];
+	*z = CELL_Z(head) + step[2];
+
+	// Anything but the snakes and the walls is safe, including the apple
+	// The directions are in the same order as the bits of freeNeighbours
+	return freeNeighbours >> direction & 1;
+}
+
+/* Picks the next direction change for one of the snakes of game */
+enum DirectionChange Policy_Choose(struct Policy* policy, const struct GameState* game, const struct Snake* snake) {
+	enum DirectionChange safe[CENTRE + 1];
+	int distances[CENTRE + 1];
+	int safeCount = 0;
+	int x, y, z;
+
+	if (policy->kind == POLICY_STRAIGHT) {
+		return CENTRE;
+	}
+
+	if (policy->kind == POLICY_AUTOPILOT) {
+		return Autopilot_Choose(&policy->autopilot, game, snake);
+	}
+
+	// Which of the 6 neighbours of the head are free, in one go from the occupancy bitmap of the snakes
+	uint16_t head = snake->body[snake->head];
+	unsigned freeNeighbours = Bitboard_FreeNeighbours(game->cube.occupied, CELL_X(head), CELL_Y(head), CELL_Z(head));
+
+	// Find which direction changes do not end the game, going straight on first
+	for (int i = CENTRE; i >= RIGHT; i--) {
+		if (Policy_IsSafe(snake, freeNeighbours, i, &x, &y, &z)) {
+			safe[safeCount] = i;
+
+			if (game->cube.apple != NO_APPLE) {
+				distances[safeCount] = abs(x - CELL_X(game->cube.apple)) + abs(y - CELL_Y(game->cube.apple)) + abs(z - CELL_Z(game->cube.apple));
+			} else {
+				distances[safeCount] = 0;
+			}
+
+			safeCount++;
+		}
+	}
+
+	// Nowhere is safe, so the game is lost whatever happens
+	if (safeCount == 0) {
+		return CENTRE;
+	}
+
+	if (policy->kind == POLICY_RANDOM) {
+		return safe[Random_Below(&policy->random, safeCount)];
+	}
+
+	// Closest to the apple, by the number of steps it would take with nothing in the way
+	// Ties are broken at random, as always taking the same one can leave the snake circling the apple for ever
+	int best = 0;
+	int ties = 1;
+	for (int i = 1; i < safeCount; i++) {
+		if (distances[i] < distances[best]) {
+			best = i;
+			ties = 1;
+		} else if (distances[i] == distances[best] && Random_Below(&policy->random, ++ties) == 0) {
+			best = i;
+		}
+	}
+
+	return safe[best];
+}
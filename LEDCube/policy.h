@@ -0,0 +1,32 @@
+/* Controllers which steer the snake without a joystick, for playing games offline (see sim.c) */
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "game.h"
+#include "random.h"
+#include "autopilot.h"
+
+/* STRUCTS AND ENUMS */
+/* Ways of picking the next direction change */
+enum Policy_Kind {
+	POLICY_STRAIGHT, // Never turn, like a joystick left at rest
+	POLICY_RANDOM, // Pick any direction change which does not run into something, at random
+	POLICY_GREEDY, // Head for the apple by the shortest way which does not run into something
+	POLICY_AUTOPILOT, // Head for the apple by a way found around everything, keeping room to move, see autopilot.h
+};
+
+/* State of one controller */
+struct Policy {
+	enum Policy_Kind kind;
+	struct Random random; // Used by POLICY_RANDOM, and to break ties
+	struct Autopilot autopilot; // Used by POLICY_AUTOPILOT
+};
+
+/* FUNCTION DECLARATIONS */
+void Policy_Init(struct Policy* policy, enum Policy_Kind kind, uint32_t seed);
+bool Policy_FromName(const char* name, enum Policy_Kind* kind);
+const char* Policy_Name(enum Policy_Kind kind);
+enum DirectionChange Policy_Choose(struct Policy* policy, const struct GameState* game, const struct Snake* snake);
+bool Policy_IsSafe(const struct Snake* snake, unsigned freeNeighbours, enum DirectionChange directionChange, int* x, int* y, int* z);
+
+#endif
@@ -0,0 +1,116 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "profile.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* GLOBAL VARIABLES */
+/* Names of the phases, in the order of enum Profile_Phase */
+const char* const Profile_phaseNames[PROFILE_PHASES] = { "input", "step", "apple", "render", "tick", "anim", "wake" };
+
+#if PROFILE
+/* Stats of every phase since they were last sent */
+struct Profile_Stats Profile_stats[PROFILE_PHASES];
+
+/* PROFILE FUNCTIONS */
+/* Forgets the stats of every phase */
+void Profile_Reset() {
+	for (int i = 0; i < PROFILE_PHASES; i++) {
+		Profile_stats[i].count = 0;
+		Profile_stats[i].min = UINT32_MAX;
+		Profile_stats[i].max = 0;
+		Profile_stats[i].total = 0;
+	}
+}
+
+/* Adds a timing of phase to its stats */
+void Profile_Record(enum Profile_Phase phase, uint32_t cycles) {
+	struct Profile_Stats* stats = &Profile_stats[phase];
+
+	stats->count++;
+	stats->total += cycles;
+	if (cycles < stats->min) {
+		stats->min = cycles;
+	}
+	if (cycles > stats->max) {
+		stats->max = cycles;
+	}
+}
+
+/* Writes the stats record of every phase into record (which must hold PROFILE_MAX_RECORD_SIZE bytes) */
+/* Returns its length */
+int Profile_Encode(uint8_t* record) {
+	int length = 0;
+	uint8_t sum = 0;
+
+	record[length++] = PROFILE_RECORD_START;
+	record[length++] = PROFILE_PHASES;
+
+	for (int i = 0; i < PROFILE_PHASES; i++) {
+		const struct Profile_Stats* stats = &Profile_stats[i];
+		uint32_t words[4] = {
+			stats->count,
+			stats->count > 0 ? stats->min : 0,
+			stats->max,
+			stats->count > 0 ? (uint32_t)(stats->total / stats->count) : 0,
+		};
+
+		for (int w = 0; w < 4; w++) {
+			for (int b = 0; b < 4; b++) {
+				record[length++] = words[w] >> 8 * b;
+			}
+		}
+	}
+
+	for (int i = 0; i < length; i++) {
+		sum += record[i];
+	}
+	record[length++] = sum;
+
+	return length;
+}
+#endif
+
+/* DECODE FUNCTIONS */
+/* Not needed on the board, but kept whatever PROFILE is so profileDecode can always be built */
+
+/* Reads the stats record at the start of record, if there is a complete and intact one */
+/* Fills stats with the count, min, max and mean of each phase, and returns the number of phases */
+/* Returns 0 if more bytes are needed, or -1 if record does not start with a valid stats record */
+int Profile_Decode(const uint8_t* record, int length, uint32_t stats[][4], int maxPhases) {
+	uint8_t sum = 0;
+
+	if (length < 2) {
+		return 0;
+	}
+
+	int phases = record[1];
+	if (record[0] != PROFILE_RECORD_START || phases == 0 || phases > maxPhases) {
+		return -1;
+	}
+
+	if (length < PROFILE_RECORD_SIZE(phases)) {
+		return 0;
+	}
+
+	for (int i = 0; i < PROFILE_RECORD_SIZE(phases) - 1; i++) {
+		sum += record[i];
+	}
+	if (sum != record[PROFILE_RECORD_SIZE(phases) - 1]) {
+		return -1;
+	}
+
+	for (int i = 0; i < phases; i++) {
+		for (int w = 0; w < 4; w++) {
+			const uint8_t* bytes = record + 2 + PROFILE_PHASE_SIZE * i + 4 * w;
+			stats[i][w] = bytes[0] | bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+		}
+	}
+
+	return phases;
+}
+
+/* Gets the name of a phase, which may come from a newer build knowing more phases than this one */
+const char* Profile_PhaseName(int phase) {
+	return phase < PROFILE_PHASES ? Profile_phaseNames[phase] : "?";
+}
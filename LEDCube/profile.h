@@ -0,0 +1,81 @@
+/* Optional instrumentation of the phases of a tick of the game, counting cycles with the DWT cycle counter */
+/* Built with PROFILE=1 (CPPFLAGS=-DPROFILE=1), otherwise every PROFILE_ macro expands to nothing and the stats are not kept */
+/* Min, max and mean cycles of each phase are sent on demand as a stats record, decoded by profileDecode on the PC */
+/* On the host the "cycles" are nanoseconds of the monotonic clock */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DEFINING MACROS */
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+/* A stats record is PROFILE_RECORD_START, the number of phases, then for each phase its count, min, max and mean */
+/* (4 byte little endian words) and finally the sum of every byte before it, so a record can be found in a stream */
+#define PROFILE_RECORD_START 0xA5
+#define PROFILE_REQUEST 'S' // Byte the PC sends to ask for a stats record
+#define PROFILE_PHASE_SIZE 16
+#define PROFILE_RECORD_SIZE(phases) (3 + PROFILE_PHASE_SIZE * (phases))
+#define PROFILE_MAX_RECORD_SIZE PROFILE_RECORD_SIZE(PROFILE_PHASES)
+
+#if PROFILE
+#ifdef STM32F3
+#include "libopencm3/cm3/dwt.h" // Needed to read the cycle counter
+#else
+#include <time.h>
+#endif
+
+/* Starts timing a phase, name is a variable holding the start, declared where the macro is */
+#define PROFILE_BEGIN(name) uint32_t name = Profile_Cycles()
+/* Ends timing of a phase started with PROFILE_BEGIN(name) and adds it to the stats of phase */
+#define PROFILE_END(phase, name) Profile_Record((phase), Profile_Cycles() - (name))
+#else
+#define PROFILE_BEGIN(name)
+#define PROFILE_END(phase, name) ((void)0)
+#endif
+
+/* STRUCTS AND ENUMS */
+/* Phases of a tick which are timed */
+enum Profile_Phase {
+	PROFILE_INPUT, // Taking the direction from the joystick
+	PROFILE_STEP, // Turning and moving the snake, including any apple generation
+	PROFILE_APPLE, // Generating an apple after one was eaten
+	PROFILE_RENDER, // Encoding the frame and handing it to the USART, which waits if a frame is still queued
+	PROFILE_TICK, // The whole tick
+	PROFILE_ANIMATION, // Decoding a frame of an animation (see anim.h), outside of any tick
+	PROFILE_WAKE, // From a joystick waking the board (see Hardware_StartIdle) to the first frame of the game being sent
+	PROFILE_PHASES,
+};
+
+/* Stats of one phase */
+struct Profile_Stats {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total; // Only the mean is sent, so this never has to leave the board
+};
+
+/* FUNCTION DECLARATIONS */
+void Profile_Reset(void);
+void Profile_Record(enum Profile_Phase phase, uint32_t cycles);
+int Profile_Encode(uint8_t* record);
+int Profile_Decode(const uint8_t* record, int length, uint32_t stats[][4], int maxPhases);
+const char* Profile_PhaseName(int phase);
+
+#if PROFILE
+/* Gets the cycle counter, which wraps around every 2^32 cycles (a minute at 72 MHz) */
+static inline uint32_t Profile_Cycles(void) {
+#ifdef STM32F3
+	return DWT_CYCCNT;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+#endif
+}
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+/* Host tool decoding the stats records sent by a build with PROFILE=1 (see profile.h) */
+/* Usage: profileDecode [-m MHZ] [-q] STREAM
+ *        prints every stats record in STREAM, a file written by the host build (LEDCUBE_STATS) or the serial port of the
+ *        board (set up beforehand, eg stty -F /dev/ttyACM0 115200 raw). -q first sends PROFILE_REQUEST to STREAM and
+ *        stops after the record it gets back. MHZ is the clock the cycles are counted at, used to print times too
+ *        (8, the HSI the board runs from; 1000 for the host build, which counts nanoseconds) */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+/* DEFINING MACROS */
+#define DECODE_MAX_PHASES 32 // Most phases a record from any build could have
+#define DECODE_BUFFER_SIZE PROFILE_RECORD_SIZE(DECODE_MAX_PHASES)
+
+/* FUNCTION DECLARATIONS */
+void Decode_PrintRecord(long number, uint32_t stats[][4], int phases, double megahertz);
+
+/* DECODE FUNCTIONS */
+/* Prints the stats of every phase of a record */
+void Decode_PrintRecord(long number, uint32_t stats[][4], int phases, double megahertz) {
+	printf("record %ld\n", number);
+	printf("%-8s %10s %10s %10s %10s %10s\n", "phase", "count", "min", "mean", "max", "mean us");
+
+	for (int i = 0; i < phases; i++) {
+		printf("%-8s %10lu %10lu %10lu %10lu %10.1f\n", Profile_PhaseName(i), (unsigned long)stats[i][0], (unsigned long)stats[i][1], (unsigned long)stats[i][3], (unsigned long)stats[i][2], stats[i][3] / megahertz);
+	}
+
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	uint8_t buffer[DECODE_BUFFER_SIZE];
+	uint32_t stats[DECODE_MAX_PHASES][4];
+	double megahertz = 8;
+	bool request = false;
+	long records = 0;
+	long skipped = 0;
+	int length = 0;
+	int option;
+	int byte;
+
+	while ((option = getopt(argc, argv, "m:q")) != -1) {
+		switch (option) {
+			case 'm':
+				megahertz = strtod(optarg, NULL);
+				break;
+			case 'q':
+				request = true;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-m MHZ] [-q] STREAM\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1 || megahertz <= 0) {
+		fprintf(stderr, "usage: %s [-m MHZ] [-q] STREAM\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE* stream = fopen(argv[optind], request ? "r+b" : "rb");
+	if (stream == NULL) {
+		perror(argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	if (request) {
+		fputc(PROFILE_REQUEST, stream);
+		fflush(stream);
+	}
+
+	while ((byte = fgetc(stream)) != EOF) {
+		buffer[length++] = byte;
+
+		// Drop bytes from the front until the buffer starts with what could be a record
+		int phases;
+		while (length > 0 && (phases = Profile_Decode(buffer, length, stats, DECODE_MAX_PHASES)) < 0) {
+			memmove(buffer, buffer + 1, --length);
+			skipped++;
+		}
+
+		if (length > 0 && phases > 0) {
+			Decode_PrintRecord(++records, stats, phases, megahertz);
+			length = 0;
+
+			if (request) {
+				break;
+			}
+		}
+	}
+
+	if (skipped > 0) {
+		printf("%ld bytes outside of records skipped\n", skipped);
+	}
+
+	fclose(stream);
+
+	return records > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,34 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "random.h"
+
+/* RANDOM FUNCTIONS */
+/* Start the stream given by seed, any seed (including 0) is valid */
+void Random_Seed(struct Random* random, uint32_t seed) {
+	// Scramble the seed so that nearby seeds give unrelated streams
+	seed ^= seed >> 16;
+	seed *= 0x7FEB352D;
+	seed ^= seed >> 15;
+	seed *= 0x846CA68B;
+	seed ^= seed >> 16;
+
+	// xorshift gets stuck on a state of 0
+	random->state = seed != 0 ? seed : 0x9E3779B9;
+}
+
+/* Get the next 32 random bits of the stream */
+uint32_t Random_Next(struct Random* random) {
+	uint32_t x = random->state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	random->state = x;
+	return x;
+}
+
+/* Get a random number in the range [0, bound) */
+uint32_t Random_Below(struct Random* random, uint32_t bound) {
+	// Scale the 32 random bits down to the range with a multiply rather than a (slow) division
+	return (uint32_t)(((uint64_t)Random_Next(random) * bound) >> 32);
+}
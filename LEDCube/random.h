@@ -0,0 +1,19 @@
+/* Small, fast pseudo random number generator (xorshift32) */
+/* Used instead of rand() so that a game can be replayed exactly from its seed */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+/* STRUCTS AND ENUMS */
+/* State of one stream of random numbers */
+struct Random {
+	uint32_t state;
+};
+
+/* FUNCTION DECLARATIONS */
+void Random_Seed(struct Random* random, uint32_t seed);
+uint32_t Random_Next(struct Random* random);
+uint32_t Random_Below(struct Random* random, uint32_t bound);
+
+#endif
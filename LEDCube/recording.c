@@ -0,0 +1,114 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "recording.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* RECORDING FUNCTIONS */
+/* Starts recording a game into log, which holds size bytes */
+void Recording_Start(struct Recording* recording, uint8_t* log, int size, uint32_t seed, int winLength) {
+	recording->log = log;
+	recording->size = size;
+	recording->truncated = size < RECORDING_HEADER_SIZE + RECORDING_TAIL_SIZE;
+	recording->runDirection = CENTRE;
+	recording->runLength = 0;
+	recording->ticks = 0;
+	recording->hash = RECORDING_HASH_START;
+	recording->length = 0;
+
+	if (recording->truncated) {
+		return;
+	}
+
+	memcpy(log, RECORDING_MAGIC, 3);
+	log[3] = RECORDING_VERSION;
+	for (int b = 0; b < 4; b++) {
+		log[4 + b] = seed >> 8 * b;
+	}
+	log[8] = winLength;
+	log[9] = winLength >> 8;
+	recording->length = RECORDING_HEADER_SIZE;
+}
+
+/* Adds a tick of the game, made with directionChange and leaving the cube showing map */
+void Recording_Tick(struct Recording* recording, enum DirectionChange directionChange, const Cube_Column* map) {
+	if (recording->truncated) {
+		return;
+	}
+
+	// A tick writes at most two runs and a checkpoint, after which the end still has to fit
+	if (recording->length + 2 + 5 + RECORDING_TAIL_SIZE > recording->size) {
+		recording->truncated = true;
+		return;
+	}
+
+	if (recording->runLength > 0 && (directionChange != recording->runDirection || recording->runLength == RECORDING_MAX_RUN)) {
+		Recording_FlushRun(recording);
+	}
+
+	recording->runDirection = directionChange;
+	recording->runLength++;
+	recording->hash = Recording_Hash(recording->hash, map);
+	recording->ticks++;
+
+	if (recording->ticks % RECORDING_CHECKPOINT_INTERVAL == 0) {
+		Recording_FlushRun(recording);
+		Recording_WriteCheckpoint(recording);
+	}
+}
+
+/* Ends the recording of a game which ended with result, returns the length of the log */
+int Recording_Finish(struct Recording* recording, enum GameResult result) {
+	if (recording->length == 0) {
+		return 0;
+	}
+
+	// There is always room for these, Recording_Tick stops early enough
+	Recording_FlushRun(recording);
+	Recording_WriteCheckpoint(recording);
+
+	recording->log[recording->length++] = RECORDING_END;
+	recording->log[recording->length++] = recording->truncated ? RECORDING_TRUNCATED : result;
+
+	return recording->length;
+}
+
+/* Writes out the run of ticks so far, if there is one */
+void Recording_FlushRun(struct Recording* recording) {
+	if (recording->runLength == 0) {
+		return;
+	}
+
+	recording->log[recording->length++] = recording->runDirection << 5 | (recording->runLength - 1);
+	recording->runLength = 0;
+}
+
+/* Writes out the hash of every map so far */
+void Recording_WriteCheckpoint(struct Recording* recording) {
+	uint32_t hash = Recording_FoldHash(recording->hash);
+
+	recording->log[recording->length++] = RECORDING_CHECKPOINT;
+	for (int b = 0; b < 4; b++) {
+		recording->log[recording->length++] = hash >> 8 * b;
+	}
+}
+
+/* Adds map to hash, 8 bytes (a row of 8 columns on an 8x8x8 cube) at a time */
+/* Words are read in the byte order of the machine, so recordings only compare between little endian machines */
+uint64_t Recording_Hash(uint64_t hash, const Cube_Column* map) {
+	const uint8_t* bytes = (const uint8_t*)map;
+
+	for (int i = 0; i < CUBE_MAP_SIZE; i += 8) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + i, CUBE_MAP_SIZE - i < 8 ? CUBE_MAP_SIZE - i : 8);
+		hash = (hash ^ word) * RECORDING_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+/* Gets the 32 bits of hash written to checkpoints */
+uint32_t Recording_FoldHash(uint64_t hash) {
+	return (uint32_t)(hash ^ hash >> 32);
+}
@@ -0,0 +1,54 @@
+/* Compact log of the inputs of a game, from which the game can be replayed exactly (see replay.c) */
+/* A recording is a header (RECORDING_MAGIC, RECORDING_VERSION, seed and winning length) followed by:
+ *   runs         - one byte, the direction change in the top 3 bits and the number of ticks it lasted less 1 in the
+ *                  bottom 5, most ticks being CENTRE
+ *   checkpoints  - RECORDING_CHECKPOINT then a 4 byte hash of every map after every tick so far, every
+ *                  RECORDING_CHECKPOINT_INTERVAL ticks and at the end, so a replay can tell where it went differently
+ *   end          - RECORDING_END then the GameResult the game ended with, or RECORDING_TRUNCATED if the log ran out
+ *                  of space first. Multi byte values are little endian
+ * The size of the cube is not recorded, a recording only replays on a build for the same CUBE_SIZE */
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "game.h" // Needed for the direction changes and results of a game
+
+/* DEFINING MACROS */
+#define RECORDING_MAGIC "LCR"
+#define RECORDING_VERSION 1
+#define RECORDING_HEADER_SIZE 10
+#define RECORDING_MAX_RUN 32
+#define RECORDING_CHECKPOINT 0xE0
+#define RECORDING_END 0xF0
+#define RECORDING_TRUNCATED 0xFF
+#define RECORDING_CHECKPOINT_INTERVAL 256
+#define RECORDING_TAIL_SIZE (1 + 5 + 2) // Run, checkpoint and end which always have to fit at the end of the log
+#define RECORDING_HASH_START 0xCBF29CE484222325ULL // Hash of no maps at all
+#define RECORDING_HASH_PRIME 0x100000001B3ULL
+
+/* STRUCTS AND ENUMS */
+/* State of a recording being made */
+struct Recording {
+	uint8_t* log;
+	int size;
+	int length;
+	bool truncated; // Ran out of space, the recording stops at the last tick which fitted
+
+	enum DirectionChange runDirection;
+	int runLength;
+	uint32_t ticks;
+	uint64_t hash; // Hash of every map so far
+};
+
+/* FUNCTION DECLARATIONS */
+void Recording_Start(struct Recording* recording, uint8_t* log, int size, uint32_t seed, int winLength);
+void Recording_Tick(struct Recording* recording, enum DirectionChange directionChange, const Cube_Column* map);
+int Recording_Finish(struct Recording* recording, enum GameResult result);
+void Recording_FlushRun(struct Recording* recording);
+void Recording_WriteCheckpoint(struct Recording* recording);
+uint64_t Recording_Hash(uint64_t hash, const Cube_Column* map);
+uint32_t Recording_FoldHash(uint64_t hash);
+
+#endif
@@ -0,0 +1,201 @@
+/* Host tool replaying a recording of a game (see recording.h) through the game logic as fast as it will go */
+/* Usage: ledCubeReplay [-v] RECORDING
+ *        replays RECORDING, checking the maps against every checkpoint and the result against the one recorded, and
+ *        reports the ticks between which it first went differently. -v prints every checkpoint as it is checked */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "recording.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FUNCTION DECLARATIONS */
+uint8_t* Replay_Read(const char* path, long* length);
+int Replay_Run(const uint8_t* log, long length, bool verbose);
+const char* Replay_ResultName(int result);
+double Replay_Seconds(void);
+
+/* GLOBAL VARIABLES */
+/* Names of the results of a game, in the order of enum GameResult */
+const char* const Replay_resultNames[] = { "still playing", "won", "hit wall", "hit itself" };
+
+/* REPLAY FUNCTIONS */
+/* Reads the whole of a file into memory */
+uint8_t* Replay_Read(const char* path, long* length) {
+	FILE* file = fopen(path, "rb");
+	uint8_t* log = NULL;
+	long size = 0;
+
+	if (file == NULL) {
+		perror(path);
+		return NULL;
+	}
+
+	*length = 0;
+	do {
+		size = size == 0 ? 4096 : 2 * size;
+		uint8_t* bigger = realloc(log, size);
+		if (bigger == NULL) {
+			perror("realloc");
+			free(log);
+			fclose(file);
+			return NULL;
+		}
+		log = bigger;
+
+		*length += fread(log + *length, 1, size - *length, file);
+	} while (*length == size);
+
+	fclose(file);
+	return log;
+}
+
+/* Replays a recording, returns EXIT_SUCCESS if it went the same way as when it was recorded */
+int Replay_Run(const uint8_t* log, long length, bool verbose) {
+	struct GameState game;
+	enum GameResult result = GAME_PLAYING;
+	uint64_t hash = RECORDING_HASH_START;
+	uint32_t ticks = 0;
+	uint32_t checkedTicks = 0;
+	long checkpoints = 0;
+	long i = RECORDING_HEADER_SIZE;
+
+	if (length < RECORDING_HEADER_SIZE || memcmp(log, RECORDING_MAGIC, 3) != 0 || log[3] != RECORDING_VERSION) {
+		fprintf(stderr, "not a version %d recording\n", RECORDING_VERSION);
+		return EXIT_FAILURE;
+	}
+
+	uint32_t seed = log[4] | log[5] << 8 | (uint32_t)log[6] << 16 | (uint32_t)log[7] << 24;
+	int winLength = log[8] | log[9] << 8;
+
+	printf("seed %lu, won at length %d\n", (unsigned long)seed, winLength);
+
+	double start = Replay_Seconds();
+
+	Game_Init(&game, seed);
+	game.winLength = winLength;
+
+	while (i < length) {
+		uint8_t byte = log[i++];
+
+		if (byte == RECORDING_CHECKPOINT) {
+			if (i + 4 > length) {
+				break;
+			}
+
+			uint32_t recorded = log[i] | log[i + 1] << 8 | (uint32_t)log[i + 2] << 16 | (uint32_t)log[i + 3] << 24;
+			i += 4;
+			checkpoints++;
+
+			if (verbose) {
+				printf("tick %8lu: %08lx\n", (unsigned long)ticks, (unsigned long)recorded);
+			}
+
+			if (Recording_FoldHash(hash) != recorded) {
+				printf("DIVERGED: the maps first differ somewhere between ticks %lu and %lu\n", (unsigned long)checkedTicks + 1, (unsigned long)ticks);
+				return EXIT_FAILURE;
+			}
+			checkedTicks = ticks;
+		} else if (byte == RECORDING_END) {
+			if (i + 1 > length) {
+				break;
+			}
+
+			int recorded = log[i++];
+			double seconds = Replay_Seconds() - start;
+
+			printf("%lu ticks, %ld checkpoints in %.3f ms", (unsigned long)ticks, checkpoints, seconds * 1e3);
+			if (seconds > 0) {
+				printf(" (%.0f ticks/s)", ticks / seconds);
+			}
+			printf("\n");
+
+			if (recorded == RECORDING_TRUNCATED) {
+				printf("OK: recording ran out of space, replayed as far as it goes (%s)\n", Replay_ResultName(result));
+				return EXIT_SUCCESS;
+			}
+
+			if (recorded != (int)result) {
+				printf("DIVERGED: game ended %s, recorded as %s\n", Replay_ResultName(result), Replay_ResultName(recorded));
+				return EXIT_FAILURE;
+			}
+
+			printf("OK: %s with length %d, same as recorded\n", Replay_ResultName(result), game.snakes[0].size);
+			return EXIT_SUCCESS;
+		} else if (byte >> 5 <= CENTRE) {
+			enum DirectionChange directionChange = byte >> 5;
+			int count = (byte & (RECORDING_MAX_RUN - 1)) + 1;
+
+			for (int tick = 0; tick < count; tick++) {
+				if (result != GAME_PLAYING) {
+					printf("DIVERGED: game ended %s at tick %lu, but the recording goes on\n", Replay_ResultName(result), (unsigned long)ticks);
+					return EXIT_FAILURE;
+				}
+
+				result = Game_Step(&game, directionChange);
+				hash = Recording_Hash(hash, game.cube.map);
+				ticks++;
+			}
+		} else {
+			fprintf(stderr, "bad byte %02x at offset %ld\n", byte, i - 1);
+			return EXIT_FAILURE;
+		}
+	}
+
+	fprintf(stderr, "recording ends without an end after %lu ticks\n", (unsigned long)ticks);
+	return EXIT_FAILURE;
+}
+
+/* Gets the name of a result as recorded */
+const char* Replay_ResultName(int result) {
+	if (result >= 0 && result < (int)(sizeof(Replay_resultNames) / sizeof(Replay_resultNames[0]))) {
+		return Replay_resultNames[result];
+	}
+
+	return "unknown";
+}
+
+/* Gets a monotonic time in seconds */
+double Replay_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	bool verbose = false;
+	long length;
+	int option;
+
+	while ((option = getopt(argc, argv, "v")) != -1) {
+		switch (option) {
+			case 'v':
+				verbose = true;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-v] RECORDING\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1) {
+		fprintf(stderr, "usage: %s [-v] RECORDING\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	uint8_t* log = Replay_Read(argv[optind], &length);
+	if (log == NULL) {
+		return EXIT_FAILURE;
+	}
+
+	int status = Replay_Run(log, length, verbose);
+	free(log);
+
+	return status;
+}
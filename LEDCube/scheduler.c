@@ -0,0 +1,44 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "scheduler.h"
+#include "hardware.h" // Needed for the clock and to sleep
+
+/* SCHEDULER FUNCTIONS */
+/* Start a schedule of ticks every period milliseconds, with the first tick due straight away */
+void Scheduler_Init(struct Scheduler* scheduler, uint32_t period, enum Scheduler_Policy policy) {
+	scheduler->period = period;
+	scheduler->nextTick = Hardware_GetMillis();
+	scheduler->policy = policy;
+	scheduler->ticksSkipped = 0;
+}
+
+/* Sleep until the next tick is due */
+/* Returns the number of ticks to run now, which is more than 1 only when catching up */
+int Scheduler_WaitForTick(struct Scheduler* scheduler) {
+	if (scheduler->period == 0) {
+		return 1;
+	}
+
+	uint32_t now = Hardware_GetMillis();
+
+	// Comparing the difference keeps working when the millisecond counter wraps around
+	if ((int32_t)(scheduler->nextTick - now) > 0) {
+		Hardware_SleepUntil(scheduler->nextTick);
+		now = scheduler->nextTick;
+	}
+
+	// Count the due tick and every tick since whose time has also passed
+	uint32_t due = 1 + (now - scheduler->nextTick) / scheduler->period;
+	uint32_t run = due;
+
+	if (scheduler->policy == SCHEDULER_SKIP) {
+		run = 1;
+	} else if (run > SCHEDULER_MAX_CATCH_UP) {
+		run = SCHEDULER_MAX_CATCH_UP;
+	}
+
+	// Stay on the original schedule whatever was skipped, so ticks never drift
+	scheduler->ticksSkipped += due - run;
+	scheduler->nextTick += due * scheduler->period;
+
+	return (int)run;
+}
@@ -0,0 +1,30 @@
+/* Fixed timestep scheduler which paces the game loop off the hardware clock */
+/* Sleeps between ticks instead of spinning, so the tick rate no longer depends on how the code was compiled */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+/* DEFINING MACROS */
+#define SCHEDULER_MAX_CATCH_UP 4 // Most ticks run back to back when catching up, any further behind are skipped
+
+/* STRUCTS AND ENUMS */
+/* What to do about ticks whose time has already passed when the game gets round to them */
+enum Scheduler_Policy {
+	SCHEDULER_CATCH_UP, // Run them back to back (up to SCHEDULER_MAX_CATCH_UP) so the game keeps its average speed
+	SCHEDULER_SKIP, // Drop them and carry on from the next tick on the schedule
+};
+
+/* State of one schedule of ticks */
+struct Scheduler {
+	uint32_t period; // Milliseconds between ticks, 0 runs ticks as fast as possible
+	uint32_t nextTick; // Time (in milliseconds of Hardware_GetMillis) the next tick is due
+	enum Scheduler_Policy policy;
+	unsigned long ticksSkipped; // Number of ticks dropped so far
+};
+
+/* FUNCTION DECLARATIONS */
+void Scheduler_Init(struct Scheduler* scheduler, uint32_t period, enum Scheduler_Policy policy);
+int Scheduler_WaitForTick(struct Scheduler* scheduler);
+
+#endif
@@ -0,0 +1,382 @@
+/* Headless driver playing many games of snake offline, for tuning the difficulty and testing controllers */
+/* Usage: ledCubeSim [-n GAMES] [-s SEED] [-p POLICIES] [-l LENGTHS] [-t TICKS] [-j THREADS] [-o TRACE]
+ *        plays GAMES games (1000) with seeds SEED, SEED + 1, ... (1), steered by each of POLICIES (greedy, see
+ *        policy.h) and won at each of LENGTHS (WIN_LENGTH), cut off after TICKS steps (10000), then reports how
+ *        they went. POLICIES and LENGTHS are comma separated lists, so one run can sweep over them. The games
+ *        are spread over THREADS threads (one per core), which does not change the results. Every tick of every
+ *        game is written to the file TRACE, if given (see trace.h) */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "policy.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* DEFINING MACROS */
+#define SIM_CHUNK 64 // Number of games a worker takes from the queue at once, and so the size of its arena
+#define SIM_MAX_THREADS 256
+#define SIM_MAX_SWEEP 16 // Most values a list of -p or -l can have
+#define SIM_CACHE_LINE 64
+
+/* STRUCTS AND ENUMS */
+/* Ways a game can end, including running out of ticks */
+enum Sim_Ending {
+	SIM_WON,
+	SIM_HIT_WALL,
+	SIM_HIT_SNAKE,
+	SIM_TIMED_OUT,
+	SIM_ENDINGS,
+};
+
+/* What to play */
+struct Sim_Config {
+	long games;
+	uint32_t firstSeed;
+	enum Policy_Kind kind;
+	int winLength;
+	long maxTicks;
+	struct Trace* trace; // Where every tick goes, NULL for none
+	int sweep; // Which of the configurations of the run this is
+};
+
+/* Totals over all games played */
+struct Sim_Totals {
+	long games;
+	long ticks;
+	long length;
+	long longest;
+	long endings[SIM_ENDINGS];
+};
+
+/* One game in the arena of a worker */
+struct Sim_Slot {
+	struct GameState game;
+	struct Policy policy;
+	uint32_t seed;
+	long ticks;
+	bool playing;
+};
+
+/* Everything a worker thread writes to while playing, allocated by the worker itself */
+/* So that no two threads share memory, or even a cache line, until the results are merged */
+struct Sim_Arena {
+	struct Sim_Slot slots[SIM_CHUNK];
+	struct Sim_Totals totals;
+	struct Trace_Batch trace; // Records of the trace this worker has taken to fill in
+};
+
+/* Shared by all the workers playing one configuration */
+struct Sim_Batch {
+	const struct Sim_Config* config;
+	long nextGame; // Index of the first game not yet handed out, only ever changed atomically
+	struct Sim_Totals totals; // Merged atomically by each worker when it runs out of games
+};
+
+/* FUNCTION DECLARATIONS */
+void* Sim_Worker(void* argument);
+void Sim_PlayChunk(struct Sim_Arena* arena, const struct Sim_Config* config, long first, int count);
+void Sim_Merge(struct Sim_Totals* shared, const struct Sim_Totals* local);
+void Sim_Run(const struct Sim_Config* config, int threads, struct Sim_Totals* totals);
+double Sim_Seconds(void);
+void Sim_Report(const struct Sim_Config* config, const struct Sim_Totals* totals, double seconds);
+int Sim_ParseList(char* list, const char** values, int max);
+
+/* GLOBAL VARIABLES */
+/* Names of the ways a game can end, in the order of enum Sim_Ending */
+const char* const Sim_endingNames[SIM_ENDINGS] = { "won", "hit wall", "hit itself", "timed out" };
+
+/* SIMULATION FUNCTIONS */
+/* Thread taking chunks of games from the queue of a batch until there are none left */
+void* Sim_Worker(void* argument) {
+	struct Sim_Batch* batch = argument;
+	const struct Sim_Config* config = batch->config;
+	struct Sim_Arena* arena;
+
+	if (posix_memalign((void**)&arena, SIM_CACHE_LINE, sizeof(*arena)) != 0) {
+		perror("posix_memalign");
+		exit(EXIT_FAILURE);
+	}
+	memset(&arena->totals, 0, sizeof(arena->totals));
+	if (config->trace != NULL && !Trace_StartBatch(&arena->trace, config->trace)) {
+		exit(EXIT_FAILURE);
+	}
+
+	while (true) {
+		// Claim the next chunk of games, the counter is the whole of the queue
+		long first = __atomic_fetch_add(&batch->nextGame, SIM_CHUNK, __ATOMIC_RELAXED);
+		if (first >= config->games) {
+			break;
+		}
+
+		int count = config->games - first < SIM_CHUNK ? config->games - first : SIM_CHUNK;
+		Sim_PlayChunk(arena, config, first, count);
+	}
+
+	Sim_Merge(&batch->totals, &arena->totals);
+	if (config->trace != NULL) {
+		Trace_FinishBatch(&arena->trace);
+	}
+	free(arena);
+
+	return NULL;
+}
+
+/* Plays games first to first + count - 1 of config in the slots of arena, a tick of every game at a time */
+/* Game i gets seed firstSeed + i and its controller a stream of random numbers of its own, whichever worker plays it */
+void Sim_PlayChunk(struct Sim_Arena* arena, const struct Sim_Config* config, long first, int count) {
+	int playing = count;
+
+	for (int i = 0; i < count; i++) {
+		struct Sim_Slot* slot = &arena->slots[i];
+		uint32_t seed = config->firstSeed + first + i;
+
+		Game_Init(&slot->game, seed);
+		slot->game.winLength = config->winLength;
+		// The controller gets its own stream of random numbers, so it does not change where apples go
+		Policy_Init(&slot->policy, config->kind, ~seed);
+		slot->seed = seed;
+		slot->ticks = 0;
+		slot->playing = true;
+	}
+
+	while (playing > 0) {
+		for (int i = 0; i < count; i++) {
+			struct Sim_Slot* slot = &arena->slots[i];
+			enum Sim_Ending ending;
+
+			if (!slot->playing) {
+				continue;
+			}
+
+			enum DirectionChange directionChange = Policy_Choose(&slot->policy, &slot->game, &slot->game.snakes[0]);
+			enum GameResult result = Game_Step(&slot->game, directionChange);
+			if (config->trace != NULL) {
+				Trace_Add(&arena->trace, slot->seed, slot->ticks, config->sweep, directionChange, &slot->game.snakes[0], slot->game.cube.map);
+			}
+			slot->ticks++;
+
+			switch (result) {
+				case GAME_PLAYING:
+					if (slot->ticks < config->maxTicks) {
+						continue;
+					}
+					ending = SIM_TIMED_OUT;
+					break;
+				case GAME_WON:
+					ending = SIM_WON;
+					break;
+				case GAME_HIT_WALL:
+					ending = SIM_HIT_WALL;
+					break;
+				case GAME_HIT_SNAKE:
+				default:
+					ending = SIM_HIT_SNAKE;
+					break;
+			}
+
+			// The game is over, add it to the totals of this worker
+			struct Sim_Totals* totals = &arena->totals;
+			totals->games++;
+			totals->ticks += slot->ticks;
+			totals->length += slot->game.snakes[0].size;
+			if (slot->game.snakes[0].size > totals->longest) {
+				totals->longest = slot->game.snakes[0].size;
+			}
+			totals->endings[ending]++;
+
+			slot->playing = false;
+			playing--;
+		}
+	}
+}
+
+/* Adds the totals of a worker to the shared totals with atomic operations, so workers never wait on a lock */
+void Sim_Merge(struct Sim_Totals* shared, const struct Sim_Totals* local) {
+	__atomic_fetch_add(&shared->games, local->games, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&shared->ticks, local->ticks, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&shared->length, local->length, __ATOMIC_RELAXED);
+	for (int i = 0; i < SIM_ENDINGS; i++) {
+		__atomic_fetch_add(&shared->endings[i], local->endings[i], __ATOMIC_RELAXED);
+	}
+
+	// Maximum by compare and swap, retrying if another worker raised it in the meantime
+	long longest = __atomic_load_n(&shared->longest, __ATOMIC_RELAXED);
+	while (local->longest > longest) {
+		if (__atomic_compare_exchange_n(&shared->longest, &longest, local->longest, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+}
+
+/* Plays every game of config spread over the given number of threads */
+void Sim_Run(const struct Sim_Config* config, int threads, struct Sim_Totals* totals) {
+	pthread_t workers[SIM_MAX_THREADS];
+	struct Sim_Batch batch;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.config = config;
+
+	for (int i = 0; i < threads; i++) {
+		if (pthread_create(&workers[i], NULL, Sim_Worker, &batch) != 0) {
+			perror("pthread_create");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// Joining makes the merged totals of every worker visible here
+	for (int i = 0; i < threads; i++) {
+		pthread_join(workers[i], NULL);
+	}
+
+	*totals = batch.totals;
+}
+
+/* Gets a monotonic time in seconds */
+double Sim_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Prints how the games went */
+void Sim_Report(const struct Sim_Config* config, const struct Sim_Totals* totals, double seconds) {
+	printf("policy %s, seeds %lu to %lu, won at length %d\n", Policy_Name(config->kind), (unsigned long)config->firstSeed, (unsigned long)(config->firstSeed + config->games - 1), config->winLength);
+	printf("%ld games, %ld ticks in %.3f s\n", totals->games, totals->ticks, seconds);
+	if (seconds > 0) {
+		printf("%.0f games/s, %.0f ticks/s\n", totals->games / seconds, totals->ticks / seconds);
+	}
+	if (totals->games > 0) {
+		printf("mean length %.2f, longest %ld, mean ticks %.1f\n", (double)totals->length / totals->games, totals->longest, (double)totals->ticks / totals->games);
+	}
+
+	for (int i = 0; i < SIM_ENDINGS; i++) {
+		printf("%-10s %8ld", Sim_endingNames[i], totals->endings[i]);
+		if (totals->games > 0) {
+			printf(" (%.1f%%)", 100.0 * totals->endings[i] / totals->games);
+		}
+		printf("\n");
+	}
+}
+
+/* Splits a comma separated list in place, returns the number of values or -1 if there are too many */
+int Sim_ParseList(char* list, const char** values, int max) {
+	int count = 0;
+
+	for (char* value = strtok(list, ","); value != NULL; value = strtok(NULL, ",")) {
+		if (count == max) {
+			return -1;
+		}
+		values[count++] = value;
+	}
+
+	return count;
+}
+
+int main(int argc, char** argv) {
+	struct Sim_Config config = { 1000, 1, POLICY_GREEDY, WIN_LENGTH, 10000, NULL, 0 };
+	enum Policy_Kind kinds[SIM_MAX_SWEEP] = { POLICY_GREEDY };
+	int winLengths[SIM_MAX_SWEEP] = { WIN_LENGTH };
+	int kindCount = 1;
+	int winLengthCount = 1;
+	const char* values[SIM_MAX_SWEEP];
+	int threads = sysconf(_SC_NPROCESSORS_ONLN);
+	const char* tracePath = NULL;
+	struct Trace trace;
+	int option;
+
+	while ((option = getopt(argc, argv, "n:s:p:l:t:j:o:")) != -1) {
+		switch (option) {
+			case 'n':
+				config.games = strtol(optarg, NULL, 0);
+				break;
+			case 's':
+				config.firstSeed = strtoul(optarg, NULL, 0);
+				break;
+			case 'p':
+				kindCount = Sim_ParseList(optarg, values, SIM_MAX_SWEEP);
+				for (int i = 0; i < kindCount; i++) {
+					if (!Policy_FromName(values[i], &kinds[i])) {
+						fprintf(stderr, "unknown policy '%s' (straight, random, greedy or autopilot)\n", values[i]);
+						return EXIT_FAILURE;
+					}
+				}
+				break;
+			case 'l':
+				winLengthCount = Sim_ParseList(optarg, values, SIM_MAX_SWEEP);
+				for (int i = 0; i < winLengthCount; i++) {
+					winLengths[i] = strtol(values[i], NULL, 0);
+				}
+				break;
+			case 't':
+				config.maxTicks = strtol(optarg, NULL, 0);
+				break;
+			case 'j':
+				threads = strtol(optarg, NULL, 0);
+				break;
+			case 'o':
+				tracePath = optarg;
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n GAMES] [-s SEED] [-p POLICIES] [-l LENGTHS] [-t TICKS] [-j THREADS] [-o TRACE]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (kindCount < 1 || winLengthCount < 1) {
+		fprintf(stderr, "-p and -l take between 1 and %d comma separated values\n", SIM_MAX_SWEEP);
+		return EXIT_FAILURE;
+	}
+	if (threads < 1 || threads > SIM_MAX_THREADS) {
+		threads = threads < 1 ? 1 : SIM_MAX_THREADS;
+	}
+
+	if (tracePath != NULL) {
+		if (kindCount * winLengthCount > TRACE_MAX_SWEEPS) {
+			fprintf(stderr, "a trace can only tell %d configurations apart, not %d\n", TRACE_MAX_SWEEPS, kindCount * winLengthCount);
+			return EXIT_FAILURE;
+		}
+		if (!Trace_Create(&trace, tracePath)) {
+			return EXIT_FAILURE;
+		}
+		config.trace = &trace;
+	}
+
+	printf("%d threads\n", threads);
+
+	for (int k = 0; k < kindCount; k++) {
+		for (int l = 0; l < winLengthCount; l++) {
+			struct Sim_Totals totals;
+
+			config.kind = kinds[k];
+			config.winLength = winLengths[l];
+			config.sweep = k * winLengthCount + l;
+
+			double start = Sim_Seconds();
+			Sim_Run(&config, threads, &totals);
+
+			printf("\n");
+			Sim_Report(&config, &totals, Sim_Seconds() - start);
+		}
+	}
+
+	if (tracePath != NULL) {
+		uint64_t dropped = trace.dropped;
+		uint64_t records = Trace_Close(&trace);
+
+		printf("\n%llu records (%llu bytes) in %s", (unsigned long long)records, (unsigned long long)(TRACE_HEADER_SIZE + records * sizeof(struct Trace_Record)), tracePath);
+		if (dropped > 0) {
+			printf(", %llu ticks did not fit", (unsigned long long)dropped);
+		}
+		printf("\n");
+	}
+
+	return EXIT_SUCCESS;
+}
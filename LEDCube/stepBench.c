@@ -0,0 +1,382 @@
+/* Host micro-benchmark of the functions on the hot path of a step of the game */
+/* Usage: stepBench [-b BATCHES] [-o OPS]
+ *        times each function over snakes of lengths from 2 to NUM_LEDS, in BATCHES (201) batches of OPS (64) calls,
+ *        and prints one CSV line per function and length:
+ *            op,length,fill,ns_per_op,allocs_per_op,p50_ns,p99_ns
+ *        where fill is the fraction of the cube taken by the snake and the percentiles are over the batches.
+ *        'make host-bench' runs it into bin-host/stepBench.csv, to compare between commits
+ *        The snake follows a cycle through every cell, which only exists on a cube of even size */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+#include "frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* DEFINING MACROS */
+#define BENCH_CELLS 1024 // Number of positions Cube_GetCellStateAt is asked about, some outside the cube
+#define BENCH_MAX_LENGTHS 32
+
+/* STRUCTS AND ENUMS */
+/* Everything one function is timed on */
+/* The snake lies along Bench_cycle, a cycle through every cell of the cube, so it can follow it for ever */
+struct Bench_Context {
+	struct GameState game;
+	int position; // Index in Bench_cycle of the head of the snake
+	struct Frame_Encoder encoder;
+	Cube_Column maps[2][CUBE_COLUMNS]; // The cube before and after a step of the snake, encoded in turn
+	uint64_t changed[CUBE_DIRTY_WORDS]; // Columns which differ between the two maps
+	long calls;
+};
+
+/* A function being timed, called once per op */
+struct Bench_Op {
+	const char* name;
+	void (*setup)(struct Bench_Context* context);
+	long (*run)(struct Bench_Context* context);
+};
+
+/* FUNCTION DECLARATIONS */
+void Bench_MakeCycle(void);
+int Bench_MakeLengths(int* lengths);
+void Bench_Build(struct Bench_Context* context, int length);
+void Bench_NoSetup(struct Bench_Context* context);
+void Bench_FullSetup(struct Bench_Context* context);
+void Bench_DeltaSetup(struct Bench_Context* context);
+long Bench_Step(struct Bench_Context* context);
+long Bench_Turn(struct Bench_Context* context);
+long Bench_CellState(struct Bench_Context* context);
+long Bench_GenerateApple(struct Bench_Context* context);
+long Bench_Encode(struct Bench_Context* context);
+long Bench_Free(struct Bench_Context* context);
+void Bench_Time(const struct Bench_Op* op, int length, int batches, int ops);
+int Bench_CompareDoubles(const void* a, const void* b);
+double Bench_Seconds(void);
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* pointer, size_t size);
+
+/* GLOBAL VARIABLES */
+/* Cells of a cycle visiting every cell of the cube once, and the direction from each one to the next */
+uint16_t Bench_cycle[NUM_LEDS];
+enum Direction Bench_cycleDirections[NUM_LEDS];
+
+/* Positions Cube_GetCellStateAt is asked about */
+int Bench_cells[BENCH_CELLS][3];
+
+/* Number of allocations made by the game code, counted by linking with --wrap (see the Makefile) */
+long Bench_allocations;
+
+/* Results of the timed functions end up here, so that the compiler cannot leave them out */
+volatile long Bench_sink;
+
+/* Functions timed */
+const struct Bench_Op Bench_ops[] = {
+	{ "Snake_Step", Bench_NoSetup, Bench_Step },
+	{ "Snake_Turn", Bench_NoSetup, Bench_Turn },
+	{ "Cube_GetCellStateAt", Bench_NoSetup, Bench_CellState },
+	{ "Cube_GenerateApple", Bench_NoSetup, Bench_GenerateApple },
+	{ "Frame_Encode/full", Bench_FullSetup, Bench_Encode },
+	{ "Frame_Encode/delta", Bench_DeltaSetup, Bench_Encode },
+	{ "Snake_Free", Bench_NoSetup, Bench_Free },
+};
+
+/* ALLOCATION COUNTING */
+/* The game is meant to never allocate, these catch it if it starts to */
+void* __wrap_malloc(size_t size) {
+	Bench_allocations++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+	Bench_allocations++;
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+	Bench_allocations++;
+	return __real_realloc(pointer, size);
+}
+
+/* BENCHMARK FUNCTIONS */
+/* Makes a cycle through every cell, out along the z = 0 line of a serpentine path through the xy plane */
+/* Then back through the other layers, serpentining over z = 1 to 7 and returning down the first cell of the path */
+/* (on an 8x8x8 cube, other even sizes go the same way) */
+void Bench_MakeCycle() {
+	int count = 0;
+	int last = CUBE_COLUMNS - 1;
+
+	for (int z = 0; z < CUBE_SIZE; z++) {
+		// Cells of the serpentine path through the xy plane go along z = 0 first, then the rest in rows of z
+		int from = z == 0 ? 0 : (z % 2 == 1 ? last : 1);
+		int to = z == 0 ? last : (z % 2 == 1 ? 1 : last);
+		int step = from <= to ? 1 : -1;
+
+		for (int a = from; a != to + step; a += step) {
+			int y = a / CUBE_SIZE;
+			int x = y % 2 == 0 ? a % CUBE_SIZE : CUBE_SIZE - 1 - a % CUBE_SIZE;
+			Bench_cycle[count++] = CELL_INDEX(x, y, z);
+		}
+	}
+
+	// Back down the first cell of the path to where the cycle started
+	for (int z = CUBE_SIZE - 1; z >= 1; z--) {
+		Bench_cycle[count++] = CELL_INDEX(0, 0, z);
+	}
+
+	for (int i = 0; i < NUM_LEDS; i++) {
+		uint16_t cell = Bench_cycle[i];
+		uint16_t next = Bench_cycle[(i + 1) % NUM_LEDS];
+
+		for (int direction = 0; direction < DIRECTIONS; direction++) {
+			const int8_t* step = Snake_StepOf(direction);
+
+			if (CELL_X(cell) + step[0] == CELL_X(next) && CELL_Y(cell) + step[1] == CELL_Y(next) && CELL_Z(cell) + step[2] == CELL_Z(next)) {
+				Bench_cycleDirections[i] = direction;
+			}
+		}
+	}
+}
+
+/* Gets the lengths the functions are timed at, doubling up to half the cube then closing in on a full cube */
+/* 2, 4, ..., 256, 384, 448, 480, 504, 511, 512 on an 8x8x8 cube */
+int Bench_MakeLengths(int* lengths) {
+	const int parts[] = { 4, 8, 16, 64, NUM_LEDS, 0 };
+	int count = 0;
+
+	for (int length = 2; length <= NUM_LEDS / 2; length *= 2) {
+		lengths[count++] = length;
+	}
+
+	// A part of 0 stands for the full cube
+	for (int i = 0; i < (int)(sizeof(parts) / sizeof(parts[0])); i++) {
+		int length = parts[i] == 0 ? NUM_LEDS : NUM_LEDS - NUM_LEDS / parts[i];
+
+		if (length > lengths[count - 1]) {
+			lengths[count++] = length;
+		}
+	}
+
+	return count;
+}
+
+/* Sets up a game with a snake of the given length along the start of the cycle, and no apple */
+void Bench_Build(struct Bench_Context* context, int length) {
+	struct GameState* game = &context->game;
+	struct Snake* snake = &game->snakes[0];
+
+	Game_Init(game, 1);
+	Cube_Clear(game);
+
+	snake->head = 0;
+	snake->tail = 0;
+	snake->body[0] = Bench_cycle[0];
+	snake->size = 1;
+	Cube_SetBitAt(game, CELL_X(Bench_cycle[0]), CELL_Y(Bench_cycle[0]), CELL_Z(Bench_cycle[0]));
+	Snake_SetBitAt(game, CELL_X(Bench_cycle[0]), CELL_Y(Bench_cycle[0]), CELL_Z(Bench_cycle[0]));
+
+	for (int i = 1; i < length; i++) {
+		Snake_AddHead(game, snake, CELL_X(Bench_cycle[i]), CELL_Y(Bench_cycle[i]), CELL_Z(Bench_cycle[i]));
+		snake->size++;
+	}
+
+	context->position = length - 1;
+	snake->direction = Bench_cycleDirections[context->position];
+	context->calls = 0;
+}
+
+/* For functions which need nothing more than the game */
+void Bench_NoSetup(struct Bench_Context* context) {
+	(void)context;
+}
+
+/* Takes the maps before and after a step of the snake, for Frame_Encode to send alternately */
+void Bench_FullSetup(struct Bench_Context* context) {
+	struct GameState after = context->game;
+
+	Snake_Step(&after, &after.snakes[0]);
+
+	memcpy(context->maps[0], context->game.cube.map, sizeof(context->maps[0]));
+	memcpy(context->maps[1], after.cube.map, sizeof(context->maps[1]));
+	memset(context->changed, 0, sizeof(context->changed));
+	for (int i = 0; i < CUBE_COLUMNS; i++) {
+		if (context->maps[0][i] != context->maps[1][i]) {
+			context->changed[i / 64] |= (uint64_t)1 << i % 64;
+		}
+	}
+
+	Frame_InitEncoder(&context->encoder, false);
+}
+
+/* Same as Bench_FullSetup, for a cube which understands delta frames */
+void Bench_DeltaSetup(struct Bench_Context* context) {
+	Bench_FullSetup(context);
+	Frame_InitEncoder(&context->encoder, true);
+}
+
+/* Moves the snake one step along the cycle, which never runs into anything unless the snake fills the cube */
+long Bench_Step(struct Bench_Context* context) {
+	struct Snake* snake = &context->game.snakes[0];
+
+	snake->direction = Bench_cycleDirections[context->position];
+	if (Snake_Step(&context->game, snake)) {
+		context->position = (context->position + 1) % NUM_LEDS;
+	}
+
+	return snake->head;
+}
+
+/* Turns the snake each way in turn */
+long Bench_Turn(struct Bench_Context* context) {
+	Snake_Turn(&context->game.snakes[0], context->calls++ % 5);
+	return context->game.snakes[0].direction;
+}
+
+/* Asks for the state of a cell */
+long Bench_CellState(struct Bench_Context* context) {
+	const int* cell = Bench_cells[context->calls++ % BENCH_CELLS];
+	return Cube_GetCellStateAt(&context->game, cell[0], cell[1], cell[2]);
+}
+
+/* Places an apple, then takes it away again so the cube stays as full as it was */
+long Bench_GenerateApple(struct Bench_Context* context) {
+	struct GameState* game = &context->game;
+
+	if (!Cube_GenerateApple(game)) {
+		return 0;
+	}
+
+	Cube_ClearBitAt(game, CELL_X(game->cube.apple), CELL_Y(game->cube.apple), CELL_Z(game->cube.apple));
+	return game->cube.apple;
+}
+
+/* Encodes the next frame, like Game_Render does after a step */
+long Bench_Encode(struct Bench_Context* context) {
+	uint8_t frame[FRAME_MAX_SIZE];
+	return Frame_Encode(&context->encoder, context->maps[context->calls++ & 1], context->changed, frame);
+}
+
+/* Empties the snake, which has to happen without going through its segments */
+long Bench_Free(struct Bench_Context* context) {
+	Snake_Free(&context->game.snakes[0]);
+	return context->game.snakes[0].size;
+}
+
+/* Times op at a length and prints its CSV line */
+void Bench_Time(const struct Bench_Op* op, int length, int batches, int ops) {
+	struct Bench_Context* context = malloc(sizeof(*context));
+	double* samples = malloc(batches * sizeof(*samples));
+	double total = 0;
+	long sink = 0;
+
+	if (context == NULL || samples == NULL) {
+		perror("malloc");
+		exit(EXIT_FAILURE);
+	}
+
+	Bench_Build(context, length);
+	op->setup(context);
+
+	// Warm up the caches and branch predictors before anything is timed
+	for (int i = 0; i < ops; i++) {
+		sink += op->run(context);
+	}
+
+	long allocations = Bench_allocations;
+
+	for (int batch = 0; batch < batches; batch++) {
+		double start = Bench_Seconds();
+		for (int i = 0; i < ops; i++) {
+			sink += op->run(context);
+		}
+		double seconds = Bench_Seconds() - start;
+
+		samples[batch] = seconds * 1e9 / ops;
+		total += seconds;
+	}
+
+	allocations = Bench_allocations - allocations;
+	qsort(samples, batches, sizeof(*samples), Bench_CompareDoubles);
+
+	printf("%s,%d,%.4f,%.2f,%.4f,%.2f,%.2f\n", op->name, length, (double)length / NUM_LEDS, total * 1e9 / ((double)batches * ops), (double)allocations / ((double)batches * ops), samples[batches / 2], samples[batches * 99 / 100]);
+
+	Bench_sink = sink;
+	free(samples);
+	free(context);
+}
+
+/* Orders doubles for qsort */
+int Bench_CompareDoubles(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/* Gets a monotonic time in seconds */
+double Bench_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	int lengths[BENCH_MAX_LENGTHS];
+	int batches = 201;
+	int ops = 64;
+	int option;
+
+	while ((option = getopt(argc, argv, "b:o:")) != -1) {
+		switch (option) {
+			case 'b':
+				batches = strtol(optarg, NULL, 0);
+				break;
+			case 'o':
+				ops = strtol(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-b BATCHES] [-o OPS]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	if (batches < 1 || ops < 1) {
+		fprintf(stderr, "BATCHES and OPS have to be at least 1\n");
+		return EXIT_FAILURE;
+	}
+
+	if (CUBE_SIZE % 2 != 0) {
+		fprintf(stderr, "the snake needs a cycle through every cell, which a cube of odd size does not have\n");
+		return EXIT_FAILURE;
+	}
+
+	Bench_MakeCycle();
+	int lengthCount = Bench_MakeLengths(lengths);
+
+	// Positions one step either side of the cube too, as the snake asks about those
+	struct Random random;
+	Random_Seed(&random, 1);
+	for (int i = 0; i < BENCH_CELLS; i++) {
+		for (int d = 0; d < 3; d++) {
+			Bench_cells[i][d] = (int)Random_Below(&random, CUBE_SIZE + 2) - 1;
+		}
+	}
+
+	printf("op,length,fill,ns_per_op,allocs_per_op,p50_ns,p99_ns\n");
+
+	for (int o = 0; o < (int)(sizeof(Bench_ops) / sizeof(Bench_ops[0])); o++) {
+		for (int l = 0; l < lengthCount; l++) {
+			Bench_Time(&Bench_ops[o], lengths[l], batches, ops);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#include "stream.h"
+
+#include <string.h>
+
+/* RING FUNCTIONS */
+/* Empties ring, before the interrupt filling it is enabled */
+void Stream_InitRing(struct Stream_Ring* ring) {
+	ring->head = 0;
+	ring->tail = 0;
+	ring->overruns = 0;
+}
+
+/* Adds a byte from the PC to ring, called from the RX interrupt. Returns false (dropping it) if the ring is full */
+/* The byte is written before head moves on, so the consumer never sees a byte which is not there yet */
+bool Stream_Push(struct Stream_Ring* ring, uint8_t byte) {
+	uint32_t head = ring->head;
+
+	if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == STREAM_RING_SIZE) {
+		ring->overruns++;
+		return false;
+	}
+
+	ring->bytes[head % STREAM_RING_SIZE] = byte;
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+/* Number of bytes in ring which have not been dealt with, as seen by the consumer */
+uint32_t Stream_Available(const struct Stream_Ring* ring) {
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail;
+}
+
+/* READER FUNCTIONS */
+/* Gets ready to read a stream from its start */
+void Stream_InitReader(struct Stream_Reader* reader) {
+	reader->copied = 0;
+	reader->skipped = 0;
+}
+
+/* Finds the next whole message in ring, returns false if there is not one yet */
+/* The message stays in the ring until Stream_Release, so the interrupt cannot write over the map whilst it is read */
+/* Anything which is not the start of a message is skipped, which only happens if the PC sent something wrong */
+bool Stream_Next(struct Stream_Reader* reader, struct Stream_Ring* ring, struct Stream_Message* message) {
+	uint32_t tail = ring->tail;
+	uint32_t available = Stream_Available(ring);
+
+	while (available > 0) {
+		uint8_t type = ring->bytes[tail % STREAM_RING_SIZE];
+
+		if (type == STREAM_HELLO) {
+			message->type = STREAM_MESSAGE_HELLO;
+			message->length = 1;
+			return true;
+		}
+
+		if (type == STREAM_FRAME) {
+			if (available < STREAM_FRAME_SIZE) {
+				return false;
+			}
+
+			uint32_t start = (tail + STREAM_HEADER_SIZE) % STREAM_RING_SIZE;
+			const uint8_t* map = ring->bytes + start;
+
+			message->type = STREAM_MESSAGE_FRAME;
+			message->cube = ring->bytes[(tail + 1) % STREAM_RING_SIZE];
+			message->length = STREAM_FRAME_SIZE;
+
+			// A map which wraps round (or is not lined up for columns of more than a byte) has to be copied out
+			if (start + CUBE_MAP_SIZE <= STREAM_RING_SIZE && start % sizeof(Cube_Column) == 0) {
+				message->map = (const Cube_Column*)map;
+			} else {
+				uint32_t first = start + CUBE_MAP_SIZE <= STREAM_RING_SIZE ? CUBE_MAP_SIZE : STREAM_RING_SIZE - start;
+
+				memcpy(reader->map, map, first);
+				memcpy((uint8_t*)reader->map + first, ring->bytes, CUBE_MAP_SIZE - first);
+				message->map = reader->map;
+				reader->copied++;
+			}
+
+			return true;
+		}
+
+		reader->skipped++;
+		tail++;
+		available--;
+		__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+	}
+
+	return false;
+}
+
+/* Hands the bytes of a message from Stream_Next back to the interrupt, once nothing is reading them any more */
+void Stream_Release(struct Stream_Ring* ring, const struct Stream_Message* message) {
+	__atomic_store_n(&ring->tail, ring->tail + message->length, __ATOMIC_RELEASE);
+}
+
+/* PC FUNCTIONS */
+/* Encodes a frame of map for the given cube into bytes (which must hold STREAM_FRAME_SIZE), returns its size */
+int Stream_EncodeFrame(int cube, const Cube_Column* map, uint8_t* bytes) {
+	bytes[0] = STREAM_FRAME;
+	bytes[1] = cube;
+	memcpy(bytes + STREAM_HEADER_SIZE, map, CUBE_MAP_SIZE);
+
+	return STREAM_FRAME_SIZE;
+}
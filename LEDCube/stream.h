@@ -0,0 +1,72 @@
+/* Animations streamed from a PC to the board, which passes them on to the cubes (built with STREAM=1) */
+/* The PC sends STREAM_HELLO and the board answers STREAM_WINDOW followed by the number of frames it has room for.
+ * The PC then sends up to that many frames, each being STREAM_FRAME, the index of the cube it is for and the
+ * CUBE_MAP_SIZE bytes of a map laid out as Cube.map is (the body of a full frame, see frame.h). The board answers
+ * STREAM_CREDIT for every frame it has passed on to its cube, after which the PC can send one more. So the board
+ * never has to drop a byte, and a PC which keeps sending whenever it has credit keeps the links to the cubes busy
+ * Credits which were on their way when the PC sent STREAM_HELLO are not counted, as STREAM_WINDOW starts over
+ *
+ * The bytes from the PC are put into a Stream_Ring by the RX interrupt of its USART, a ring buffer with a single
+ * producer (the interrupt) and a single consumer (the main loop) needing no locks. The main loop encodes the map of
+ * a frame for its cube straight out of the ring, only copying it out first if it wraps round the end */
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cube.h" // Needed for the size of a map
+
+/* DEFINING MACROS */
+#define STREAM_HELLO 0xB1 // PC starts streaming
+#define STREAM_WINDOW 0xB2 // Board has room for the number of frames in the next byte
+#define STREAM_CREDIT 0xB3 // Board has room for one more frame
+#define STREAM_FRAME 0xB4 // Start of a frame
+#define STREAM_HEADER_SIZE 2
+#define STREAM_FRAME_SIZE (STREAM_HEADER_SIZE + CUBE_MAP_SIZE)
+
+/* Bytes the ring holds, a power of two so indices can run on and wrap round by themselves */
+#define STREAM_RING_SIZE (CUBE_MAP_SIZE <= 128 ? 1024 : 4096)
+#define STREAM_WINDOW_FRAMES (STREAM_RING_SIZE / STREAM_FRAME_SIZE) // 15 on an 8x8x8 cube
+
+/* STRUCTS AND ENUMS */
+/* Bytes from the PC which have not been dealt with yet, from tail up to head */
+/* Only the producer writes head and only the consumer writes tail, each reading the other's with acquire */
+struct Stream_Ring {
+	uint8_t bytes[STREAM_RING_SIZE];
+	uint32_t head;
+	uint32_t tail;
+	unsigned long overruns; // Bytes dropped because the ring was full, which flow control should never let happen
+};
+
+/* What has come in from the PC */
+enum Stream_MessageType {
+	STREAM_MESSAGE_HELLO,
+	STREAM_MESSAGE_FRAME,
+};
+
+/* One whole message in the ring, left there until Stream_Release */
+struct Stream_Message {
+	enum Stream_MessageType type;
+	int cube;
+	const Cube_Column* map; // Map of a frame, in the ring itself unless it wrapped round
+	int length; // Bytes the message takes in the ring
+};
+
+/* Main loop end of the stream */
+struct Stream_Reader {
+	Cube_Column map[CUBE_COLUMNS]; // Map of a frame which wrapped round the end of the ring
+	unsigned long copied; // Frames which had to be copied out of the ring
+	unsigned long skipped; // Bytes which were not part of any message
+};
+
+/* FUNCTION DECLARATIONS */
+void Stream_InitRing(struct Stream_Ring* ring);
+bool Stream_Push(struct Stream_Ring* ring, uint8_t byte);
+uint32_t Stream_Available(const struct Stream_Ring* ring);
+void Stream_InitReader(struct Stream_Reader* reader);
+bool Stream_Next(struct Stream_Reader* reader, struct Stream_Ring* ring, struct Stream_Message* message);
+void Stream_Release(struct Stream_Ring* ring, const struct Stream_Message* message);
+int Stream_EncodeFrame(int cube, const Cube_Column* map, uint8_t* bytes);
+
+#endif
@@ -0,0 +1,290 @@
+/* Host tool streaming animations to the board when it is built with STREAM=1, see stream.h */
+/* Usage: ledCubeStream [-b BAUD] [-c CUBES] [-f MAPS] [-n FRAMES] DEVICE
+ *        sends FRAMES frames to DEVICE, the serial port of the board (at BAUD, 460800) or the socket of ledCube-host
+ *        given in its LEDCUBE_STREAM. The frames are the maps of the file MAPS (CUBE_MAP_SIZE bytes each, laid out as
+ *        Cube.map is) over and over, or otherwise a plane sweeping to and fro through the cube along each axis in turn.
+ *        Frames go to each of CUBES (1) cubes in turn. Sends as fast as the board gives credit, then reports how fast
+ *        that was */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* DEFINING MACROS */
+#define SEND_REPLY_MILLIS 1000 // How long to wait for the board to answer STREAM_HELLO
+#define SEND_CREDIT_MILLIS 5000 // How long to wait for credit before giving up on the board
+#define SEND_HELLOS 5
+
+/* FUNCTION DECLARATIONS */
+int Send_Open(const char* device, uint32_t baud);
+speed_t Send_Speed(uint32_t baud);
+int Send_Read(int device, int millis);
+void Send_Write(int device, const uint8_t* bytes, int length);
+int Send_Hello(int device);
+void Send_Sweep(long frame, Cube_Column* map);
+double Send_Seconds(void);
+
+/* SEND FUNCTIONS */
+/* Opens the board, either a serial port set to raw bytes at baud or the socket of ledCube-host */
+int Send_Open(const char* device, uint32_t baud) {
+	struct stat status;
+	int file;
+
+	if (stat(device, &status) == 0 && S_ISSOCK(status.st_mode)) {
+		struct sockaddr_un address;
+
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, device, sizeof(address.sun_path) - 1);
+
+		file = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (file < 0 || connect(file, (struct sockaddr*)&address, sizeof(address)) != 0) {
+			perror(device);
+			exit(EXIT_FAILURE);
+		}
+
+		return file;
+	}
+
+	file = open(device, O_RDWR | O_NOCTTY);
+	if (file < 0) {
+		perror(device);
+		exit(EXIT_FAILURE);
+	}
+
+	struct termios settings;
+	if (tcgetattr(file, &settings) == 0) {
+		// Raw bytes, as cfmakeraw would set (which is not POSIX)
+		settings.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
+		settings.c_oflag &= ~OPOST;
+		settings.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+		settings.c_cflag &= ~(CSIZE | PARENB);
+		settings.c_cflag |= CS8;
+		cfsetispeed(&settings, Send_Speed(baud));
+		cfsetospeed(&settings, Send_Speed(baud));
+		settings.c_cflag |= CLOCAL | CREAD;
+		tcsetattr(file, TCSANOW, &settings);
+		tcflush(file, TCIOFLUSH);
+	}
+
+	return file;
+}
+
+/* Gets the termios speed of a baud rate */
+speed_t Send_Speed(uint32_t baud) {
+	switch (baud) {
+		case 9600: return B9600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		case 460800: return B460800;
+		case 921600: return B921600;
+		case 2000000: return B2000000;
+		case 3000000: return B3000000;
+	}
+
+	fprintf(stderr, "unsupported baud rate %lu\n", (unsigned long)baud);
+	exit(EXIT_FAILURE);
+}
+
+/* Reads the next byte from the board, -1 if none comes within millis */
+int Send_Read(int device, int millis) {
+	struct pollfd ready = { device, POLLIN, 0 };
+	uint8_t byte;
+
+	if (poll(&ready, 1, millis) <= 0 || read(device, &byte, 1) != 1) {
+		return -1;
+	}
+
+	return byte;
+}
+
+/* Writes all of bytes to the board */
+void Send_Write(int device, const uint8_t* bytes, int length) {
+	while (length > 0) {
+		ssize_t written = write(device, bytes, length);
+		if (written < 0 && errno != EINTR) {
+			perror("write");
+			exit(EXIT_FAILURE);
+		}
+		if (written > 0) {
+			bytes += written;
+			length -= written;
+		}
+	}
+}
+
+/* Starts the stream, returns the number of frames the board has room for, or -1 if it never answers */
+/* Credits for frames sent before are skipped, STREAM_WINDOW taking their place */
+int Send_Hello(int device) {
+	const uint8_t hello = STREAM_HELLO;
+
+	for (int i = 0; i < SEND_HELLOS; i++) {
+		Send_Write(device, &hello, 1);
+
+		int byte;
+		while ((byte = Send_Read(device, SEND_REPLY_MILLIS)) >= 0) {
+			if (byte == STREAM_WINDOW) {
+				return Send_Read(device, SEND_REPLY_MILLIS);
+			}
+		}
+	}
+
+	return -1;
+}
+
+/* Draws frame of the built in animation, a plane sweeping to and fro through the cube along x, then y, then z */
+void Send_Sweep(long frame, Cube_Column* map) {
+	int axis = frame / (2 * CUBE_SIZE) % 3;
+	int position = frame % (2 * CUBE_SIZE);
+
+	if (position >= CUBE_SIZE) {
+		position = 2 * CUBE_SIZE - 1 - position;
+	}
+
+	for (int y = 0; y < CUBE_SIZE; y++) {
+		for (int x = 0; x < CUBE_SIZE; x++) {
+			Cube_Column column = 0;
+
+			if ((axis == 0 && x == position) || (axis == 1 && y == position)) {
+				column = (Cube_Column)~0;
+			} else if (axis == 2) {
+				column = (Cube_Column)(1 << position);
+			}
+
+			map[CUBE_COLUMN_INDEX(x, y)] = column;
+		}
+	}
+}
+
+/* Seconds on the monotonic clock */
+double Send_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	uint32_t baud = 460800;
+	int cubes = 1;
+	const char* mapsPath = NULL;
+	long frames = -1;
+	int option;
+
+	while ((option = getopt(argc, argv, "b:c:f:n:")) != -1) {
+		switch (option) {
+			case 'b':
+				baud = strtoul(optarg, NULL, 0);
+				break;
+			case 'c':
+				cubes = atoi(optarg);
+				break;
+			case 'f':
+				mapsPath = optarg;
+				break;
+			case 'n':
+				frames = strtol(optarg, NULL, 0);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if (optind != argc - 1 || cubes < 1) {
+		fprintf(stderr, "usage: %s [-b BAUD] [-c CUBES] [-f MAPS] [-n FRAMES] DEVICE\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Every map of the file, or the built in animation
+	Cube_Column* maps = NULL;
+	long mapCount = 0;
+	if (mapsPath != NULL) {
+		FILE* file = fopen(mapsPath, "rb");
+		if (file == NULL) {
+			perror(mapsPath);
+			return EXIT_FAILURE;
+		}
+
+		fseek(file, 0, SEEK_END);
+		mapCount = ftell(file) / CUBE_MAP_SIZE;
+		rewind(file);
+
+		maps = malloc(mapCount * CUBE_MAP_SIZE + 1);
+		if (maps == NULL || mapCount == 0 || fread(maps, CUBE_MAP_SIZE, mapCount, file) != (size_t)mapCount) {
+			fprintf(stderr, "%s: no maps\n", mapsPath);
+			return EXIT_FAILURE;
+		}
+		fclose(file);
+	}
+	if (frames < 0) {
+		frames = mapCount > 0 ? mapCount : 1000;
+	}
+
+	int device = Send_Open(argv[optind], baud);
+	int window = Send_Hello(device);
+	if (window <= 0) {
+		fprintf(stderr, "%s: the board did not answer, is it built with STREAM=1?\n", argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	double start = Send_Seconds();
+	int credit = window;
+	long waits = 0;
+	uint8_t bytes[STREAM_FRAME_SIZE];
+	Cube_Column map[CUBE_COLUMNS];
+
+	// Send whenever there is credit, each frame being one of the window until the board has passed it on
+	for (long i = 0; i < frames; i++) {
+		waits += credit == 0;
+		while (credit == 0) {
+			int byte = Send_Read(device, SEND_CREDIT_MILLIS);
+			if (byte < 0) {
+				fprintf(stderr, "the board stopped giving credit after %ld frames\n", i);
+				return EXIT_FAILURE;
+			}
+			credit += byte == STREAM_CREDIT;
+		}
+
+		if (maps != NULL) {
+			memcpy(map, maps + i % mapCount * CUBE_COLUMNS, CUBE_MAP_SIZE);
+		} else {
+			Send_Sweep(i / cubes, map);
+		}
+
+		Send_Write(device, bytes, Stream_EncodeFrame(i % cubes, map, bytes));
+		credit--;
+	}
+
+	// Every frame has been passed on once all of the credit is back
+	while (credit < window) {
+		int byte = Send_Read(device, SEND_CREDIT_MILLIS);
+		if (byte < 0) {
+			fprintf(stderr, "the board did not pass on the last %d frames\n", window - credit);
+			return EXIT_FAILURE;
+		}
+		credit += byte == STREAM_CREDIT;
+	}
+
+	double seconds = Send_Seconds() - start;
+	printf("%ld frames in %.3f s (%.1f frames/s, %.0f bytes/s), window of %d frames, waited for credit %ld times\n",
+		frames, seconds, frames / seconds, frames * STREAM_FRAME_SIZE / seconds, window, waits);
+
+	close(device);
+	free(maps);
+	return EXIT_SUCCESS;
+}
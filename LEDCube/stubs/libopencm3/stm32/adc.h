@@ -0,0 +1,27 @@
+/* Host stand in for the part of libopencm3/stm32/adc.h used by ../ARCHIVED/compileTest.c (see archivedCore.c) */
+#ifndef STUBS_ADC_H
+#define STUBS_ADC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DEFINING MACROS */
+#define ADC1 0x50000000
+#define ADC_CCR_CKMODE_DIV1 1
+#define ADC_SMPR_SMP_61DOT5CYC 5
+#define ADC_CFGR1_RES_12_BIT 0
+
+/* FUNCTION DECLARATIONS */
+void adc_power_off(uint32_t adc);
+void adc_power_on(uint32_t adc);
+void adc_set_clk_prescale(uint32_t adc, uint32_t prescaler);
+void adc_disable_external_trigger_regular(uint32_t adc);
+void adc_set_right_aligned(uint32_t adc);
+void adc_set_sample_time_on_all_channels(uint32_t adc, uint8_t time);
+void adc_set_resolution(uint32_t adc, uint16_t resolution);
+void adc_set_regular_sequence(uint32_t adc, uint8_t length, uint8_t channel[]);
+void adc_start_conversion_regular(uint32_t adc);
+bool adc_eoc(uint32_t adc);
+uint32_t adc_read_regular(uint32_t adc);
+
+#endif
@@ -0,0 +1,25 @@
+/* Host stand in for the part of libopencm3/stm32/gpio.h used by ../ARCHIVED/compileTest.c (see archivedCore.c) */
+#ifndef STUBS_GPIO_H
+#define STUBS_GPIO_H
+
+#include <stdint.h>
+
+/* DEFINING MACROS */
+#define GPIOB 0x48000400
+#define GPIO5 (1 << 5)
+#define GPIO6 (1 << 6)
+#define GPIO7 (1 << 7)
+#define GPIO_MODE_OUTPUT 1
+#define GPIO_MODE_AF 2
+#define GPIO_PUPD_NONE 0
+#define GPIO_OTYPE_PP 0
+#define GPIO_OSPEED_100MHZ 3
+#define GPIO_AF7 7
+
+/* FUNCTION DECLARATIONS */
+void gpio_mode_setup(uint32_t gpioport, uint8_t mode, uint8_t pull_up_down, uint16_t gpios);
+void gpio_set_output_options(uint32_t gpioport, uint8_t otype, uint8_t speed, uint16_t gpios);
+void gpio_set_af(uint32_t gpioport, uint8_t alt_func_num, uint16_t gpios);
+void gpio_set(uint32_t gpioport, uint16_t gpios);
+
+#endif
@@ -0,0 +1,11 @@
+/* Host stand in for the part of libopencm3/stm32/rcc.h used by ../ARCHIVED/compileTest.c (see archivedCore.c) */
+#ifndef STUBS_RCC_H
+#define STUBS_RCC_H
+
+/* STRUCTS AND ENUMS */
+enum rcc_periph_clken { RCC_GPIOB, RCC_USART1, RCC_ADC12 };
+
+/* FUNCTION DECLARATIONS */
+void rcc_periph_clock_enable(enum rcc_periph_clken clken);
+
+#endif
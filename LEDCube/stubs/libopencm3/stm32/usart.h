@@ -0,0 +1,26 @@
+/* Host stand in for the part of libopencm3/stm32/usart.h used by ../ARCHIVED/compileTest.c (see archivedCore.c) */
+#ifndef STUBS_USART_H
+#define STUBS_USART_H
+
+#include <stdint.h>
+
+/* DEFINING MACROS */
+#define USART1 0x40013800
+#define USART_STOPBITS_1 0
+#define USART_MODE_TX_RX 0xC
+#define USART_PARITY_NONE 0
+#define USART_FLOWCONTROL_NONE 0
+
+/* FUNCTION DECLARATIONS */
+void usart_set_baudrate(uint32_t usart, uint32_t baud);
+void usart_set_databits(uint32_t usart, uint32_t bits);
+void usart_set_stopbits(uint32_t usart, uint32_t stopbits);
+void usart_set_mode(uint32_t usart, uint32_t mode);
+void usart_set_parity(uint32_t usart, uint32_t parity);
+void usart_set_flow_control(uint32_t usart, uint32_t flowcontrol);
+void usart_enable_rx_interrupt(uint32_t usart);
+void usart_enable_tx_interrupt(uint32_t usart);
+void usart_enable(uint32_t usart);
+void usart_send_blocking(uint32_t usart, uint16_t data);
+
+#endif
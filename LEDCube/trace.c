@@ -0,0 +1,364 @@
+/* INCLUDING NECESSARY LIBRARIES */
+#define _GNU_SOURCE // For O_DIRECT
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+/* WRITER FUNCTIONS */
+/* Creates an empty trace at path and starts its writer thread, returns false if it cannot */
+bool Trace_Create(struct Trace* trace, const char* path) {
+	trace->file = open(path, O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+	if (trace->file < 0 && errno == EINVAL) {
+		// Not every file system can do without the page cache (tmpfs for one), which only costs the writer thread
+		trace->file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	}
+	if (trace->file < 0) {
+		perror(path);
+		return false;
+	}
+
+	trace->allocated = 0;
+	trace->next = 0;
+	trace->dropped = 0;
+	trace->queue = NULL;
+	trace->closing = false;
+	pthread_mutex_init(&trace->lock, NULL);
+	pthread_cond_init(&trace->changed, NULL);
+
+	if (!Trace_Grow(trace, TRACE_GROW_SIZE) || !Trace_WriteHeader(trace, 0)) {
+		close(trace->file);
+		return false;
+	}
+
+	int error = pthread_create(&trace->writer, NULL, Trace_Writer, trace);
+	if (error != 0) {
+		fprintf(stderr, "trace: %s\n", strerror(error));
+		close(trace->file);
+		return false;
+	}
+
+	return true;
+}
+
+/* Gets batch ready to take records from trace, one for each thread writing to it, returns false if it cannot */
+bool Trace_StartBatch(struct Trace_Batch* batch, struct Trace* trace) {
+	size_t size = (TRACE_BUFFERS * TRACE_BATCH * sizeof(struct Trace_Record) + TRACE_HUGE_PAGE - 1) / TRACE_HUGE_PAGE * TRACE_HUGE_PAGE;
+
+	batch->trace = trace;
+	batch->filling = 0;
+	batch->next = NULL;
+	batch->end = NULL;
+
+	if (posix_memalign((void**)&batch->records, TRACE_HUGE_PAGE, size) != 0) {
+		perror("posix_memalign");
+		return false;
+	}
+	madvise(batch->records, size, MADV_HUGEPAGE);
+
+	for (int i = 0; i < TRACE_BUFFERS; i++) {
+		batch->buffers[i].records = batch->records + i * TRACE_BATCH;
+		batch->buffers[i].writing = false;
+	}
+
+	return true;
+}
+
+/* Gets the next record of batch to fill in, taking another batch from the trace if there are none left */
+/* Returns NULL, counting the record as dropped, if the trace is full */
+struct Trace_Record* Trace_Append(struct Trace_Batch* batch) {
+	if (batch->next == batch->end) {
+		struct Trace* trace = batch->trace;
+
+		if (batch->next != NULL) {
+			Trace_Submit(batch);
+		}
+
+		uint64_t first = __atomic_fetch_add(&trace->next, TRACE_BATCH, __ATOMIC_RELAXED);
+		if (first + TRACE_BATCH > TRACE_MAX_RECORDS) {
+			__atomic_fetch_add(&trace->dropped, 1, __ATOMIC_RELAXED);
+			return NULL;
+		}
+
+		// Only waits if the writer thread has yet to write the batch before last, when the disk cannot keep up
+		struct Trace_Buffer* buffer = &batch->buffers[batch->filling];
+		if (__atomic_load_n(&buffer->writing, __ATOMIC_ACQUIRE)) {
+			pthread_mutex_lock(&trace->lock);
+			while (buffer->writing) {
+				pthread_cond_wait(&trace->changed, &trace->lock);
+			}
+			pthread_mutex_unlock(&trace->lock);
+		}
+
+		buffer->first = first;
+		batch->next = buffer->records;
+		batch->end = buffer->records + TRACE_BATCH;
+	}
+
+	return batch->next++;
+}
+
+/* Hands the buffer being filled in to the writer thread, going on with the other one */
+void Trace_Submit(struct Trace_Batch* batch) {
+	struct Trace* trace = batch->trace;
+	struct Trace_Buffer* buffer = &batch->buffers[batch->filling];
+	struct Trace_Buffer** place = &trace->queue;
+
+#if TRACE_STREAM
+	_mm_sfence();
+#endif
+	pthread_mutex_lock(&trace->lock);
+	buffer->writing = true;
+	while (*place != NULL && (*place)->first < buffer->first) {
+		place = &(*place)->next;
+	}
+	buffer->next = *place;
+	*place = buffer;
+	pthread_cond_broadcast(&trace->changed);
+	pthread_mutex_unlock(&trace->lock);
+
+	batch->filling = (batch->filling + 1) % TRACE_BUFFERS;
+	batch->next = NULL;
+	batch->end = NULL;
+}
+
+/* Hands what was filled in of batch to the writer thread once its writer is done, the rest being left empty */
+/* Waits for both of its buffers to be written, so they can be freed */
+void Trace_FinishBatch(struct Trace_Batch* batch) {
+	struct Trace* trace = batch->trace;
+
+	if (batch->next != NULL) {
+		memset(batch->next, 0, (batch->end - batch->next) * sizeof(struct Trace_Record));
+		Trace_Submit(batch);
+	}
+
+	pthread_mutex_lock(&trace->lock);
+	for (int i = 0; i < TRACE_BUFFERS; i++) {
+		while (batch->buffers[i].writing) {
+			pthread_cond_wait(&trace->changed, &trace->lock);
+		}
+	}
+	pthread_mutex_unlock(&trace->lock);
+
+	free(batch->records);
+}
+
+/* Thread writing the buffers handed to trace, until the trace is closed */
+/* Batches handed out one after another are next to each other in the file, so as many of them as are queued are
+ * written at once. Each write waits for the disk and then for a core, so on a machine with no core to spare this
+ * keeps the disk busy with fewer, larger writes however many threads are filling buffers */
+void* Trace_Writer(void* argument) {
+	struct Trace* trace = argument;
+	struct Trace_Buffer* run[TRACE_MAX_RUN];
+
+	pthread_mutex_lock(&trace->lock);
+	while (true) {
+		while (trace->queue == NULL && !trace->closing) {
+			pthread_cond_wait(&trace->changed, &trace->lock);
+		}
+		if (trace->queue == NULL) {
+			break;
+		}
+
+		int count = 0;
+		while (trace->queue != NULL && count < TRACE_MAX_RUN && (count == 0 || trace->queue->first == run[count - 1]->first + TRACE_BATCH)) {
+			run[count++] = trace->queue;
+			trace->queue = trace->queue->next;
+		}
+
+		// The writers of the buffers leave them alone until they are written, so they are written without the lock
+		pthread_mutex_unlock(&trace->lock);
+		Trace_Write(trace, run, count);
+		pthread_mutex_lock(&trace->lock);
+
+		for (int i = 0; i < count; i++) {
+			__atomic_store_n(&run[i]->writing, false, __ATOMIC_RELEASE);
+		}
+		pthread_cond_broadcast(&trace->changed);
+	}
+	pthread_mutex_unlock(&trace->lock);
+
+	return NULL;
+}
+
+/* Writes count buffers holding batches one after another to where they go in the file of trace, growing the file if */
+/* it is not there yet. Counts their records as dropped if it cannot */
+void Trace_Write(struct Trace* trace, struct Trace_Buffer* const* run, int count) {
+	struct iovec vectors[TRACE_MAX_RUN];
+	off_t offset = TRACE_HEADER_SIZE + run[0]->first * sizeof(struct Trace_Record);
+	size_t end = offset + count * TRACE_BATCH * sizeof(struct Trace_Record);
+	int first = 0;
+
+	if (end > trace->allocated && !Trace_Grow(trace, end)) {
+		__atomic_fetch_add(&trace->dropped, (uint64_t)count * TRACE_BATCH, __ATOMIC_RELAXED);
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		vectors[i].iov_base = run[i]->records;
+		vectors[i].iov_len = TRACE_BATCH * sizeof(struct Trace_Record);
+	}
+
+	while (first < count) {
+		ssize_t written = pwritev(trace->file, vectors + first, count - first, offset);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			perror("trace");
+			__atomic_fetch_add(&trace->dropped, (uint64_t)(count - first) * TRACE_BATCH, __ATOMIC_RELAXED);
+			return;
+		}
+
+		// Step over what was written, which may end part of the way through a buffer
+		offset += written;
+		while (first < count && (size_t)written >= vectors[first].iov_len) {
+			written -= vectors[first].iov_len;
+			first++;
+		}
+		if (first < count) {
+			vectors[first].iov_base = (uint8_t*)vectors[first].iov_base + written;
+			vectors[first].iov_len -= written;
+		}
+	}
+}
+
+/* Makes the file of trace at least size bytes, allocated on disk so writing to them cannot fail, returns false if it cannot */
+/* Only the writer thread grows the file, once the trace has been created */
+bool Trace_Grow(struct Trace* trace, size_t size) {
+	size_t allocated = trace->allocated;
+	size_t target = allocated + (size - allocated + TRACE_GROW_SIZE - 1) / TRACE_GROW_SIZE * TRACE_GROW_SIZE;
+
+	if (target > TRACE_MAX_SIZE) {
+		target = TRACE_MAX_SIZE;
+	}
+
+	int error = posix_fallocate(trace->file, allocated, target - allocated);
+	if (error != 0) {
+		fprintf(stderr, "trace: %s\n", strerror(error));
+		return false;
+	}
+
+	trace->allocated = target;
+	return true;
+}
+
+/* Writes the header of trace, saying it holds records records, returns false if it cannot */
+bool Trace_WriteHeader(struct Trace* trace, uint64_t records) {
+	struct Trace_Header* header;
+
+	// O_DIRECT needs a whole block, lined up in memory as in the file
+	if (posix_memalign((void**)&header, TRACE_BLOCK, TRACE_HEADER_SIZE) != 0) {
+		perror("posix_memalign");
+		return false;
+	}
+
+	memset(header, 0, TRACE_HEADER_SIZE);
+	memcpy(header->magic, TRACE_MAGIC, sizeof(header->magic));
+	header->version = TRACE_VERSION;
+	header->cubeSize = CUBE_SIZE;
+	header->recordSize = sizeof(struct Trace_Record);
+	header->records = records;
+
+	bool written = pwrite(trace->file, header, TRACE_HEADER_SIZE, 0) == TRACE_HEADER_SIZE;
+	if (!written) {
+		perror("trace");
+	}
+
+	free(header);
+	return written;
+}
+
+/* Finishes trace once every writer has finished its batch, stopping its writer thread and cutting the file down to the */
+/* records handed out, returns the number of records in the file */
+uint64_t Trace_Close(struct Trace* trace) {
+	pthread_mutex_lock(&trace->lock);
+	trace->closing = true;
+	pthread_cond_broadcast(&trace->changed);
+	pthread_mutex_unlock(&trace->lock);
+	pthread_join(trace->writer, NULL);
+
+	uint64_t count = trace->next;
+	uint64_t room = (trace->allocated - TRACE_HEADER_SIZE) / sizeof(struct Trace_Record);
+
+	if (count > room) {
+		count = room;
+	}
+
+	Trace_WriteHeader(trace, count);
+	if (ftruncate(trace->file, TRACE_HEADER_SIZE + count * sizeof(struct Trace_Record)) != 0) {
+		perror("ftruncate");
+	}
+	close(trace->file);
+	pthread_mutex_destroy(&trace->lock);
+	pthread_cond_destroy(&trace->changed);
+
+	return count;
+}
+
+/* READER FUNCTIONS */
+/* Maps the trace at path to be read, returns false if it cannot or it is not a trace from a build for this CUBE_SIZE */
+bool Trace_Open(struct Trace_Reader* reader, const char* path) {
+	struct stat status;
+	int file = open(path, O_RDONLY);
+
+	if (file < 0 || fstat(file, &status) != 0) {
+		perror(path);
+		if (file >= 0) {
+			close(file);
+		}
+		return false;
+	}
+
+	reader->size = status.st_size;
+	reader->mapping = reader->size >= TRACE_HEADER_SIZE ? mmap(NULL, reader->size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	close(file); // The mapping keeps the file open
+
+	if (reader->mapping == MAP_FAILED) {
+		fprintf(stderr, "%s: not a trace\n", path);
+		return false;
+	}
+
+	const struct Trace_Header* header = (const struct Trace_Header*)reader->mapping;
+	if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 || header->version != TRACE_VERSION || header->cubeSize != CUBE_SIZE ||
+		header->recordSize != sizeof(struct Trace_Record) || header->records > (reader->size - TRACE_HEADER_SIZE) / sizeof(struct Trace_Record)) {
+		fprintf(stderr, "%s: not a trace of version %d for a cube of size %d\n", path, TRACE_VERSION, CUBE_SIZE);
+		munmap((void*)reader->mapping, reader->size);
+		return false;
+	}
+
+	reader->records = (const struct Trace_Record*)(reader->mapping + TRACE_HEADER_SIZE);
+	reader->count = header->records;
+
+	// Traces are read from start to end, so the kernel can read ahead as far as it likes
+	posix_madvise((void*)reader->mapping, reader->size, POSIX_MADV_SEQUENTIAL);
+
+	return true;
+}
+
+/* Gets the record after record in the file (the first if record is NULL) which was written, NULL at the end */
+/* The record is where it is in the mapping, so it stays valid until Trace_CloseReader */
+const struct Trace_Record* Trace_Next(const struct Trace_Reader* reader, const struct Trace_Record* record) {
+	const struct Trace_Record* end = reader->records + reader->count;
+
+	record = record == NULL ? reader->records : record + 1;
+	while (record < end && !record->used) {
+		record++;
+	}
+
+	return record < end ? record : NULL;
+}
+
+/* Unmaps the trace, after which none of its records can be used */
+void Trace_CloseReader(struct Trace_Reader* reader) {
+	munmap((void*)reader->mapping, reader->size);
+}
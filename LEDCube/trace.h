@@ -0,0 +1,172 @@
+/* Trace of every tick of games played off-target (see sim.c), kept for analysis and visualisation afterwards */
+/* A trace is TRACE_HEADER_SIZE bytes (TRACE_MAGIC, TRACE_VERSION, CUBE_SIZE and the size of a record as 4 byte words,
+ * then the number of records as an 8 byte word, in the byte order of the PC which wrote it) followed by that many
+ * struct Trace_Record, one for each tick of each game, holding the cube after the tick. Records are laid out in the
+ * file exactly as in memory, so the file is written straight from memory and read through a memory mapping with
+ * nothing copied or converted on the way.
+ *
+ * Writers take TRACE_BATCH records at a time from the trace with one atomic add, so any number of threads can write
+ * to one trace. The ticks of a game are in order, but the games of a trace are interleaved, so a game is picked out
+ * by its seed (and sweep, when one run played several configurations). Records at the end of a batch which were never
+ * used are zeros, and skipped by Trace_Next.
+ *
+ * Each writer fills a batch in a buffer of its own, and hands it to a writer thread of the trace once it is full,
+ * going on with a second buffer whilst the first is written, so a record costs no system call or lock. The writer
+ * thread writes the batch where it goes in the file with O_DIRECT, which moves it from the buffer to the disk without
+ * going through the page cache. Taking on the pages of the page cache (or of a shared mapping of the file) made a
+ * greedy run 30 to 45% slower, on whichever core it happened, against 4 to 15% now, which is mostly the stores of
+ * the records themselves, so Trace_Add is inline and stores a record past the cache where it can (see TRACE_STREAM).
+ * The file grows by TRACE_GROW_SIZE, allocated on disk up front, as batches reach its end, and is cut down to the
+ * records which were handed out when the trace is closed */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "game.h" // Needed for the snakes, results and maps of a game
+
+/* DEFINING MACROS */
+#define TRACE_MAGIC "LCT"
+#define TRACE_VERSION 2
+#define TRACE_BLOCK 4096 // What O_DIRECT needs the place in the file, the size and the address of a write lined up to
+#define TRACE_HEADER_SIZE TRACE_BLOCK // Starts every batch on a block, as a batch is a whole number of blocks
+#define TRACE_BATCH 24576 // Records a writer takes at a time, nearly 2 MB on an 8x8x8 cube, as a few big writes cost far less than many small ones
+#define TRACE_BUFFERS 2 // Buffers of a writer, one filled in whilst the other is written
+#define TRACE_HUGE_PAGE ((size_t)2 << 20) // Buffers are lined up to huge pages, for fewer TLB misses in filling them
+#define TRACE_MAX_RUN 64 // Most batches the writer thread writes at once
+#define TRACE_GROW_SIZE ((size_t)64 << 20) // Bytes the file grows by when a batch goes past its end
+#define TRACE_MAX_SIZE ((size_t)1 << 38) // Largest a trace grows to
+#define TRACE_MAX_RECORDS ((TRACE_MAX_SIZE - TRACE_HEADER_SIZE) / sizeof(struct Trace_Record))
+#define TRACE_MAX_SWEEPS (UINT8_MAX + 1) // Configurations of a run a trace can tell apart, as a record keeps its sweep in a byte
+
+/* Whether records are written with SSE2 stores which skip the cache, 16 bytes at a time */
+/* Needs every record to be whole 16 byte words, the map coming after the 16 bytes before it */
+#ifndef TRACE_STREAM
+#if defined(__SSE2__) && CUBE_MAP_SIZE % 16 == 0
+#define TRACE_STREAM 1
+#else
+#define TRACE_STREAM 0
+#endif
+#endif
+
+/* STRUCTS AND ENUMS */
+/* Start of a trace, padded out to TRACE_HEADER_SIZE */
+struct Trace_Header {
+	char magic[3];
+	uint8_t version;
+	uint32_t cubeSize;
+	uint32_t recordSize;
+	uint64_t records;
+};
+
+/* One tick of one game, as it is in the file */
+struct Trace_Record {
+	uint32_t seed; // Seed the game was started with
+	uint32_t tick; // Ticks of the game before this one
+	uint8_t sweep; // Which of the configurations of the run played the game, in the order ledCubeSim plays them
+	uint8_t directionChange; // enum DirectionChange the snake was steered with
+	uint8_t direction; // enum Direction the snake went in
+	uint8_t result; // enum GameResult of the tick
+	uint8_t head[3]; // x, y and z of the head after the tick
+	uint8_t used; // 1, as a record which was never written is all zeros
+	Cube_Column map[CUBE_COLUMNS]; // The cube after the tick, laid out as Cube.map is
+};
+
+/* Batch of records filled in by one writer, and written to the file by the writer thread of the trace */
+struct Trace_Buffer {
+	struct Trace_Record* records; // TRACE_BATCH of them, starting on a block
+	uint64_t first; // Place in the trace of records[0]
+	bool writing; // Between being handed to the writer thread and written, changed under the lock of the trace
+	struct Trace_Buffer* next; // Buffer after this one waiting to be written, which goes further on in the file
+};
+
+/* A trace being written, shared by every writer */
+struct Trace {
+	int file;
+	size_t allocated; // Bytes of the file, only used by the writer thread until it stops
+	uint64_t next; // First record not handed out yet, only ever changed atomically
+	uint64_t dropped; // Records which did not fit, in TRACE_MAX_SIZE or on the disk, only ever changed atomically
+	pthread_t writer;
+	pthread_mutex_t lock; // Guards the rest
+	pthread_cond_t changed; // Signalled when a buffer is queued or written, or the trace is closing
+	struct Trace_Buffer* queue; // Buffers waiting to be written, in the order they go in the file
+	bool closing;
+};
+
+/* Records taken from a trace by one writer, which fills them in without touching the trace */
+struct Trace_Batch {
+	struct Trace* trace;
+	struct Trace_Record* records; // Records of all of buffers
+	struct Trace_Buffer buffers[TRACE_BUFFERS]; // One filled in, whilst the others may be being written
+	int filling; // Which of buffers next and end are in
+	struct Trace_Record* next;
+	struct Trace_Record* end;
+};
+
+/* A trace being read, mapped as a whole */
+struct Trace_Reader {
+	const uint8_t* mapping;
+	size_t size;
+	const struct Trace_Record* records;
+	uint64_t count; // Records in the file, used or not
+};
+
+/* FUNCTION DECLARATIONS */
+bool Trace_Create(struct Trace* trace, const char* path);
+bool Trace_StartBatch(struct Trace_Batch* batch, struct Trace* trace);
+struct Trace_Record* Trace_Append(struct Trace_Batch* batch);
+void Trace_Submit(struct Trace_Batch* batch);
+void Trace_FinishBatch(struct Trace_Batch* batch);
+void* Trace_Writer(void* argument);
+void Trace_Write(struct Trace* trace, struct Trace_Buffer* const* run, int count);
+bool Trace_Grow(struct Trace* trace, size_t size);
+bool Trace_WriteHeader(struct Trace* trace, uint64_t records);
+uint64_t Trace_Close(struct Trace* trace);
+bool Trace_Open(struct Trace_Reader* reader, const char* path);
+const struct Trace_Record* Trace_Next(const struct Trace_Reader* reader, const struct Trace_Record* record);
+void Trace_CloseReader(struct Trace_Reader* reader);
+
+/* Adds a tick of a game to batch, made with directionChange and leaving snake where it is and the cube showing map */
+static inline void Trace_Add(struct Trace_Batch* batch, uint32_t seed, uint32_t tick, int sweep, enum DirectionChange directionChange, const struct Snake* snake, const Cube_Column* map) {
+	struct Trace_Record* record = batch->next != batch->end ? batch->next++ : Trace_Append(batch);
+	if (record == NULL) {
+		return;
+	}
+
+	uint16_t head = snake->body[snake->head];
+
+#if TRACE_STREAM
+	// The first 16 bytes are put together in a register, as storing the fields one by one and loading them back as a
+	// whole would wait for the stores, SSE2 being little endian as the fields are laid out
+	uint64_t low = seed | (uint64_t)tick << 32;
+	uint64_t high = (uint64_t)(uint8_t)sweep | (uint64_t)directionChange << 8 | (uint64_t)snake->direction << 16 | (uint64_t)snake->result << 24 |
+		(uint64_t)CELL_X(head) << 32 | (uint64_t)CELL_Y(head) << 40 | (uint64_t)CELL_Z(head) << 48 | (uint64_t)1 << 56;
+
+	_mm_stream_si128((__m128i*)record, _mm_set_epi64x((long long)high, (long long)low));
+	for (int i = 0; i < CUBE_MAP_SIZE; i += 16) {
+		_mm_stream_si128((__m128i*)((uint8_t*)record->map + i), _mm_loadu_si128((const __m128i*)((const uint8_t*)map + i)));
+	}
+#else
+	record->seed = seed;
+	record->tick = tick;
+	record->sweep = sweep;
+	record->directionChange = directionChange;
+	record->direction = snake->direction;
+	record->result = snake->result;
+	record->head[0] = CELL_X(head);
+	record->head[1] = CELL_Y(head);
+	record->head[2] = CELL_Z(head);
+	record->used = 1;
+	memcpy(record->map, map, CUBE_MAP_SIZE);
+#endif
+}
+
+#endif
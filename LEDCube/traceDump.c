@@ -0,0 +1,184 @@
+/* Host tool reading a trace written by ledCubeSim -o, see trace.h */
+/* Usage: traceDump TRACE                               report what is in TRACE, and how fast it was read
+ *        traceDump -g SEED [-w SWEEP] [-p] [-m MAPS] TRACE
+ *                                                      print every tick of the game started with SEED (in
+ *                                                      configuration SWEEP of the run, 0), -p with the cube after it,
+ *                                                      and write its maps to MAPS (for ledCubeStream -f or animEncode) */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FUNCTION DECLARATIONS */
+int Dump_Summary(const struct Trace_Reader* reader);
+int Dump_Game(const struct Trace_Reader* reader, uint32_t seed, int sweep, bool print, const char* mapsPath);
+void Dump_PrintMap(const Cube_Column* map);
+const char* Dump_Name(const char* const* names, int count, int value);
+double Dump_Seconds(void);
+
+/* GLOBAL VARIABLES */
+/* Names of the results of a game, in the order of enum GameResult */
+const char* const Dump_resultNames[] = { "playing", "won", "hit wall", "hit itself" };
+/* Names of the direction changes, in the order of enum DirectionChange */
+const char* const Dump_changeNames[] = { "right", "left", "up", "down", "centre" };
+/* Names of the directions, in the order of enum Direction */
+const char* const Dump_directionNames[] = { "+x", "-x", "+y", "-y", "+z", "-z" };
+
+/* DUMP FUNCTIONS */
+/* Reports the games of the trace, reading every byte of every record where it is in the mapping */
+int Dump_Summary(const struct Trace_Reader* reader) {
+	long records = 0;
+	long games = 0;
+	long endings[4] = {0};
+	long changes[5] = {0};
+	uint64_t lit = 0;
+	double start = Dump_Seconds();
+
+	for (const struct Trace_Record* record = Trace_Next(reader, NULL); record != NULL; record = Trace_Next(reader, record)) {
+		records++;
+		games += record->tick == 0;
+		if (record->result < 4) {
+			endings[record->result]++;
+		}
+		if (record->directionChange < 5) {
+			changes[record->directionChange]++;
+		}
+
+		// Counting the LEDs which are on touches the whole of the map, as anything analysing it would
+		const uint8_t* bytes = (const uint8_t*)record->map;
+		for (int i = 0; i < CUBE_MAP_SIZE; i++) {
+			lit += __builtin_popcount(bytes[i]);
+		}
+	}
+
+	double seconds = Dump_Seconds() - start;
+
+	printf("%ld ticks of %ld games in %llu records (%llu bytes)\n", records, games, (unsigned long long)reader->count, (unsigned long long)reader->size);
+	printf("read in %.3f s (%.0f ticks/s, %.0f MB/s)\n", seconds, records / seconds, reader->size / seconds / 1e6);
+	if (records == 0) {
+		return EXIT_SUCCESS;
+	}
+
+	printf("mean %.1f LEDs on\n", (double)lit / records);
+	for (int i = 0; i < 5; i++) {
+		printf("%-10s %10ld ticks (%.1f%%)\n", Dump_changeNames[i], changes[i], 100.0 * changes[i] / records);
+	}
+	for (int i = 1; i < 4; i++) {
+		printf("%-10s %10ld games\n", Dump_resultNames[i], endings[i]);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* Prints every tick of one game, and writes its maps to mapsPath unless it is NULL */
+int Dump_Game(const struct Trace_Reader* reader, uint32_t seed, int sweep, bool print, const char* mapsPath) {
+	FILE* maps = NULL;
+	long ticks = 0;
+
+	if (mapsPath != NULL && (maps = fopen(mapsPath, "wb")) == NULL) {
+		perror(mapsPath);
+		return EXIT_FAILURE;
+	}
+
+	for (const struct Trace_Record* record = Trace_Next(reader, NULL); record != NULL; record = Trace_Next(reader, record)) {
+		if (record->seed != seed || record->sweep != sweep) {
+			continue;
+		}
+
+		printf("tick %lu: %s, going %s, head at (%d, %d, %d), %s\n", (unsigned long)record->tick,
+			Dump_Name(Dump_changeNames, 5, record->directionChange), Dump_Name(Dump_directionNames, 6, record->direction),
+			record->head[0], record->head[1], record->head[2], Dump_Name(Dump_resultNames, 4, record->result));
+		if (print) {
+			Dump_PrintMap(record->map);
+		}
+		if (maps != NULL) {
+			fwrite(record->map, CUBE_MAP_SIZE, 1, maps);
+		}
+		ticks++;
+	}
+
+	if (maps != NULL) {
+		fclose(maps);
+	}
+	if (ticks == 0) {
+		fprintf(stderr, "no game with seed %lu in sweep %d\n", (unsigned long)seed, sweep);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* Prints map as its z layers side by side, with y going down the page and x across */
+void Dump_PrintMap(const Cube_Column* map) {
+	for (int y = CUBE_SIZE - 1; y >= 0; y--) {
+		for (int z = 0; z < CUBE_SIZE; z++) {
+			for (int x = 0; x < CUBE_SIZE; x++) {
+				putchar(map[CUBE_COLUMN_INDEX(x, y)] & 1 << z ? '#' : '.');
+			}
+			putchar(z < CUBE_SIZE - 1 ? ' ' : '\n');
+		}
+	}
+}
+
+/* Gets the name of value from names, which has count of them */
+const char* Dump_Name(const char* const* names, int count, int value) {
+	return value >= 0 && value < count ? names[value] : "unknown";
+}
+
+/* Gets a monotonic time in seconds */
+double Dump_Seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	struct Trace_Reader reader;
+	bool game = false;
+	uint32_t seed = 0;
+	int sweep = 0;
+	bool print = false;
+	const char* mapsPath = NULL;
+	int option;
+
+	while ((option = getopt(argc, argv, "g:w:pm:")) != -1) {
+		switch (option) {
+			case 'g':
+				game = true;
+				seed = strtoul(optarg, NULL, 0);
+				break;
+			case 'w':
+				sweep = strtol(optarg, NULL, 0);
+				break;
+			case 'p':
+				print = true;
+				break;
+			case 'm':
+				mapsPath = optarg;
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if (optind != argc - 1) {
+		fprintf(stderr, "usage: %s [-g SEED [-w SWEEP] [-p] [-m MAPS]] TRACE\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!Trace_Open(&reader, argv[optind])) {
+		return EXIT_FAILURE;
+	}
+
+	int status = game ? Dump_Game(&reader, seed, sweep, print, mapsPath) : Dump_Summary(&reader);
+
+	Trace_CloseReader(&reader);
+	return status;
+}
@@ -0,0 +1,176 @@
+/* Host check that the turn and step tables of game.c do what the (x, y, z) vector Snake_TurnDirection they replaced did */
+/* Usage: turnCheck [-n TURNS] [-s SEED]
+ *        tries every direction change from every direction, then TURNS (100000) random direction changes one after
+ *        another from seed SEED (1), turning a snake with Snake_Turn and a vector with the old code side by side. Prints
+ *        every entry which differs and fails, otherwise prints the table */
+
+/* INCLUDING NECESSARY LIBRARIES */
+#include "game.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+/* FUNCTION DECLARATIONS */
+void Check_VectorTurn(int direction[3], enum DirectionChange directionChange);
+bool Check_Same(enum Direction direction, const int vector[3]);
+void Check_Vector(enum Direction direction, int vector[3]);
+
+/* GLOBAL VARIABLES */
+/* Names of the directions and direction changes, in the order of their enums */
+const char* const Check_directionNames[DIRECTIONS] = { "+x", "-x", "+y", "-y", "+z", "-z" };
+const char* const Check_changeNames[CENTRE + 1] = { "RIGHT", "LEFT", "UP", "DOWN", "CENTRE" };
+
+/* CHECK FUNCTIONS */
+/* Snake_TurnDirection as it was before the tables, unchanged */
+void Check_VectorTurn(int direction[3], enum DirectionChange directionChange) {
+	switch (directionChange) {
+		case LEFT:
+			// If snake was going inwards or outwards, set direction to absolute left
+			if (direction[2] == 1 || direction[2] == -1) {
+				direction[0] = 0;
+				direction[1] = -1;
+				direction[2] = 0;
+			// Otherwise turn left relative to current direction
+			} else {
+				direction[2] = direction[0];
+				direction[0] = direction[1];
+				direction[1] = -direction[2];
+
+				direction[2] = 0;
+			}
+
+			break;
+		case RIGHT:
+			// If snake was going inwards or outwards, set direction to absolute right
+			if (direction[2] == 1 || direction[2] == -1) {
+				direction[0] = 0;
+				direction[1] = 1;
+				direction[2] = 0;
+			// Otherwise turn right relative to current direction
+			} else {
+				direction[2] = direction[0];
+				direction[0] = -direction[1];
+				direction[1] = direction[2];
+
+				direction[2] = 0;
+			}
+
+			break;
+		case UP:
+			// If snake is not currently going inwards, set the direction to inwards
+			if (!(direction[2] == -1)) {
+				direction[0] = 0;
+				direction[1] = 0;
+				direction[2] = 1;
+			}
+
+			break;
+		case DOWN:
+			// If snake is not currently going outwards, set the direction to outwards
+			if (!(direction[2] == 1)) {
+				direction[0] = 0;
+				direction[1] = 0;
+				direction[2] = -1;
+			}
+
+			break;
+		case CENTRE:
+			// Don't change direction
+			break;
+	}
+}
+
+/* Whether the step of direction is the vector */
+bool Check_Same(enum Direction direction, const int vector[3]) {
+	const int8_t* step = Snake_StepOf(direction);
+	return step[0] == vector[0] && step[1] == vector[1] && step[2] == vector[2];
+}
+
+/* Gets the vector of a direction the long way, so a wrong step table cannot hide a wrong turn table */
+void Check_Vector(enum Direction direction, int vector[3]) {
+	vector[0] = direction == DIRECTION_PLUS_X ? 1 : direction == DIRECTION_MINUS_X ? -1 : 0;
+	vector[1] = direction == DIRECTION_PLUS_Y ? 1 : direction == DIRECTION_MINUS_Y ? -1 : 0;
+	vector[2] = direction == DIRECTION_PLUS_Z ? 1 : direction == DIRECTION_MINUS_Z ? -1 : 0;
+}
+
+int main(int argc, char** argv) {
+	long turns = 100000;
+	uint32_t seed = 1;
+	int failures = 0;
+	int option;
+
+	while ((option = getopt(argc, argv, "n:s:")) != -1) {
+		switch (option) {
+			case 'n':
+				turns = strtol(optarg, NULL, 0);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-n TURNS] [-s SEED]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+
+	// Every entry of both tables
+	printf("from  RIGHT LEFT  UP    DOWN  CENTRE\n");
+	for (int direction = 0; direction < DIRECTIONS; direction++) {
+		int vector[3];
+
+		Check_Vector(direction, vector);
+		if (!Check_Same(direction, vector)) {
+			printf("step of %s is wrong\n", Check_directionNames[direction]);
+			failures++;
+		}
+
+		printf("%-5s", Check_directionNames[direction]);
+		for (int change = RIGHT; change <= CENTRE; change++) {
+			int turned[3];
+			enum Direction next = Snake_TurnDirection(direction, change);
+
+			Check_Vector(direction, turned);
+			Check_VectorTurn(turned, change);
+
+			printf(" %-5s", Check_directionNames[next]);
+			if (!Check_Same(next, turned)) {
+				printf("\n%s then %s goes (%d, %d, %d), not %s\n", Check_directionNames[direction], Check_changeNames[change],
+					turned[0], turned[1], turned[2], Check_directionNames[next]);
+				failures++;
+			}
+		}
+		printf("\n");
+	}
+
+	// Long runs of turns of a snake, so its direction is only ever what earlier turns left it at
+	struct Snake snake;
+	struct Random random;
+	int vector[3] = { 1, 0, 0 };
+
+	snake.direction = DIRECTION_PLUS_X;
+	Random_Seed(&random, seed);
+
+	for (long i = 0; i < turns && failures == 0; i++) {
+		enum DirectionChange change = Random_Below(&random, CENTRE + 1);
+
+		Snake_Turn(&snake, change);
+		Check_VectorTurn(vector, change);
+
+		if (!Check_Same(snake.direction, vector)) {
+			printf("turn %ld (%s) went %s, not (%d, %d, %d)\n", i + 1, Check_changeNames[change],
+				Check_directionNames[snake.direction], vector[0], vector[1], vector[2]);
+			failures++;
+		}
+	}
+
+	if (failures > 0) {
+		printf("FAILED: %d differences\n", failures);
+		return EXIT_FAILURE;
+	}
+
+	printf("OK: every turn and step the same as the vector code, and %ld random turns in a row\n", turns);
+	return EXIT_SUCCESS;
+}
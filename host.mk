@@ -0,0 +1,63 @@
+# Native build of the game logic for the machine running make, so it can be
+# profiled and load tested without an STM32F303 board. Counterpart of rules.mk,
+# expects the following to be defined before inclusion..
+### REQUIRED ###
+# HOST_PROGRAMS - basenames of the executables to build, eg ledCube-host
+# <program>_CFILES - basenames of the C files making up each program
+### OPTIONAL ###
+# HOST_BUILD_DIR - defaults to bin-host
+# HOST_OPT - full -O flag, defaults to -O2
+# HOST_LDLIBS - extra libraries every program is linked with
+# <program>_LDFLAGS - extra flags for linking one program
+# <file>_CPPFLAGS - extra flags for compiling <file>.c, eg include paths only it needs
+# HOST_BENCHMARKS - programs run by 'make host-bench', each writing its output to <program>.csv
+
+HOST_BUILD_DIR ?= bin-host
+HOST_OPT ?= -O2
+CSTD ?= -std=c99
+
+V?=0
+ifeq ($(V),0)
+Q	:= @
+endif
+
+# Tool paths.
+HOST_CC ?= gcc
+
+HOST_CPPFLAGS += -MD -D_POSIX_C_SOURCE=200809L
+HOST_CPPFLAGS += -Wall -Wundef $(INCLUDES)
+
+HOST_CFLAGS += $(HOST_OPT) $(CSTD) -ggdb3
+HOST_CFLAGS += -fno-common
+HOST_CFLAGS += -Wextra -Wshadow -Wno-unused-variable -Wimplicit-function-declaration
+HOST_CFLAGS += -Wredundant-decls -Wstrict-prototypes -Wmissing-prototypes
+
+HOST_OBJS = $(sort $(foreach p,$(HOST_PROGRAMS),$($(p)_CFILES:%.c=$(HOST_BUILD_DIR)/%.o)))
+HOST_BINS = $(HOST_PROGRAMS:%=$(HOST_BUILD_DIR)/%)
+
+host: $(HOST_BINS)
+
+$(HOST_BUILD_DIR)/%.o: %.c
+	@printf "  HOSTCC\t$<\n"
+	@mkdir -p $(dir $@)
+	$(Q)$(HOST_CC) $(HOST_CFLAGS) $(CFLAGS) $(HOST_CPPFLAGS) $($*_CPPFLAGS) $(CPPFLAGS) -o $@ -c $<
+
+# One link rule per program as each has its own list of objects
+define HOST_PROGRAM_RULE
+$(HOST_BUILD_DIR)/$(1): $$($(1)_CFILES:%.c=$(HOST_BUILD_DIR)/%.o)
+	@printf "  HOSTLD\t$$@\n"
+	$$(Q)$$(HOST_CC) $$(HOST_CFLAGS) $$(LDFLAGS) $$($(1)_LDFLAGS) $$^ $$(HOST_LDLIBS) -o $$@
+endef
+$(foreach p,$(HOST_PROGRAMS),$(eval $(call HOST_PROGRAM_RULE,$(p))))
+
+host-bench: $(HOST_BENCHMARKS:%=$(HOST_BUILD_DIR)/%)
+	$(Q)for b in $(HOST_BENCHMARKS); do \
+		printf "  BENCH\t$$b\n"; \
+		./$(HOST_BUILD_DIR)/$$b > $(HOST_BUILD_DIR)/$$b.csv || exit 1; \
+	done
+
+host-clean:
+	rm -rf $(HOST_BUILD_DIR)
+
+.PHONY: host host-bench host-clean
+-include $(HOST_OBJS:.o=.d)